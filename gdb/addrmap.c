@@ -21,6 +21,9 @@
 #include "gdbsupport/gdb_obstack.h"
 #include "addrmap.h"
 #include "gdbsupport/selftest.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 /* Make sure splay trees can actually hold the values we want to
    store in them.  */
@@ -39,44 +42,74 @@ addrmap_fixed::set_empty (CORE_ADDR start, CORE_ADDR end_inclusive,
 }
 
 
-void *
-addrmap_fixed::do_find (CORE_ADDR addr) const
+/* Return the index of the first node of an Eytzinger-ordered tree
+   with N nodes, in order of increasing address; or 0 if the tree is
+   empty.  */
+
+static size_t
+eytzinger_first (size_t n)
 {
-  const struct addrmap_transition *bottom = &transitions[0];
-  const struct addrmap_transition *top = &transitions[num_transitions - 1];
+  if (n == 0)
+    return 0;
 
-  while (bottom < top)
-    {
-      /* This needs to round towards top, or else when top = bottom +
-	 1 (i.e., two entries are under consideration), then mid ==
-	 bottom, and then we may not narrow the range when (mid->addr
-	 < addr).  */
-      const addrmap_transition *mid = top - (top - bottom) / 2;
+  size_t k = 1;
+  while (2 * k <= n)
+    k = 2 * k;
+  return k;
+}
 
-      if (mid->addr == addr)
-	{
-	  bottom = mid;
-	  break;
-	}
-      else if (mid->addr < addr)
-	/* We don't eliminate mid itself here, since each transition
-	   covers all subsequent addresses until the next.  This is why
-	   we must round up in computing the midpoint.  */
-	bottom = mid;
-      else
-	top = mid - 1;
+/* Return the index of the node following node K of an
+   Eytzinger-ordered tree with N nodes, in order of increasing address;
+   or 0 if K is the last node.  */
+
+static size_t
+eytzinger_next (size_t k, size_t n)
+{
+  if (2 * k + 1 <= n)
+    {
+      /* The leftmost node of the right subtree.  */
+      k = 2 * k + 1;
+      while (2 * k <= n)
+	k = 2 * k;
+      return k;
     }
 
-  return bottom->value;
+  /* Go up until we leave a left subtree.  Reaching the root from the
+     right yields 0.  */
+  while ((k & 1) != 0)
+    k >>= 1;
+  return k >> 1;
+}
+
+
+void *
+addrmap_fixed::do_find (CORE_ADDR addr) const
+{
+  /* Descend the tree, going right whenever the node's address is
+     below or at ADDR.  Each step only depends on a comparison, which
+     the compiler can turn into a conditional move.  */
+  size_t k = 1;
+  while (k <= num_transitions)
+    k = 2 * k + (transitions[k].addr <= addr);
+
+  /* The bits of K now record the path taken, one bit per level.  The
+     transition we want is the last node where we went right, so strip
+     the trailing left turns, and then the right turn itself.  If we
+     never went right, this yields 0, the sentinel.  */
+  while ((k & 1) == 0)
+    k >>= 1;
+  k >>= 1;
+
+  return transitions[k].value;
 }
 
 
 void
 addrmap_fixed::relocate (CORE_ADDR offset)
 {
-  size_t i;
-
-  for (i = 0; i < num_transitions; i++)
+  /* Relocating every transition by the same amount doesn't change
+     their order, so the tree stays valid.  */
+  for (size_t i = 1; i <= num_transitions; i++)
     transitions[i].addr += offset;
 }
 
@@ -84,11 +117,11 @@ addrmap_fixed::relocate (CORE_ADDR offset)
 int
 addrmap_fixed::do_foreach (addrmap_foreach_fn fn) const
 {
-  size_t i;
-
-  for (i = 0; i < num_transitions; i++)
+  for (size_t k = eytzinger_first (num_transitions);
+       k != 0;
+       k = eytzinger_next (k, num_transitions))
     {
-      int res = fn (transitions[i].addr, transitions[i].value);
+      int res = fn (transitions[k].addr, transitions[k].value);
 
       if (res != 0)
 	return res;
@@ -98,7 +131,42 @@ addrmap_fixed::do_foreach (addrmap_foreach_fn fn) const
 }
 
 
-
+void
+addrmap_fixed::fill (struct obstack *obstack,
+		     gdb::function_view<void (transition_fn)> walk)
+{
+  size_t transition_count = 0;
+
+  /* Count the number of transitions.  */
+  walk ([&] (CORE_ADDR addr, void *value)
+    {
+      ++transition_count;
+    });
+
+  /* The extra element is the sentinel at index 0.  */
+  num_transitions = transition_count;
+  transitions = XOBNEWVEC (obstack, struct addrmap_transition,
+			   transition_count + 1);
+  transitions[0].addr = 0;
+  transitions[0].value = nullptr;
+
+  /* Store the transitions, which arrive in order of increasing
+     address, by doing an in-order walk of the tree.  */
+  size_t k = eytzinger_first (transition_count);
+  walk ([&] (CORE_ADDR addr, void *value)
+    {
+      gdb_assert (k != 0);
+      transitions[k].addr = addr;
+      transitions[k].value = value;
+      k = eytzinger_next (k, transition_count);
+    });
+
+  /* We should have filled the array.  */
+  gdb_assert (k == 0);
+}
+
+
+
 /* Mutable address maps.  */
 
 /* Allocate a copy of CORE_ADDR.  */
@@ -260,39 +328,88 @@ addrmap_mutable::do_find (CORE_ADDR addr) const
 }
 
 
-addrmap_fixed::addrmap_fixed (struct obstack *obstack, addrmap_mutable *mut)
+/* Pass the transitions of a fixed map equivalent to MUT to EMIT, in
+   order of increasing address.  */
+
+static void
+walk_mutable_transitions (addrmap_mutable *mut,
+			  gdb::function_view<void (CORE_ADDR, void *)> emit)
 {
-  size_t transition_count = 0;
+  /* Include an extra entry for the transition at zero (which fixed
+     maps have, but mutable maps do not.)  */
+  emit (0, nullptr);
 
-  /* Count the number of transitions in the tree.  */
+  /* Copy all entries from the splay tree, in order of increasing
+     address.  */
   mut->foreach ([&] (CORE_ADDR start, void *obj)
     {
-      ++transition_count;
+      emit (start, obj);
       return 0;
     });
+}
 
-  /* Include an extra entry for the transition at zero (which fixed
-     maps have, but mutable maps do not.)  */
-  transition_count++;
+addrmap_fixed::addrmap_fixed (struct obstack *obstack, addrmap_mutable *mut)
+{
+  fill (obstack, [&] (transition_fn emit)
+    {
+      walk_mutable_transitions (mut, emit);
+    });
+}
 
-  num_transitions = 1;
-  transitions = XOBNEWVEC (obstack, struct addrmap_transition,
-			   transition_count);
-  transitions[0].addr = 0;
-  transitions[0].value = NULL;
 
-  /* Copy all entries from the splay tree to the array, in order 
-     of increasing address.  */
-  mut->foreach ([&] (CORE_ADDR start, void *obj)
+addrmap_fixed::addrmap_fixed (struct obstack *obstack,
+			      gdb::array_view<const addrmap_range> ranges)
+{
+  /* Check whether RANGES can be converted directly.  */
+  bool sorted = true;
+  for (size_t i = 0; i < ranges.size (); ++i)
     {
-      transitions[num_transitions].addr = start;
-      transitions[num_transitions].value = obj;
-      ++num_transitions;
-      return 0;
-    });
+      gdb_assert (ranges[i].value != nullptr);
+      if (ranges[i].start > ranges[i].end_inclusive
+	  || (i > 0 && ranges[i].start <= ranges[i - 1].end_inclusive))
+	{
+	  sorted = false;
+	  break;
+	}
+    }
 
-  /* We should have filled the array.  */
-  gdb_assert (num_transitions == transition_count);
+  if (!sorted)
+    {
+      /* Let the mutable map sort out the overlaps.  */
+      addrmap_mutable mut;
+      for (const addrmap_range &range : ranges)
+	mut.set_empty (range.start, range.end_inclusive, range.value);
+      fill (obstack, [&] (transition_fn emit)
+	{
+	  walk_mutable_transitions (&mut, emit);
+	});
+      return;
+    }
+
+  fill (obstack, [&] (transition_fn emit)
+    {
+      emit (0, nullptr);
+
+      /* Emit the same transitions as a mutable map would have: a
+	 transition at the start of each range, unless it continues
+	 the previous range with the same value, and a transition back
+	 to NULL after each range that isn't immediately followed by
+	 another one.  */
+      for (size_t i = 0; i < ranges.size (); ++i)
+	{
+	  const addrmap_range &range = ranges[i];
+
+	  if (i == 0
+	      || ranges[i - 1].end_inclusive + 1 != range.start
+	      || ranges[i - 1].value != range.value)
+	    emit (range.start, range.value);
+
+	  if (range.end_inclusive != CORE_ADDR_MAX
+	      && (i + 1 == ranges.size ()
+		  || ranges[i + 1].start != range.end_inclusive + 1))
+	    emit (range.end_inclusive + 1, nullptr);
+	}
+    });
 }
 
 
@@ -476,6 +593,168 @@ test_addrmap ()
   CHECK_ADDRMAP_FIND (map, array, 10, 12, val1);
   CHECK_ADDRMAP_FIND (map, array, 13, 13, val2);
   CHECK_ADDRMAP_FIND (map, array, 14, 19, nullptr);
+
+  /* Create fixed addrmaps directly from sorted, and from overlapping
+     ranges.  */
+  const addrmap_range sorted_ranges[] = {
+    { core_addr (&array[2]), core_addr (&array[4]), val1 },
+    { core_addr (&array[5]), core_addr (&array[6]), val1 },
+    { core_addr (&array[7]), core_addr (&array[7]), val2 },
+    { core_addr (&array[10]), core_addr (&array[12]), val1 },
+  };
+  struct addrmap *map3
+    = new (&temp_obstack) addrmap_fixed (&temp_obstack, sorted_ranges);
+  CHECK_ADDRMAP_FIND (map3, array, 0, 1, nullptr);
+  CHECK_ADDRMAP_FIND (map3, array, 2, 6, val1);
+  CHECK_ADDRMAP_FIND (map3, array, 7, 7, val2);
+  CHECK_ADDRMAP_FIND (map3, array, 8, 9, nullptr);
+  CHECK_ADDRMAP_FIND (map3, array, 10, 12, val1);
+  CHECK_ADDRMAP_FIND (map3, array, 13, 19, nullptr);
+
+  /* Adjacent ranges with the same value are merged, as they would be
+     in a mutable map.  */
+  int count = 0;
+  SELF_CHECK (map3->foreach ([&] (CORE_ADDR start_addr, void *obj)
+		{
+		  ++count;
+		  return 0;
+		}) == 0);
+  SELF_CHECK (count == 6);
+
+  const addrmap_range overlapping_ranges[] = {
+    { core_addr (&array[10]), core_addr (&array[12]), val1 },
+    { core_addr (&array[11]), core_addr (&array[13]), val2 },
+  };
+  struct addrmap *map4
+    = new (&temp_obstack) addrmap_fixed (&temp_obstack, overlapping_ranges);
+  CHECK_ADDRMAP_FIND (map4, array, 0, 9, nullptr);
+  CHECK_ADDRMAP_FIND (map4, array, 10, 12, val1);
+  CHECK_ADDRMAP_FIND (map4, array, 13, 13, val2);
+  CHECK_ADDRMAP_FIND (map4, array, 14, 19, nullptr);
+
+  /* An empty list of ranges gives an empty map.  */
+  struct addrmap *map5
+    = new (&temp_obstack) addrmap_fixed (&temp_obstack,
+					 gdb::array_view<const addrmap_range> ());
+  CHECK_ADDRMAP_FIND (map5, array, 0, 19, nullptr);
+}
+
+/* Check lookups in big fixed addrmaps against a plain binary search,
+   for every map size up to a few levels of the search tree, and then
+   for a map with many transitions.  When running verbosely, also
+   report how long the lookups take, to compare with the binary
+   search.  */
+
+static void
+test_addrmap_fixed_lookup ()
+{
+  std::minstd_rand gen (1);
+
+  for (size_t n_ranges : { 0, 1, 2, 3, 4, 5, 6, 7, 8, 15, 16, 17, 100000 })
+    {
+      /* Build sorted, non-overlapping ranges, with gaps between some
+	 of them.  The values are just the range numbers plus one.  */
+      std::vector<addrmap_range> ranges;
+      CORE_ADDR addr = 0x1000;
+      for (size_t i = 0; i < n_ranges; ++i)
+	{
+	  addr += gen () % 2 == 0 ? 0 : 1 + gen () % 64;
+	  CORE_ADDR len = 1 + gen () % 256;
+	  ranges.push_back ({ addr, addr + len - 1,
+			      (void *) (uintptr_t) (i + 1) });
+	  addr += len;
+	}
+
+      /* The reference: the sorted start and end of each range.  */
+      auto reference = [&] (CORE_ADDR a) -> void *
+	{
+	  auto it = std::upper_bound (ranges.begin (), ranges.end (), a,
+				      [] (CORE_ADDR x, const addrmap_range &r)
+				      {
+					return x < r.start;
+				      });
+	  if (it == ranges.begin () || a > (it - 1)->end_inclusive)
+	    return nullptr;
+	  return (it - 1)->value;
+	};
+
+      auto_obstack temp_obstack;
+      addrmap_fixed *direct
+	= new (&temp_obstack) addrmap_fixed (&temp_obstack, ranges);
+
+      addrmap_mutable mut;
+      for (const addrmap_range &r : ranges)
+	mut.set_empty (r.start, r.end_inclusive, r.value);
+      addrmap_fixed *from_mutable
+	= new (&temp_obstack) addrmap_fixed (&temp_obstack, &mut);
+
+      /* Both maps must have the same transitions.  */
+      std::vector<std::pair<CORE_ADDR, void *>> t1, t2;
+      direct->foreach ([&] (CORE_ADDR start, void *obj)
+	{
+	  t1.emplace_back (start, obj);
+	  return 0;
+	});
+      from_mutable->foreach ([&] (CORE_ADDR start, void *obj)
+	{
+	  t2.emplace_back (start, obj);
+	  return 0;
+	});
+      SELF_CHECK (t1 == t2);
+      SELF_CHECK (std::is_sorted (t1.begin (), t1.end ()));
+
+      /* Check the boundaries of every range, and some random
+	 addresses.  */
+      CORE_ADDR limit = addr + 0x100;
+      std::vector<CORE_ADDR> probes = { 0, limit, CORE_ADDR_MAX };
+      for (const addrmap_range &r : ranges)
+	{
+	  probes.push_back (r.start - 1);
+	  probes.push_back (r.start);
+	  probes.push_back (r.end_inclusive);
+	  probes.push_back (r.end_inclusive + 1);
+	}
+      for (size_t i = 0; i < 1000; ++i)
+	probes.push_back (gen () % limit);
+
+      for (CORE_ADDR a : probes)
+	{
+	  SELF_CHECK (direct->find (a) == reference (a));
+	  SELF_CHECK (from_mutable->find (a) == reference (a));
+	}
+
+      if (!run_verbose () || n_ranges < 1000)
+	continue;
+
+      /* Time lookups at random addresses.  */
+      std::vector<CORE_ADDR> lookups;
+      for (size_t i = 0; i < 1000000; ++i)
+	lookups.push_back (gen () % limit);
+
+      using clock = std::chrono::steady_clock;
+      uintptr_t sum = 0;
+
+      clock::time_point start = clock::now ();
+      for (CORE_ADDR a : lookups)
+	sum += (uintptr_t) direct->find (a);
+      clock::duration fixed_time = clock::now () - start;
+
+      start = clock::now ();
+      for (CORE_ADDR a : lookups)
+	sum -= (uintptr_t) reference (a);
+      clock::duration reference_time = clock::now () - start;
+
+      SELF_CHECK (sum == 0);
+
+      using std::chrono::nanoseconds;
+      using std::chrono::duration_cast;
+      debug_printf ("addrmap_fixed: %zu transitions, %zu lookups: "
+		    "%lld ns (binary search: %lld ns)\n",
+		    t1.size (), lookups.size (),
+		    (long long) duration_cast<nanoseconds> (fixed_time).count (),
+		    (long long) duration_cast<nanoseconds>
+		      (reference_time).count ());
+    }
 }
 
 } // namespace selftests
@@ -487,5 +766,7 @@ _initialize_addrmap ()
 {
 #if GDB_SELF_TEST
   selftests::register_test ("addrmap", selftests::test_addrmap);
+  selftests::register_test ("addrmap-fixed-lookup",
+			    selftests::test_addrmap_fixed_lookup);
 #endif /* GDB_SELF_TEST */
 }
@@ -22,6 +22,7 @@
 
 #include "splay-tree.h"
 #include "gdbsupport/function-view.h"
+#include "gdbsupport/array-view.h"
 
 /* An address map is essentially a table mapping CORE_ADDRs onto GDB
    data structures, like blocks, symtabs, partial symtabs, and so on.
@@ -31,8 +32,8 @@
 
    Address maps come in two flavors: fixed, and mutable.  Mutable
    address maps consume more memory, but can be changed and extended.
-   A fixed address map, once constructed (from a mutable address map),
-   can't be edited.  */
+   A fixed address map, once constructed (from a mutable address map,
+   or directly from a list of ranges), can't be edited.  */
 
 /* The type of a function used to iterate over the map.
    OBJ is NULL for unmapped regions.  */
@@ -118,6 +119,16 @@ struct addrmap
 
 struct addrmap_mutable;
 
+/* An address range, mapping START..END_INCLUSIVE to VALUE, used to
+   construct a fixed address map in bulk.  */
+
+struct addrmap_range
+{
+  CORE_ADDR start;
+  CORE_ADDR end_inclusive;
+  void *value;
+};
+
 /* Fixed address maps.  */
 struct addrmap_fixed : public addrmap,
 		       public allocate_on_obstack
@@ -125,6 +136,16 @@ struct addrmap_fixed : public addrmap,
 public:
 
   addrmap_fixed (struct obstack *obstack, addrmap_mutable *mut);
+
+  /* Create a fixed address map from RANGES.  The result is the same
+     as calling set_empty for each element of RANGES, in order, on an
+     empty mutable map, and then creating a fixed map from that.
+     However, when RANGES is sorted by address and the ranges don't
+     overlap -- the common case for address tables read from an index
+     -- the map is built directly, without the mutable map.  */
+  addrmap_fixed (struct obstack *obstack,
+		 gdb::array_view<const addrmap_range> ranges);
+
   DISABLE_COPY_AND_ASSIGN (addrmap_fixed);
 
   void set_empty (CORE_ADDR start, CORE_ADDR end_inclusive,
@@ -144,14 +165,38 @@ struct addrmap_fixed : public addrmap,
     void *value;
   };
 
+  /* A function that is passed each transition of a map, in order of
+     increasing address.  */
+  using transition_fn = gdb::function_view<void (CORE_ADDR, void *)>;
+
+  /* Allocate TRANSITIONS on OBSTACK and fill it in.  WALK is called
+     twice, first to count the transitions and then to store them; it
+     must pass the same transitions, in order of increasing address,
+     to its argument both times.  */
+  void fill (struct obstack *obstack,
+	     gdb::function_view<void (transition_fn)> walk);
+
   /* The number of transitions in TRANSITIONS.  */
   size_t num_transitions;
 
-  /* An array of transitions, sorted by address.  For every point in
-     the map where either ADDR == 0 or ADDR is mapped to one value and
-     ADDR - 1 is mapped to something different, we have an entry here
-     containing ADDR and VALUE.  (Note that this means we always have
-     an entry for address 0).  */
+  /* An array of transitions.  For every point in the map where either
+     ADDR == 0 or ADDR is mapped to one value and ADDR - 1 is mapped to
+     something different, we have an entry here containing ADDR and
+     VALUE.  (Note that this means we always have an entry for address
+     0).
+
+     The entries are not sorted by address, but stored in "Eytzinger"
+     order: the array is an implicit binary search tree, whose root is
+     at index 1 and where the children of the node at index K are at
+     2K and 2K+1.  Compared to a binary search over a sorted array,
+     the nodes visited by the first few steps of a lookup are close
+     together in memory, and so are likely to share cache lines, which
+     makes lookups in big maps considerably faster.
+
+     The array has NUM_TRANSITIONS + 1 elements.  Element 0 is not part
+     of the tree; it maps address 0 to NULL, and is what a lookup
+     returns when ADDR is below every transition (which can only happen
+     after the map has been relocated).  */
   struct addrmap_transition *transitions;
 };
 
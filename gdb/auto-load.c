@@ -42,6 +42,7 @@
 #include <algorithm>
 #include "gdbsupport/pathstuff.h"
 #include "cli/cli-style.h"
+#include "trace-events.h"
 
 /* The section to look in for auto-loaded scripts (in file formats that
    support sections).
@@ -1157,6 +1158,9 @@ load_auto_scripts_for_objfile (struct objfile *objfile)
       || is_target_filename (objfile->original_name))
     return;
 
+  scoped_trace_event trace ("auto-load", "load scripts",
+			    objfile_name (objfile));
+
   /* Load any extension language scripts for this objfile.
      E.g., foo-gdb.gdb, foo-gdb.py.  */
   auto_load_ext_lang_scripts_for_objfile (objfile);
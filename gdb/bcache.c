@@ -39,11 +39,13 @@ struct bstring
   struct bstring *next;
   /* Assume the data length is no more than 64k.  */
   unsigned short length;
-  /* The half hash hack.  This contains the upper 16 bits of the hash
-     value and is used as a pre-check when comparing two strings and
-     avoids the need to do length or memcmp calls.  It proves to be
-     roughly 100% effective.  */
-  unsigned short half_hash;
+  /* The string's hash value.  This is used as a pre-check when
+     comparing two strings, which avoids the need to do length or
+     memcmp calls (see "the half hash hack" in bcache.h), and lets the
+     hash table be expanded without hashing every string again.  On
+     hosts with 64-bit pointers, it fits in what would otherwise be
+     padding before D.  */
+  unsigned int hash;
 
   union
   {
@@ -64,12 +66,15 @@ void
 bcache::expand_hash_table ()
 {
   /* A table of good hash table sizes.  Whenever we grow, we pick the
-     next larger size from this table.  sizes[i] is close to 1 << (i+10),
-     so we roughly double the table size each time.  After we fall off 
+     next larger size from this table.  sizes[i] is close to 1 << (i+7),
+     so we roughly double the table size each time.  The small sizes at
+     the start are cheap to grow out of, since the strings' hash values
+     are stored, and keep mostly-empty caches (like the shards of a
+     concurrent_bcache) small.  After we fall off 
      the end of this table, we just double.  Don't laugh --- there have
      been executables sighted with a gigabyte of debug info.  */
   static const unsigned long sizes[] = {
-    1021, 2053, 4099, 8191, 16381, 32771,
+    127, 251, 509, 1021, 2053, 4099, 8191, 16381, 32771,
     65537, 131071, 262144, 524287, 1048573, 2097143,
     4194301, 8388617, 16777213, 33554467, 67108859, 134217757,
     268435459, 536870923, 1073741827, 2147483659UL
@@ -78,10 +83,8 @@ bcache::expand_hash_table ()
   struct bstring **new_buckets;
   unsigned int i;
 
-  /* Count the stats.  Every unique item needs to be re-hashed and
-     re-entered.  */
+  /* Count the stats.  Every unique item needs to be re-entered.  */
   m_expand_count++;
-  m_expand_hash_count += m_unique_count;
 
   /* Find the next size.  */
   new_num_buckets = m_num_buckets * 2;
@@ -113,8 +116,7 @@ bcache::expand_hash_table ()
 	  struct bstring **new_bucket;
 	  next = s->next;
 
-	  new_bucket = &new_buckets[(this->hash (&s->d.data, s->length)
-				     % new_num_buckets)];
+	  new_bucket = &new_buckets[s->hash % new_num_buckets];
 	  s->next = *new_bucket;
 	  *new_bucket = s;
 	}
@@ -142,8 +144,16 @@ bcache::expand_hash_table ()
 const void *
 bcache::insert (const void *addr, int length, bool *added)
 {
-  unsigned long full_hash;
-  unsigned short half_hash;
+  return insert (addr, length, this->hash (addr, length), added);
+}
+
+/* Like the above, but FULL_HASH is the hash of the LENGTH bytes at
+   ADDR, as computed by the hash method.  */
+
+const void *
+bcache::insert (const void *addr, int length, unsigned int full_hash,
+		bool *added)
+{
   int hash_index;
   struct bstring *s;
 
@@ -167,23 +177,19 @@ bcache::insert (const void *addr, int length, bool *added)
   m_total_count++;
   m_total_size += length;
 
-  full_hash = this->hash (addr, length);
-
-  half_hash = (full_hash >> 16);
   hash_index = full_hash % m_num_buckets;
 
   /* Search the hash m_bucket for a string identical to the caller's.
-     As a short-circuit first compare the upper part of each hash
-     values.  */
+     As a short-circuit first compare the hash values.  */
   for (s = m_bucket[hash_index]; s; s = s->next)
     {
-      if (s->half_hash == half_hash)
+      if (s->hash == full_hash)
 	{
 	  if (s->length == length
 	      && this->compare (&s->d.data, addr, length))
 	    return &s->d.data;
 	  else
-	    m_half_hash_miss_count++;
+	    m_hash_miss_count++;
 	}
     }
 
@@ -196,7 +202,7 @@ bcache::insert (const void *addr, int length, bool *added)
     memcpy (&newobj->d.data, addr, length);
     newobj->length = length;
     newobj->next = m_bucket[hash_index];
-    newobj->half_hash = half_hash;
+    newobj->hash = full_hash;
     m_bucket[hash_index] = newobj;
 
     m_unique_count++;
@@ -258,6 +264,39 @@ print_percentage (int portion, int total)
 void
 bcache::print_statistics (const char *type)
 {
+  bcache *self = this;
+
+  print_statistics (type, gdb::array_view<bcache *const> (&self, 1));
+}
+
+/* Print the combined statistics of CACHES, as for print_statistics
+   above.  */
+
+void
+bcache::print_statistics (const char *type,
+			  gdb::array_view<bcache *const> caches)
+{
+  unsigned int num_buckets = 0;
+  unsigned long unique_count = 0;
+  long total_count = 0;
+  long unique_size = 0;
+  long total_size = 0;
+  long structure_size = 0;
+  unsigned long expand_count = 0;
+  unsigned long hash_miss_count = 0;
+
+  for (const bcache *cache : caches)
+    {
+      num_buckets += cache->m_num_buckets;
+      unique_count += cache->m_unique_count;
+      total_count += cache->m_total_count;
+      unique_size += cache->m_unique_size;
+      total_size += cache->m_total_size;
+      structure_size += cache->m_structure_size;
+      expand_count += cache->m_expand_count;
+      hash_miss_count += cache->m_hash_miss_count;
+    }
+
   int occupied_buckets;
   int max_chain_length;
   int median_chain_length;
@@ -267,53 +306,54 @@ bcache::print_statistics (const char *type)
   /* Count the number of occupied buckets, tally the various string
      lengths, and measure chain lengths.  */
   {
-    unsigned int b;
-    int *chain_length = XCNEWVEC (int, m_num_buckets + 1);
-    int *entry_size = XCNEWVEC (int, m_unique_count + 1);
+    int *chain_length = XCNEWVEC (int, num_buckets + 1);
+    int *entry_size = XCNEWVEC (int, unique_count + 1);
+    unsigned int chaini = 0;
     int stringi = 0;
 
     occupied_buckets = 0;
 
-    for (b = 0; b < m_num_buckets; b++)
-      {
-	struct bstring *s = m_bucket[b];
-
-	chain_length[b] = 0;
-
-	if (s)
-	  {
-	    occupied_buckets++;
-	    
-	    while (s)
-	      {
-		gdb_assert (b < m_num_buckets);
-		chain_length[b]++;
-		gdb_assert (stringi < m_unique_count);
-		entry_size[stringi++] = s->length;
-		s = s->next;
-	      }
-	  }
-      }
+    for (const bcache *cache : caches)
+      for (unsigned int b = 0; b < cache->m_num_buckets; b++, chaini++)
+	{
+	  struct bstring *s = cache->m_bucket[b];
+
+	  chain_length[chaini] = 0;
+
+	  if (s)
+	    {
+	      occupied_buckets++;
+
+	      while (s)
+		{
+		  gdb_assert (chaini < num_buckets);
+		  chain_length[chaini]++;
+		  gdb_assert (stringi < unique_count);
+		  entry_size[stringi++] = s->length;
+		  s = s->next;
+		}
+	    }
+	}
 
     /* To compute the median, we need the set of chain lengths
        sorted.  */
-    std::sort (chain_length, chain_length + m_num_buckets);
-    std::sort (entry_size, entry_size + m_unique_count);
+    std::sort (chain_length, chain_length + num_buckets);
+    std::sort (entry_size, entry_size + unique_count);
 
-    if (m_num_buckets > 0)
+    if (num_buckets > 0)
       {
-	max_chain_length = chain_length[m_num_buckets - 1];
-	median_chain_length = chain_length[m_num_buckets / 2];
+	max_chain_length = chain_length[num_buckets - 1];
+	median_chain_length = chain_length[num_buckets / 2];
       }
     else
       {
 	max_chain_length = 0;
 	median_chain_length = 0;
       }
-    if (m_unique_count > 0)
+    if (unique_count > 0)
       {
-	max_entry_size = entry_size[m_unique_count - 1];
-	median_entry_size = entry_size[m_unique_count / 2];
+	max_entry_size = entry_size[unique_count - 1];
+	median_entry_size = entry_size[unique_count / 2];
       }
     else
       {
@@ -326,22 +366,22 @@ bcache::print_statistics (const char *type)
   }
 
   gdb_printf (_("  M_Cached '%s' statistics:\n"), type);
-  gdb_printf (_("    Total object count:  %ld\n"), m_total_count);
-  gdb_printf (_("    Unique object count: %lu\n"), m_unique_count);
+  gdb_printf (_("    Total object count:  %ld\n"), total_count);
+  gdb_printf (_("    Unique object count: %lu\n"), unique_count);
   gdb_printf (_("    Percentage of duplicates, by count: "));
-  print_percentage (m_total_count - m_unique_count, m_total_count);
+  print_percentage (total_count - unique_count, total_count);
   gdb_printf ("\n");
 
-  gdb_printf (_("    Total object size:   %ld\n"), m_total_size);
-  gdb_printf (_("    Unique object size:  %ld\n"), m_unique_size);
+  gdb_printf (_("    Total object size:   %ld\n"), total_size);
+  gdb_printf (_("    Unique object size:  %ld\n"), unique_size);
   gdb_printf (_("    Percentage of duplicates, by size:  "));
-  print_percentage (m_total_size - m_unique_size, m_total_size);
+  print_percentage (total_size - unique_size, total_size);
   gdb_printf ("\n");
 
   gdb_printf (_("    Max entry size:     %d\n"), max_entry_size);
   gdb_printf (_("    Average entry size: "));
-  if (m_unique_count > 0)
-    gdb_printf ("%ld\n", m_unique_size / m_unique_count);
+  if (unique_count > 0)
+    gdb_printf ("%ld\n", unique_size / unique_count);
   else
     /* i18n: "Average entry size: (not applicable)".  */
     gdb_printf (_("(not applicable)\n"));    
@@ -350,28 +390,28 @@ bcache::print_statistics (const char *type)
 
   gdb_printf (_("    \
 Total memory used by bcache, including overhead: %ld\n"),
-	      m_structure_size);
+	      structure_size);
   gdb_printf (_("    Percentage memory overhead: "));
-  print_percentage (m_structure_size - m_unique_size, m_unique_size);
+  print_percentage (structure_size - unique_size, unique_size);
   gdb_printf (_("    Net memory savings:         "));
-  print_percentage (m_total_size - m_structure_size, m_total_size);
+  print_percentage (total_size - structure_size, total_size);
   gdb_printf ("\n");
 
   gdb_printf (_("    Hash table size:           %3d\n"), 
-	      m_num_buckets);
+	      num_buckets);
   gdb_printf (_("    Hash table expands:        %lu\n"),
-	      m_expand_count);
-  gdb_printf (_("    Hash table hashes:         %lu\n"),
-	      m_total_count + m_expand_hash_count);
-  gdb_printf (_("    Half hash misses:          %lu\n"),
-	      m_half_hash_miss_count);
+	      expand_count);
+  gdb_printf (_("    Hash table hashes:         %ld\n"),
+	      total_count);
+  gdb_printf (_("    Hash misses:               %lu\n"),
+	      hash_miss_count);
   gdb_printf (_("    Hash table population:     "));
-  print_percentage (occupied_buckets, m_num_buckets);
+  print_percentage (occupied_buckets, num_buckets);
   gdb_printf (_("    Median hash chain length:  %3d\n"),
 	      median_chain_length);
   gdb_printf (_("    Average hash chain length: "));
-  if (m_num_buckets > 0)
-    gdb_printf ("%3lu\n", m_unique_count / m_num_buckets);
+  if (num_buckets > 0)
+    gdb_printf ("%3lu\n", unique_count / num_buckets);
   else
     /* i18n: "Average hash chain length: (not applicable)".  */
     gdb_printf (_("(not applicable)\n"));
@@ -388,4 +428,79 @@ bcache::memory_used ()
   return obstack_memory_used (&m_cache);
 }
 
+
+/* See bcache.h.  */
+
+const void *
+concurrent_bcache::insert (const void *addr, int length, bool *added)
+{
+  /* This must match bcache::hash.  */
+  unsigned int full_hash = fast_hash (addr, length, 0);
+
+  /* Pick the shard using the top bits of the hash; the buckets within
+     the shard are picked using the value modulo a prime.  */
+  gdb_static_assert ((n_shards & (n_shards - 1)) == 0);
+  shard &s = m_shards[(full_hash >> 16) & (n_shards - 1)];
+
+#if CXX_STD_THREAD
+  std::unique_lock<std::mutex> guard (s.lock, std::try_to_lock);
+  if (!guard.owns_lock ())
+    {
+      guard.lock ();
+      ++s.contended_count;
+    }
+#endif
+
+  return s.cache.insert (addr, length, full_hash, added);
+}
+
+/* See bcache.h.  */
+
+void
+concurrent_bcache::print_statistics (const char *type)
+{
+  bcache *caches[n_shards];
+  unsigned long contended_count = 0;
+
+  for (unsigned int i = 0; i < n_shards; ++i)
+    {
+      caches[i] = &m_shards[i].cache;
+      contended_count += m_shards[i].contended_count;
+    }
+
+  bcache::print_statistics (type, caches);
+
+  gdb_printf (_("    Number of shards:          %3u\n"), n_shards);
+  gdb_printf (_("    Contended insertions:      %lu\n"),
+	      contended_count);
+  gdb_printf ("\n");
+}
+
+/* See bcache.h.  */
+
+int
+concurrent_bcache::memory_used ()
+{
+  int result = 0;
+
+  for (shard &s : m_shards)
+    result += s.cache.memory_used ();
+  return result;
+}
+
+/* See bcache.h.  */
+
+void
+concurrent_bcache::add_counts (ULONGEST *total, ULONGEST *unique)
+{
+  for (shard &s : m_shards)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> guard (s.lock);
+#endif
+      *total += s.cache.m_total_count;
+      *unique += s.cache.m_unique_count;
+    }
+}
+
 } /* namespace gdb */
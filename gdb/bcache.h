@@ -22,6 +22,11 @@
 #ifndef BCACHE_H
 #define BCACHE_H 1
 
+#include "gdbsupport/array-view.h"
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
+
 /* A bcache is a data structure for factoring out duplication in
    read-only structures.  You give the bcache some string of bytes S.
    If the bcache already contains a copy of S, it hands you back a
@@ -133,6 +138,11 @@
    Mind you, looking at the wall clock, the same GDB debugging GDB
    showed only marginal speed up (0.780 vs 0.773s).  Seems GDB is too
    busy doing something else :-(
+
+   Nowadays the whole hash value is stored, in what used to be
+   padding, and is compared instead of its upper 16 bits.  Keeping it
+   also means that expanding the hash table doesn't need to hash every
+   string again.
   
 */
 
@@ -173,6 +183,18 @@ struct bcache
 
 private:
 
+  friend struct concurrent_bcache;
+
+  /* Like insert, but FULL_HASH is the hash value of the LENGTH bytes
+     at ADDR, as computed by the hash method.  */
+  const void *insert (const void *addr, int length, unsigned int full_hash,
+		      bool *added);
+
+  /* Print the combined statistics of CACHES, as for the
+     print_statistics method.  */
+  static void print_statistics (const char *type,
+				gdb::array_view<bcache *const> caches);
+
   /* All the bstrings are allocated here.  */
   struct obstack m_cache {};
 
@@ -190,21 +212,67 @@ struct bcache
   long m_total_size = 0;      /* total number of bytes cached, including dups */
   long m_structure_size = 0;	/* total size of bcache, including infrastructure */
   /* Number of times that the hash table is expanded and hence
-     re-built, and the corresponding number of times that a string is
-     [re]hashed as part of entering it into the expanded table.  The
-     total number of hashes can be computed by adding TOTAL_COUNT to
-     expand_hash_count.  */
+     re-built.  */
   unsigned long m_expand_count = 0;
-  unsigned long m_expand_hash_count = 0;
-  /* Number of times that the half-hash compare hit (compare the upper
-     16 bits of hash values) hit, but the corresponding combined
-     length/data compare missed.  */
-  unsigned long m_half_hash_miss_count = 0;
+  /* Number of times that the hash compare hit, but the corresponding
+     combined length/data compare missed.  */
+  unsigned long m_hash_miss_count = 0;
 
   /* Expand the hash table.  */
   void expand_hash_table ();
 };
 
+/* A bcache that can be used by several threads at once, for example
+   to intern names while reading symbols in parallel.
+
+   The strings are spread over a fixed number of shards, by hash
+   value.  Each shard is an ordinary bcache with a lock of its own, so
+   threads inserting different strings rarely wait for one another.
+   The hash value is computed once, outside of any lock, and is also
+   used within the shard.
+
+   Unlike bcache, this always uses the default hash and compare
+   functions.  */
+
+struct concurrent_bcache
+{
+  concurrent_bcache () = default;
+  DISABLE_COPY_AND_ASSIGN (concurrent_bcache);
+
+  /* Like bcache::insert.  This may be called from any thread.  */
+  const void *insert (const void *addr, int length, bool *added = nullptr);
+
+  /* Print statistics on this bcache, including how often threads had
+     to wait for one another.  This must not be called while other
+     threads are inserting strings.  */
+  void print_statistics (const char *type);
+  int memory_used ();
+
+  /* Add the number of insertions into this bcache to *TOTAL, and the
+     number of distinct strings it holds to *UNIQUE.  Unlike the
+     other statistics, this may be called while other threads are
+     inserting strings.  */
+  void add_counts (ULONGEST *total, ULONGEST *unique);
+
+private:
+
+  /* The number of shards.  This must be a power of two.  */
+  static constexpr unsigned int n_shards = 8;
+
+  struct shard
+  {
+    bcache cache;
+#if CXX_STD_THREAD
+    std::mutex lock;
+#endif
+    /* Number of insertions that had to wait for another thread to
+       release LOCK.  This is protected by LOCK.  */
+    unsigned long contended_count = 0;
+  };
+
+  shard m_shards[n_shards];
+};
+
 } /* namespace gdb */
 
 #endif /* BCACHE_H */
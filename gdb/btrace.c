@@ -34,6 +34,11 @@
 #include "gdbcmd.h"
 #include "cli/cli-utils.h"
 #include "gdbarch.h"
+#include "trace-events.h"
+#include "run-on-main-thread.h"
+#include "gdbsupport/gdb_optional.h"
+#include "gdbsupport/parallel-for.h"
+#include "gdbsupport/scope-exit.h"
 
 /* For maintenance commands.  */
 #include "record-btrace.h"
@@ -41,6 +46,7 @@
 #include <inttypes.h>
 #include <ctype.h>
 #include <algorithm>
+#include <unordered_map>
 
 /* Command lists for btrace maintenance commands.  */
 static struct cmd_list_element *maint_btrace_cmdlist;
@@ -52,6 +58,9 @@ static struct cmd_list_element *maint_btrace_pt_show_cmdlist;
 /* Control whether to skip PAD packets when computing the packet history.  */
 static bool maint_btrace_pt_skip_pad = true;
 
+/* Control whether Intel PT trace is decoded in parallel.  */
+static bool maint_btrace_pt_parallel_decode = true;
+
 static void btrace_add_pc (struct thread_info *tp);
 
 /* Print a record debug message.  Use do ... while (0) to avoid ambiguities
@@ -1203,17 +1212,50 @@ pt_btrace_insn (const struct pt_insn &insn)
 	  pt_btrace_insn_flags (insn)};
 }
 
-/* Handle instruction decode events (libipt-v2).  */
+/* The kinds of gap in an Intel PT trace.  */
+
+enum pt_gap_kind
+{
+  /* Tracing was disabled and enabled again at another instruction.  */
+  PT_GAP_DISABLED,
+
+  /* The trace buffer overflowed.  */
+  PT_GAP_OVERFLOW,
+
+  /* The trace could not be decoded.  */
+  PT_GAP_ERROR
+};
+
+/* Where the decoder puts the instructions and gaps it decodes from an
+   Intel PT trace.  Decoding the trace is kept apart from building the
+   function segments, so that the former can be done in parallel.  */
+
+struct pt_decode_sink
+{
+  virtual ~pt_decode_sink () = default;
+
+  /* Add the instruction INSN.  */
+  virtual void add_insn (const struct pt_insn &insn) = 0;
+
+  /* Add a gap of kind KIND.  ERRCODE is the libipt error code of a
+     PT_GAP_ERROR gap.  OFFSET is the trace offset at which the gap was
+     found, and PC, if known, the instruction it was found at; they are
+     only used for warnings.  */
+  virtual void add_gap (enum pt_gap_kind kind, int errcode, uint64_t offset,
+			gdb::optional<uint64_t> pc) = 0;
+};
+
+/* Handle instruction decode events (libipt-v2).  BASE is the offset
+   of DECODER's trace in the whole trace.  */
 
 static int
-handle_pt_insn_events (struct btrace_thread_info *btinfo,
+handle_pt_insn_events (pt_decode_sink &sink,
 		       struct pt_insn_decoder *decoder,
-		       std::vector<unsigned int> &gaps, int status)
+		       uint64_t base, int status)
 {
 #if defined (HAVE_PT_INSN_EVENT)
   while (status & pts_event_pending)
     {
-      struct btrace_function *bfun;
       struct pt_event event;
       uint64_t offset;
 
@@ -1230,25 +1272,17 @@ handle_pt_insn_events (struct btrace_thread_info *btinfo,
 	  if (event.status_update != 0)
 	    break;
 
-	  if (event.variant.enabled.resumed == 0 && !btinfo->functions.empty ())
+	  if (event.variant.enabled.resumed == 0)
 	    {
-	      bfun = ftrace_new_gap (btinfo, BDE_PT_DISABLED, gaps);
-
 	      pt_insn_get_offset (decoder, &offset);
-
-	      warning (_("Non-contiguous trace at instruction %u (offset = 0x%"
-			 PRIx64 ")."), bfun->insn_offset - 1, offset);
+	      sink.add_gap (PT_GAP_DISABLED, 0, base + offset, {});
 	    }
 
 	  break;
 
 	case ptev_overflow:
-	  bfun = ftrace_new_gap (btinfo, BDE_PT_OVERFLOW, gaps);
-
 	  pt_insn_get_offset (decoder, &offset);
-
-	  warning (_("Overflow at instruction %u (offset = 0x%" PRIx64 ")."),
-		   bfun->insn_offset - 1, offset);
+	  sink.add_gap (PT_GAP_OVERFLOW, 0, base + offset, {});
 
 	  break;
 	}
@@ -1258,13 +1292,13 @@ handle_pt_insn_events (struct btrace_thread_info *btinfo,
   return status;
 }
 
-/* Handle events indicated by flags in INSN (libipt-v1).  */
+/* Handle events indicated by flags in INSN (libipt-v1).  BASE is the
+   offset of DECODER's trace in the whole trace.  */
 
 static void
-handle_pt_insn_event_flags (struct btrace_thread_info *btinfo,
+handle_pt_insn_event_flags (pt_decode_sink &sink,
 			    struct pt_insn_decoder *decoder,
-			    const struct pt_insn &insn,
-			    std::vector<unsigned int> &gaps)
+			    uint64_t base, const struct pt_insn &insn)
 {
 #if defined (HAVE_STRUCT_PT_INSN_ENABLED)
   /* Tracing is disabled and re-enabled each time we enter the kernel.  Most
@@ -1272,18 +1306,12 @@ handle_pt_insn_event_flags (struct btrace_thread_info *btinfo,
      indicated via the RESUMED instruction flag.  The ENABLED instruction flag
      means that we continued from some other instruction.  Indicate this as a
      trace gap except when tracing just started.  */
-  if (insn.enabled && !btinfo->functions.empty ())
+  if (insn.enabled)
     {
-      struct btrace_function *bfun;
       uint64_t offset;
 
-      bfun = ftrace_new_gap (btinfo, BDE_PT_DISABLED, gaps);
-
       pt_insn_get_offset (decoder, &offset);
-
-      warning (_("Non-contiguous trace at instruction %u (offset = 0x%" PRIx64
-		 ", pc = 0x%" PRIx64 ")."), bfun->insn_offset - 1, offset,
-	       insn.ip);
+      sink.add_gap (PT_GAP_DISABLED, 0, base + offset, insn.ip);
     }
 #endif /* defined (HAVE_STRUCT_PT_INSN_ENABLED) */
 
@@ -1291,28 +1319,23 @@ handle_pt_insn_event_flags (struct btrace_thread_info *btinfo,
   /* Indicate trace overflows.  */
   if (insn.resynced)
     {
-      struct btrace_function *bfun;
       uint64_t offset;
 
-      bfun = ftrace_new_gap (btinfo, BDE_PT_OVERFLOW, gaps);
-
       pt_insn_get_offset (decoder, &offset);
-
-      warning (_("Overflow at instruction %u (offset = 0x%" PRIx64 ", pc = 0x%"
-		 PRIx64 ")."), bfun->insn_offset - 1, offset, insn.ip);
+      sink.add_gap (PT_GAP_OVERFLOW, 0, base + offset, insn.ip);
     }
 #endif /* defined (HAVE_STRUCT_PT_INSN_RESYNCED) */
 }
 
-/* Add function branch trace to BTINFO using DECODER.  */
+/* Decode the trace of DECODER into SINK.  BASE is the offset of
+   DECODER's trace in the whole trace.  Return the status of the last
+   attempt to synchronize onto the trace, which is -pte_eos if the
+   whole trace was decoded.  */
 
-static void
-ftrace_add_pt (struct btrace_thread_info *btinfo,
-	       struct pt_insn_decoder *decoder,
-	       int *plevel,
-	       std::vector<unsigned int> &gaps)
+static int
+pt_decode_trace (pt_decode_sink &sink, struct pt_insn_decoder *decoder,
+		 uint64_t base)
 {
-  struct btrace_function *bfun;
   uint64_t offset;
   int status;
 
@@ -1322,17 +1345,12 @@ ftrace_add_pt (struct btrace_thread_info *btinfo,
 
       status = pt_insn_sync_forward (decoder);
       if (status < 0)
-	{
-	  if (status != -pte_eos)
-	    warning (_("Failed to synchronize onto the Intel Processor "
-		       "Trace stream: %s."), pt_errstr (pt_errcode (status)));
-	  break;
-	}
+	return status;
 
       for (;;)
 	{
 	  /* Handle events from the previous iteration or synchronization.  */
-	  status = handle_pt_insn_events (btinfo, decoder, gaps, status);
+	  status = handle_pt_insn_events (sink, decoder, base, status);
 	  if (status < 0)
 	    break;
 
@@ -1341,30 +1359,122 @@ ftrace_add_pt (struct btrace_thread_info *btinfo,
 	    break;
 
 	  /* Handle events indicated by flags in INSN.  */
-	  handle_pt_insn_event_flags (btinfo, decoder, insn, gaps);
-
-	  bfun = ftrace_update_function (btinfo, insn.ip);
+	  handle_pt_insn_event_flags (sink, decoder, base, insn);
 
-	  /* Maintain the function level offset.  */
-	  *plevel = std::min (*plevel, bfun->level);
-
-	  ftrace_update_insns (bfun, pt_btrace_insn (insn));
+	  sink.add_insn (insn);
 	}
 
       if (status == -pte_eos)
-	break;
+	return status;
 
       /* Indicate the gap in the trace.  */
-      bfun = ftrace_new_gap (btinfo, status, gaps);
-
       pt_insn_get_offset (decoder, &offset);
-
-      warning (_("Decode error (%d) at instruction %u (offset = 0x%" PRIx64
-		 ", pc = 0x%" PRIx64 "): %s."), status, bfun->insn_offset - 1,
-	       offset, insn.ip, pt_errstr (pt_errcode (status)));
+      sink.add_gap (PT_GAP_ERROR, status, base + offset, insn.ip);
     }
 }
 
+/* Warn about a failure to synchronize onto the trace, with STATUS.  */
+
+static void
+pt_warn_sync_failure (int status)
+{
+  if (status != -pte_eos)
+    warning (_("Failed to synchronize onto the Intel Processor "
+	       "Trace stream: %s."), pt_errstr (pt_errcode (status)));
+}
+
+/* A sink that adds what is decoded to the function segments of a
+   thread's branch trace.  */
+
+struct ftrace_pt_sink : public pt_decode_sink
+{
+  ftrace_pt_sink (struct btrace_thread_info *btinfo, int *plevel,
+		  std::vector<unsigned int> &gaps)
+    : m_btinfo (btinfo),
+      m_plevel (plevel),
+      m_gaps (gaps)
+  {
+  }
+
+  void add_insn (const struct pt_insn &insn) override
+  {
+    add_btrace_insn (pt_btrace_insn (insn));
+  }
+
+  /* Add INSN, already converted from the decoder's instruction.  */
+  void add_btrace_insn (const btrace_insn &insn)
+  {
+    struct btrace_function *bfun = ftrace_update_function (m_btinfo, insn.pc);
+
+    /* Maintain the function level offset.  */
+    *m_plevel = std::min (*m_plevel, bfun->level);
+
+    ftrace_update_insns (bfun, insn);
+  }
+
+  void add_gap (enum pt_gap_kind kind, int errcode, uint64_t offset,
+		gdb::optional<uint64_t> pc) override
+  {
+    struct btrace_function *bfun;
+
+    switch (kind)
+      {
+      case PT_GAP_DISABLED:
+	/* This is not a gap when tracing just started.  */
+	if (m_btinfo->functions.empty ())
+	  return;
+
+	bfun = ftrace_new_gap (m_btinfo, BDE_PT_DISABLED, m_gaps);
+	if (pc.has_value ())
+	  warning (_("Non-contiguous trace at instruction %u (offset = 0x%"
+		     PRIx64 ", pc = 0x%" PRIx64 ")."), bfun->insn_offset - 1,
+		   offset, *pc);
+	else
+	  warning (_("Non-contiguous trace at instruction %u (offset = 0x%"
+		     PRIx64 ")."), bfun->insn_offset - 1, offset);
+	return;
+
+      case PT_GAP_OVERFLOW:
+	bfun = ftrace_new_gap (m_btinfo, BDE_PT_OVERFLOW, m_gaps);
+	if (pc.has_value ())
+	  warning (_("Overflow at instruction %u (offset = 0x%" PRIx64
+		     ", pc = 0x%" PRIx64 ")."), bfun->insn_offset - 1, offset,
+		   *pc);
+	else
+	  warning (_("Overflow at instruction %u (offset = 0x%" PRIx64 ")."),
+		   bfun->insn_offset - 1, offset);
+	return;
+
+      case PT_GAP_ERROR:
+	bfun = ftrace_new_gap (m_btinfo, errcode, m_gaps);
+	warning (_("Decode error (%d) at instruction %u (offset = 0x%" PRIx64
+		   ", pc = 0x%" PRIx64 "): %s."), errcode,
+		 bfun->insn_offset - 1, offset, *pc,
+		 pt_errstr (pt_errcode (errcode)));
+	return;
+      }
+  }
+
+private:
+
+  struct btrace_thread_info *m_btinfo;
+  int *m_plevel;
+  std::vector<unsigned int> &m_gaps;
+};
+
+/* Add function branch trace to BTINFO using DECODER.  */
+
+static void
+ftrace_add_pt (struct btrace_thread_info *btinfo,
+	       struct pt_insn_decoder *decoder,
+	       int *plevel,
+	       std::vector<unsigned int> &gaps)
+{
+  ftrace_pt_sink sink (btinfo, plevel, gaps);
+
+  pt_warn_sync_failure (pt_decode_trace (sink, decoder, 0));
+}
+
 /* A callback function to allow the trace decoder to read the inferior's
    memory.  */
 
@@ -1405,6 +1515,426 @@ pt_translate_cpu_vendor (enum btrace_cpu_vendor vendor)
     }
 }
 
+/* A cache of the inferior's code for the threads decoding an Intel PT
+   trace in parallel.  GDB's target stack is not thread-safe, so the
+   target is only read by the main thread, while no trace is being
+   decoded; the worker threads only look up the cached blocks.  */
+
+struct pt_code_cache
+{
+  /* The size and alignment of a cached block.  */
+  static constexpr CORE_ADDR block_size = 4096;
+
+  /* Return the cached block of code starting at START, or NULL if it
+     was not read yet.  The block is empty if it could not be read.  */
+  const gdb::byte_vector *find_block (CORE_ADDR start) const
+  {
+    auto iter = m_blocks.find (start);
+    return iter == m_blocks.end () ? nullptr : &iter->second;
+  }
+
+  /* Return the block of code starting at START, reading it from the
+     target if it is not cached yet.  This must only be called from the
+     main thread.  */
+  const gdb::byte_vector &read_block (CORE_ADDR start)
+  {
+    gdb_assert (is_main_thread ());
+
+    auto inserted = m_blocks.emplace (start, gdb::byte_vector ());
+    gdb::byte_vector &block = inserted.first->second;
+    if (inserted.second)
+      {
+	block.resize (block_size);
+	try
+	  {
+	    if (target_read_code (start, block.data (), block_size) != 0)
+	      block.clear ();
+	  }
+	catch (const gdb_exception_error &error)
+	  {
+	    block.clear ();
+	  }
+      }
+
+    return block;
+  }
+
+private:
+
+  /* The cached blocks, by address.  An unreadable block is empty.  */
+  std::unordered_map<CORE_ADDR, gdb::byte_vector> m_blocks;
+};
+
+/* Return true if decoding INSN may have used a packet of the trace.
+   Direct near calls and jumps don't, but their indirect forms need a
+   TIP packet; only the usual encodings of the former are recognized,
+   anything else is assumed to use a packet.  */
+
+static bool
+pt_insn_uses_packet (const struct pt_insn &insn)
+{
+  switch (insn.iclass)
+    {
+    case ptic_other:
+      return false;
+
+    case ptic_call:
+    case ptic_jump:
+      return !(insn.size > 0
+	       && (insn.raw[0] == 0xe8		/* call rel32 */
+		   || insn.raw[0] == 0xe9	/* jmp rel32 */
+		   || insn.raw[0] == 0xeb));	/* jmp rel8 */
+
+    default:
+      return true;
+    }
+}
+
+/* The decoding of one segment of an Intel PT trace, from one PSB packet
+   up to the next one.  What is decoded is recorded, to be added to the
+   function segments once all segments are decoded.  */
+
+struct pt_trace_segment : public pt_decode_sink
+{
+  /* A decoded instruction.  Only what the branch trace keeps is
+     recorded, not the decoder's instruction.  */
+  struct insn
+  {
+    /* The instruction.  */
+    btrace_insn insn;
+
+    /* Whether decoding the instruction may have used a packet, see
+       pt_insn_uses_packet.  */
+    bool uses_packet;
+  };
+
+  /* A gap, with the arguments of pt_decode_sink::add_gap.  */
+  struct gap
+  {
+    /* The number of instructions decoded before the gap.  */
+    size_t index;
+
+    enum pt_gap_kind kind;
+    int errcode;
+    uint64_t offset;
+    gdb::optional<uint64_t> pc;
+  };
+
+  pt_trace_segment (uint64_t begin, uint64_t end, pt_code_cache *code)
+    : begin (begin),
+      end (end),
+      m_code (code)
+  {
+  }
+
+  void add_insn (const struct pt_insn &insn) override
+  {
+    insns.push_back ({pt_btrace_insn (insn), pt_insn_uses_packet (insn)});
+  }
+
+  void add_gap (enum pt_gap_kind kind, int errcode, uint64_t offset,
+		gdb::optional<uint64_t> pc) override
+  {
+    gaps.push_back ({insns.size (), kind, errcode, offset, pc});
+  }
+
+  /* Forget what was decoded, to decode the segment again.  */
+  void reset ()
+  {
+    insns.clear ();
+    gaps.clear ();
+    status = -pte_eos;
+    missing_block.reset ();
+    m_block = nullptr;
+  }
+
+  /* Read SIZE bytes of code at PC into BUFFER, for the decoder.  Return
+     the number of bytes read, or a negative libipt error code.  */
+  int read_code (gdb_byte *buffer, size_t size, CORE_ADDR pc)
+  {
+    /* What is decoded after a miss is thrown away.  */
+    if (missing_block.has_value ())
+      return -pte_nomap;
+
+    size_t done = 0;
+
+    while (done < size)
+      {
+	CORE_ADDR addr = pc + done;
+	CORE_ADDR start = addr - addr % pt_code_cache::block_size;
+
+	/* Code is mostly read from the block read last, so remember it
+	   to avoid looking it up.  */
+	if (m_block == nullptr || m_block_start != start)
+	  {
+	    if (read_target)
+	      m_block = &m_code->read_block (start);
+	    else
+	      m_block = m_code->find_block (start);
+	    m_block_start = start;
+
+	    if (m_block == nullptr)
+	      {
+		missing_block = start;
+		return -pte_nomap;
+	      }
+	  }
+	if (m_block->empty ())
+	  break;
+
+	size_t n = std::min (size - done, (size_t) (start + m_block->size ()
+						     - addr));
+	memcpy (buffer + done, m_block->data () + (addr - start), n);
+	done += n;
+      }
+
+    if (done == 0)
+      return -pte_nomap;
+    return done;
+  }
+
+  /* The offsets of the segment's trace in the whole trace.  */
+  uint64_t begin;
+  uint64_t end;
+
+  /* What was decoded.  */
+  std::vector<insn> insns;
+  std::vector<gap> gaps;
+
+  /* The status of the last attempt to synchronize onto the trace.  */
+  int status = -pte_eos;
+
+  /* Whether the code may be read from the target, when the segment is
+     decoded by the main thread.  */
+  bool read_target = false;
+
+  /* The address of the first block of code that was needed but not
+     cached, if any.  What was decoded is then incomplete.  */
+  gdb::optional<CORE_ADDR> missing_block;
+
+private:
+
+  pt_code_cache *m_code;
+
+  /* The block of code read last, and its address.  */
+  const gdb::byte_vector *m_block = nullptr;
+  CORE_ADDR m_block_start = 0;
+};
+
+/* The trace decoder's callback to read the inferior's memory, when
+   decoding a segment of the trace in parallel.  */
+
+static int
+btrace_pt_segment_readmem_callback (gdb_byte *buffer, size_t size,
+				    const struct pt_asid *asid, uint64_t pc,
+				    void *context)
+{
+  pt_trace_segment *segment = (pt_trace_segment *) context;
+
+  return segment->read_code (buffer, size, (CORE_ADDR) pc);
+}
+
+/* Decode SEGMENT of the trace described by CONFIG, forgetting what was
+   decoded before.  This runs in a worker thread, unless the segment
+   may read the target.  */
+
+static void
+pt_decode_segment (const struct pt_config &config, pt_trace_segment &segment)
+{
+  segment.reset ();
+
+  struct pt_config segment_config = config;
+  segment_config.begin = config.begin + segment.begin;
+  segment_config.end = config.begin + segment.end;
+
+  struct pt_insn_decoder *decoder = pt_insn_alloc_decoder (&segment_config);
+  if (decoder == nullptr)
+    {
+      segment.add_gap (PT_GAP_ERROR, -pte_nomem, segment.begin, 0);
+      return;
+    }
+  SCOPE_EXIT { pt_insn_free_decoder (decoder); };
+
+  struct pt_image *image = pt_insn_get_image (decoder);
+  int errcode = (image == nullptr ? -pte_internal
+		 : pt_image_set_callback (image,
+					  btrace_pt_segment_readmem_callback,
+					  &segment));
+  if (errcode < 0)
+    {
+      segment.add_gap (PT_GAP_ERROR, errcode, segment.begin, 0);
+      return;
+    }
+
+  segment.status = pt_decode_trace (segment, decoder, segment.begin);
+}
+
+/* Return the offsets of the PSB packets in the trace described by
+   CONFIG.  */
+
+static std::vector<uint64_t>
+pt_find_sync_points (const struct pt_config &config)
+{
+  std::vector<uint64_t> points;
+
+  struct pt_packet_decoder *decoder = pt_pkt_alloc_decoder (&config);
+  if (decoder == nullptr)
+    return points;
+  SCOPE_EXIT { pt_pkt_free_decoder (decoder); };
+
+  for (;;)
+    {
+      uint64_t offset;
+
+      if (pt_pkt_sync_forward (decoder) < 0
+	  || pt_pkt_get_sync_offset (decoder, &offset) < 0)
+	break;
+
+      points.push_back (offset);
+    }
+
+  return points;
+}
+
+/* Drop the instructions at the end of SEGMENT that NEXT, the segment
+   that follows it, decodes again.
+
+   A segment is decoded until the decoder needs a packet that follows
+   the next PSB, that is up to the first conditional or indirect branch
+   after it.  The next segment starts at the instruction at which its
+   PSB was generated, so the straight-line code from there on is
+   decoded by both.  */
+
+static void
+pt_trim_segment_overlap (pt_trace_segment &segment,
+			 const pt_trace_segment &next)
+{
+  if (segment.insns.empty () || next.insns.empty ()
+      || (!next.gaps.empty () && next.gaps.front ().index == 0))
+    return;
+
+  /* The instructions before the last gap are not decoded again.  */
+  size_t first = segment.gaps.empty () ? 0 : segment.gaps.back ().index;
+
+  CORE_ADDR next_pc = next.insns.front ().insn.pc;
+  for (size_t i = segment.insns.size (); i > first; --i)
+    {
+      const pt_trace_segment::insn &insn = segment.insns[i - 1];
+
+      if (insn.insn.pc == next_pc)
+	{
+	  segment.insns.resize (i - 1);
+	  return;
+	}
+
+      /* The instructions before one that used a packet were decoded
+	 from packets of SEGMENT alone.  */
+      if (insn.uses_packet)
+	return;
+    }
+}
+
+/* The number of times the segments of a trace are decoded in parallel.
+   Each time, the worker threads note the first block of code they need
+   that is not cached yet, and the main thread reads these blocks before
+   the segments missing code are decoded again.  */
+
+static constexpr int pt_parallel_decode_rounds = 4;
+
+/* Add function branch trace to BTINFO from the trace described by
+   CONFIG, splitting it at PSB packets and decoding the pieces in
+   parallel.  Return false, having done nothing, if the trace cannot
+   be split or there are no worker threads.  */
+
+static bool
+ftrace_add_pt_parallel (struct btrace_thread_info *btinfo,
+			const struct pt_config &config, int *plevel,
+			std::vector<unsigned int> &gaps)
+{
+  if (!maint_btrace_pt_parallel_decode
+      || gdb::thread_pool::g_thread_pool->thread_count () == 0)
+    return false;
+
+  std::vector<uint64_t> points = pt_find_sync_points (config);
+  if (points.size () < 2)
+    return false;
+
+  pt_code_cache code;
+  std::vector<pt_trace_segment> segments;
+  segments.reserve (points.size ());
+  for (size_t i = 0; i < points.size (); ++i)
+    {
+      uint64_t end = (i + 1 < points.size () ? points[i + 1]
+		      : (uint64_t) (config.end - config.begin));
+      segments.emplace_back (points[i], end, &code);
+    }
+
+  /* The segments that still need to be decoded.  */
+  std::vector<pt_trace_segment *> pending;
+  for (pt_trace_segment &segment : segments)
+    pending.push_back (&segment);
+
+  using iter_type = std::vector<pt_trace_segment *>::iterator;
+  for (int round = 0;
+       round < pt_parallel_decode_rounds && !pending.empty ();
+       ++round)
+    {
+      gdb::parallel_for_each (1, pending.begin (), pending.end (),
+			      [&] (iter_type iter, iter_type end)
+	{
+	  scoped_trace_event task_trace ("btrace", "decode PT segments");
+	  for (; iter != end; ++iter)
+	    pt_decode_segment (config, **iter);
+	});
+
+      std::vector<pt_trace_segment *> missing;
+      for (pt_trace_segment *segment : pending)
+	if (segment->missing_block.has_value ())
+	  {
+	    code.read_block (*segment->missing_block);
+	    missing.push_back (segment);
+	  }
+      pending = std::move (missing);
+    }
+
+  /* Most segments run the same code, so few of them should still miss
+     some.  Decode those here, reading the target as needed.  */
+  for (pt_trace_segment *segment : pending)
+    {
+      segment->read_target = true;
+      pt_decode_segment (config, *segment);
+    }
+
+  /* Stitch the segments together, in order.  GDB's symbol lookups are
+     not thread-safe, so the function segments are built here.  */
+  ftrace_pt_sink sink (btinfo, plevel, gaps);
+  for (size_t i = 0; i < segments.size (); ++i)
+    {
+      pt_trace_segment &segment = segments[i];
+
+      if (i + 1 < segments.size ())
+	pt_trim_segment_overlap (segment, segments[i + 1]);
+
+      auto gap = segment.gaps.begin ();
+      for (size_t j = 0; j <= segment.insns.size (); ++j)
+	{
+	  for (; gap != segment.gaps.end () && gap->index == j; ++gap)
+	    sink.add_gap (gap->kind, gap->errcode, gap->offset, gap->pc);
+
+	  if (j < segment.insns.size ())
+	    sink.add_btrace_insn (segment.insns[j].insn);
+	}
+
+      pt_warn_sync_failure (segment.status);
+
+      /* Release the memory as we go.  */
+      segment.insns = {};
+      segment.gaps = {};
+    }
+
+  return true;
+}
+
 /* Finalize the function branch trace after decode.  */
 
 static void btrace_finalize_ftrace_pt (struct pt_insn_decoder *decoder,
@@ -1488,7 +2018,8 @@ btrace_compute_ftrace_pt (struct thread_info *tp,
 	error (_("Failed to configure the Intel Processor Trace decoder: "
 		 "%s."), pt_errstr (pt_errcode (errcode)));
 
-      ftrace_add_pt (btinfo, decoder, &level, gaps);
+      if (!ftrace_add_pt_parallel (btinfo, config, &level, gaps))
+	ftrace_add_pt (btinfo, decoder, &level, gaps);
     }
   catch (const gdb_exception &error)
     {
@@ -3123,6 +3654,16 @@ show_maint_btrace_pt_skip_pad  (struct ui_file *file, int from_tty,
   gdb_printf (file, _("Skip PAD packets is %s.\n"), value);
 }
 
+/* The "maint show btrace pt parallel-decode" show value function.  */
+
+static void
+show_maint_btrace_pt_parallel_decode (struct ui_file *file, int from_tty,
+				      struct cmd_list_element *c,
+				      const char *value)
+{
+  gdb_printf (file, _("Parallel decoding of Intel Processor Trace is %s.\n"),
+	      value);
+}
 
 /* Initialize btrace maintenance commands.  */
 
@@ -3162,6 +3703,16 @@ When enabled, PAD packets are ignored in the btrace packet history."),
 			   &maint_btrace_pt_set_cmdlist,
 			   &maint_btrace_pt_show_cmdlist);
 
+  add_setshow_boolean_cmd ("parallel-decode", class_maintenance,
+			   &maint_btrace_pt_parallel_decode, _("\
+Set whether Intel Processor Trace is decoded in parallel."), _("\
+Show whether Intel Processor Trace is decoded in parallel."), _("\
+When enabled, the trace is split at PSB packets and the pieces are\n\
+decoded by worker threads, then stitched together."),
+			   NULL, show_maint_btrace_pt_parallel_decode,
+			   &maint_btrace_pt_set_cmdlist,
+			   &maint_btrace_pt_show_cmdlist);
+
   add_cmd ("packet-history", class_maintenance, maint_btrace_packet_history_cmd,
 	   _("Print the raw branch tracing data.\n\
 With no argument, print ten more packets after the previous ten-line print.\n\
@@ -221,6 +221,20 @@ language_defn::printstr (struct ui_file *stream, struct type *type,
 		    '"', 1, options);
 }
 
+/* See c-lang.h.  */
+
+bool
+c_printstr_prefix_complete_p (struct type *type, const gdb_byte *string,
+			      unsigned int length,
+			      const struct value_print_options *options)
+{
+  const char *encoding;
+
+  classify_type (type, type->arch (), &encoding);
+  return generic_printstr_prefix_complete_p (type, string, length, encoding,
+					     options);
+}
+
 /* Obtain a C string from the inferior storing it in a newly allocated
    buffer in BUFFER, which should be freed by the caller.  If the in-
    and out-parameter *LENGTH is specified at -1, the string is read
@@ -128,6 +128,15 @@ extern int cp_is_vtbl_member (struct type *);
 
 extern bool c_is_string_type_p (struct type *type);
 
+/* Return true if the LENGTH characters of type TYPE at STRING are a
+   prefix of a longer string that is long enough for
+   language_defn::printstr to print the same thing for it as for the
+   whole string, except for the trailing ellipses.  */
+
+extern bool c_printstr_prefix_complete_p
+  (struct type *type, const gdb_byte *string, unsigned int length,
+   const struct value_print_options *options);
+
 /* These are in c-valprint.c.  */
 
 extern int c_textual_element_type (struct type *, char);
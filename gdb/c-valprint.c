@@ -228,6 +228,47 @@ print_unpacked_pointer (struct type *type, struct type *elttype,
     }
 }
 
+/* Read enough of VAL, a lazy array of LEN textual characters, to print
+   it with a string syntax according to OPTIONS, and return what was
+   read as an array value of its first characters.  */
+
+static value_ref_ptr
+c_read_char_array_prefix (struct value *val, unsigned int len,
+			  const struct value_print_options *options)
+{
+  struct type *type = check_typedef (val->type ());
+  struct type *unresolved_elttype = type->target_type ();
+  ULONGEST eltlen = check_typedef (unresolved_elttype)->length ();
+  unsigned int print_max_chars = get_print_max_chars (options);
+
+  /* One character more than is printed is needed to tell whether the
+     string was cut short.  Unless the string stops at the first null,
+     runs of repeated characters count as fewer characters, so the
+     prefix may need to be longer; it is doubled until it is long
+     enough.  */
+  unsigned int prefix_len = (print_max_chars < len
+			     ? print_max_chars + 1 : len);
+  while (true)
+    {
+      struct type *prefix_type
+	= lookup_array_range_type (unresolved_elttype, 0, prefix_len - 1);
+      value_ref_ptr prefix
+	= release_value (value_at (prefix_type, val->address ()));
+
+      if (prefix_len == len
+	  || options->stop_print_at_null
+	  || !prefix->bytes_available (0, prefix_len * eltlen)
+	  || prefix->bits_any_optimized_out (0, (TARGET_CHAR_BIT
+						 * prefix_len * eltlen))
+	  || c_printstr_prefix_complete_p (unresolved_elttype,
+					   prefix->contents ().data (),
+					   prefix_len, options))
+	return prefix;
+
+      prefix_len = prefix_len < len / 2 ? prefix_len * 2 : len;
+    }
+}
+
 /* c_value_print helper for TYPE_CODE_ARRAY.  */
 
 static void
@@ -237,10 +278,14 @@ c_value_print_array (struct value *val,
 {
   struct type *type = check_typedef (val->type ());
   CORE_ADDR address = val->address ();
-  const gdb_byte *valaddr = val->contents_for_printing ().data ();
   struct type *unresolved_elttype = type->target_type ();
   struct type *elttype = check_typedef (unresolved_elttype);
 
+  /* A large array that is still lazy here is to be read piecemeal
+     (see val_print_array_in_chunks_p); anything else is read now.  */
+  if (val->lazy () && !val_print_array_in_chunks_p (val, current_language))
+    val->fetch_lazy ();
+
   if (type->length () > 0 && unresolved_elttype->length () > 0)
     {
       LONGEST low_bound, high_bound;
@@ -253,14 +298,28 @@ c_value_print_array (struct value *val,
       eltlen = elttype->length ();
       len = high_bound - low_bound + 1;
 
+      bool textual = c_textual_element_type (unresolved_elttype,
+					     options->format);
+
+      /* The characters to print with a string syntax: either all of
+	 VAL, or just as many of its first characters as are printed.  */
+      value_ref_ptr prefix;
+      struct value *chars = val;
+      if (textual && val->lazy ())
+	{
+	  prefix = c_read_char_array_prefix (val, len, options);
+	  chars = prefix.get ();
+	}
+      ULONGEST chars_length = check_typedef (chars->type ())->length ();
+
       /* Print arrays of textual chars with a string syntax, as
 	 long as the entire array is valid.  */
-      if (c_textual_element_type (unresolved_elttype,
-				  options->format)
-	  && val->bytes_available (0, type->length ())
-	  && !val->bits_any_optimized_out (0,
-					   TARGET_CHAR_BIT * type->length ()))
+      if (textual
+	  && chars->bytes_available (0, chars_length)
+	  && !chars->bits_any_optimized_out (0,
+					     TARGET_CHAR_BIT * chars_length))
 	{
+	  const gdb_byte *valaddr = chars->contents_for_printing ().data ();
 	  int force_ellipses = 0;
 
 	  /* If requested, look for the first null char and only
@@ -292,6 +351,12 @@ c_value_print_array (struct value *val,
 
 	      len = temp_len;
 	    }
+	  else if (chars_length < type->length ())
+	    {
+	      /* Only the part of the string that is printed was read.  */
+	      len = chars_length / eltlen;
+	      force_ellipses = 1;
+	    }
 
 	  current_language->printstr (stream, unresolved_elttype, valaddr, len,
 				      NULL, force_ellipses, options);
@@ -316,7 +381,8 @@ c_value_print_array (struct value *val,
   else
     {
       /* Array of unspecified length: treat like pointer to first elt.  */
-      print_unpacked_pointer (type, elttype, unresolved_elttype, valaddr,
+      print_unpacked_pointer (type, elttype, unresolved_elttype,
+			      val->contents_for_printing ().data (),
 			      0, address, stream, recurse, options);
     }
 }
@@ -1575,6 +1575,15 @@ completion_tracker::maybe_add_completion
 
 /* See completer.h.  */
 
+bool
+completion_tracker::max_completions_reached () const
+{
+  return (max_completions >= 0
+	  && htab_elements (m_entries_hash.get ()) >= max_completions);
+}
+
+/* See completer.h.  */
+
 void
 completion_tracker::add_completion (gdb::unique_xmalloc_ptr<char> name,
 				    completion_match_for_lcd *match_for_lcd,
@@ -413,6 +413,12 @@ class completion_tracker
   bool have_completions () const
   { return htab_elements (m_entries_hash.get ()) > 0; }
 
+  /* True if as many completion matches as "max-completions" allows
+     have been recorded, so that no new one can be added.  Completers
+     that find matches by doing expensive work, like expanding symbol
+     tables, can check this to stop early.  */
+  bool max_completions_reached () const;
+
   /* Discard the current completion match list and the current
      LCD.  */
   void discard_completions ();
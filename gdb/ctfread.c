@@ -81,6 +81,8 @@
 #include "block.h"
 #include "ctfread.h"
 #include "psymtab.h"
+#include "trace-events.h"
+#include "gdbsupport/parallel-for.h"
 
 #if ENABLE_LIBCTF
 
@@ -178,6 +180,44 @@ struct ctf_per_tu_data
   psymbol_functions *psf;
 };
 
+/* A partial symbol found while scanning a CTF dict.  Dicts are scanned
+   by worker threads, and the partial symbols are added to the psymtab
+   afterwards, on the main thread.  */
+
+struct ctf_pending_psymbol
+{
+  /* The name, which points into the dict's string table.  */
+  const char *name;
+  bool copy_name;
+  domain_enum domain;
+  enum address_class aclass;
+  /* Whether the symbol is in the text section.  */
+  bool text_section;
+  psymbol_placement where;
+};
+
+/* An archive member and the partial symbols found in it.  */
+
+struct ctf_member_scan
+{
+  ctf_member_scan (ctf_dict_t *fp_, const char *name_)
+    : fp (fp_), name (name_)
+  {
+  }
+
+  ctf_dict_t *fp;
+  const char *name;
+  std::vector<ctf_pending_psymbol> psymbols;
+
+  /* Record a partial symbol.  */
+  void add_psymbol (const char *sym_name, bool copy, domain_enum domain,
+		    enum address_class aclass, bool text,
+		    psymbol_placement where)
+  {
+    psymbols.push_back ({sym_name, copy, domain, aclass, text, where});
+  }
+};
+
 /* Local function prototypes */
 
 static int ctf_add_type_cb (ctf_id_t tid, void *arg);
@@ -471,7 +511,7 @@ new_symbol (struct ctf_context *ccp, struct type *type, ctf_id_t tid)
   struct symbol *sym = nullptr;
 
   const char *name = ctf_type_name_raw (fp, tid);
-  if (name != nullptr)
+  if (name != nullptr && *name != '\0')
     {
       sym = new (&objfile->objfile_obstack) symbol;
       OBJSTAT (objfile, n_syms++);
@@ -1125,6 +1165,28 @@ ctf_add_type_cb (ctf_id_t tid, void *arg)
   return 0;
 }
 
+/* Callback to add type TID to the symbol table when a psymtab is
+   expanded.  Only the types that have a name, and so a symbol, are
+   converted here; the others, such as pointer, array and
+   cv-qualified types, are converted when a type or a symbol refers
+   to them, by fetch_tid_type.  Anonymous enums are converted too,
+   since their enumerators are symbols.  */
+
+static int
+ctf_add_named_type_cb (ctf_id_t tid, void *arg)
+{
+  struct ctf_context *ccp = (struct ctf_context *) arg;
+
+  if (ctf_type_kind (ccp->fp, tid) != CTF_K_ENUM)
+    {
+      const char *name = ctf_type_name_raw (ccp->fp, tid);
+      if (name == nullptr || *name == '\0')
+	return 0;
+    }
+
+  return ctf_add_type_cb (tid, arg);
+}
+
 /* Callback to add variable NAME with TID to the symbol table.  */
 
 static int
@@ -1135,7 +1197,7 @@ ctf_add_var_cb (const char *name, ctf_id_t id, void *arg)
   struct type *type;
   uint32_t kind;
 
-  type = get_tid_type (ccp->of, id);
+  type = fetch_tid_type (ccp, id);
 
   kind = ctf_type_kind (ccp->fp, id);
   switch (kind)
@@ -1200,7 +1262,7 @@ add_stt_entries (struct ctf_context *ccp, int functions)
 
   while ((tid = ctf_symbol_next (ccp->fp, &i, &tname, functions)) != CTF_ERR)
     {
-      type = get_tid_type (ccp->of, tid);
+      type = fetch_tid_type (ccp, tid);
       if (type == nullptr)
 	continue;
       sym = new (&ccp->of->objfile_obstack) symbol;
@@ -1275,35 +1337,31 @@ ctf_end_compunit_symtab (ctf_psymtab *pst,
   return result;
 }
 
-/* Add all members of an enum with type TID to partial symbol table.  */
+/* Add all members of an enum with type TID to the partial symbols of
+   SCAN.  */
 
 static void
-ctf_psymtab_add_enums (struct ctf_context *ccp, ctf_id_t tid)
+ctf_psymtab_add_enums (ctf_member_scan *scan, ctf_id_t tid)
 {
   int val;
   const char *ename;
   ctf_next_t *i = nullptr;
 
-  while ((ename = ctf_enum_next (ccp->fp, tid, &i, &val)) != nullptr)
-    {
-      ccp->pst->add_psymbol (ename, true,
-			     VAR_DOMAIN, LOC_CONST, -1,
-			     psymbol_placement::GLOBAL,
-			     unrelocated_addr (0),
-			     language_c, ccp->partial_symtabs, ccp->of);
-    }
-  if (ctf_errno (ccp->fp) != ECTF_NEXT_END)
+  while ((ename = ctf_enum_next (scan->fp, tid, &i, &val)) != nullptr)
+    scan->add_psymbol (ename, true, VAR_DOMAIN, LOC_CONST, false,
+		       psymbol_placement::GLOBAL);
+  if (ctf_errno (scan->fp) != ECTF_NEXT_END)
     complaint (_("ctf_enum_next ctf_psymtab_add_enums failed - %s"),
-	       ctf_errmsg (ctf_errno (ccp->fp)));
+	       ctf_errmsg (ctf_errno (scan->fp)));
 }
 
 /* Add entries in either data objects or function info section, controlled
-   by FUNCTIONS, to psymtab.  */
+   by FUNCTIONS, to the partial symbols of SCAN.  */
 
 static void
-ctf_psymtab_add_stt_entries (ctf_dict_t *cfp, ctf_psymtab *pst,
-			     struct objfile *of, int functions)
+ctf_psymtab_add_stt_entries (ctf_member_scan *scan, int functions)
 {
+  ctf_dict_t *cfp = scan->fp;
   ctf_next_t *i = nullptr;
   ctf_id_t tid;
   const char *tname;
@@ -1332,30 +1390,27 @@ ctf_psymtab_add_stt_entries (ctf_dict_t *cfp, ctf_psymtab *pst,
       else
 	aclass = LOC_TYPEDEF;
 
-      pst->add_psymbol (tname, true,
-			tdomain, aclass, -1,
-			psymbol_placement::GLOBAL,
-			unrelocated_addr (0),
-			language_c, pst->context.partial_symtabs, of);
+      scan->add_psymbol (tname, true, tdomain, aclass, false,
+			 psymbol_placement::GLOBAL);
     }
 }
 
-/* Add entries in data objects section to psymtab.  */
+/* Add entries in data objects section to the partial symbols of
+   SCAN.  */
 
 static void
-ctf_psymtab_add_stt_obj (ctf_dict_t *cfp, ctf_psymtab *pst,
-			 struct objfile *of)
+ctf_psymtab_add_stt_obj (ctf_member_scan *scan)
 {
-  ctf_psymtab_add_stt_entries (cfp, pst, of, 0);
+  ctf_psymtab_add_stt_entries (scan, 0);
 }
 
-/* Add entries in function info section to psymtab.  */
+/* Add entries in function info section to the partial symbols of
+   SCAN.  */
 
 static void
-ctf_psymtab_add_stt_func (ctf_dict_t *cfp, ctf_psymtab *pst,
-			  struct objfile *of)
+ctf_psymtab_add_stt_func (ctf_member_scan *scan)
 {
-  ctf_psymtab_add_stt_entries (cfp, pst, of, 1);
+  ctf_psymtab_add_stt_entries (scan, 1);
 }
 
 /* Read in full symbols for PST, and anything it depends on.  */
@@ -1370,7 +1425,7 @@ ctf_psymtab::expand_psymtab (struct objfile *objfile)
   ccp = &context;
 
   /* Iterate over entries in data types section.  */
-  if (ctf_type_iter (ccp->fp, ctf_add_type_cb, ccp) == CTF_ERR)
+  if (ctf_type_iter (ccp->fp, ctf_add_named_type_cb, ccp) == CTF_ERR)
     complaint (_("ctf_type_iter psymtab_to_symtab failed - %s"),
 	       ctf_errmsg (ctf_errno (ccp->fp)));
 
@@ -1455,24 +1510,23 @@ create_partial_symtab (const char *name,
   return pst;
 }
 
-/* Callback to add type TID to partial symbol table.  */
+/* Callback to add type TID to the partial symbols of an archive
+   member.  */
 
 static int
 ctf_psymtab_type_cb (ctf_id_t tid, void *arg)
 {
-  struct ctf_context *ccp;
+  ctf_member_scan *scan = (ctf_member_scan *) arg;
   uint32_t kind;
-  short section = -1;
-
-  ccp = (struct ctf_context *) arg;
+  bool text_section = false;
 
   domain_enum domain = UNDEF_DOMAIN;
   enum address_class aclass = LOC_UNDEF;
-  kind = ctf_type_kind (ccp->fp, tid);
+  kind = ctf_type_kind (scan->fp, tid);
   switch (kind)
     {
       case CTF_K_ENUM:
-	ctf_psymtab_add_enums (ccp, tid);
+	ctf_psymtab_add_enums (scan, tid);
 	/* FALL THROUGH */
       case CTF_K_STRUCT:
       case CTF_K_UNION:
@@ -1483,7 +1537,7 @@ ctf_psymtab_type_cb (ctf_id_t tid, void *arg)
       case CTF_K_FORWARD:
 	domain = VAR_DOMAIN;
 	aclass = LOC_STATIC;
-	section = SECT_OFF_TEXT (ccp->of);
+	text_section = true;
 	break;
       case CTF_K_CONST:
 	domain = VAR_DOMAIN;
@@ -1506,100 +1560,106 @@ ctf_psymtab_type_cb (ctf_id_t tid, void *arg)
 	return 0;
     }
 
-  const char *name = ctf_type_name_raw (ccp->fp, tid);
+  const char *name = ctf_type_name_raw (scan->fp, tid);
   if (name == nullptr || strlen (name) == 0)
     return 0;
 
-  ccp->pst->add_psymbol (name, false,
-			 domain, aclass, section,
-			 psymbol_placement::STATIC,
-			 unrelocated_addr (0),
-			 language_c, ccp->partial_symtabs, ccp->of);
+  scan->add_psymbol (name, false, domain, aclass, text_section,
+		     psymbol_placement::STATIC);
 
   return 0;
 }
 
-/* Callback to add variable NAME with ID to partial symbol table.  */
+/* Callback to add variable NAME with ID to the partial symbols of an
+   archive member.  */
 
 static int
 ctf_psymtab_var_cb (const char *name, ctf_id_t id, void *arg)
 {
-  struct ctf_context *ccp = (struct ctf_context *) arg;
+  ctf_member_scan *scan = (ctf_member_scan *) arg;
 
-  ccp->pst->add_psymbol (name, true,
-			 VAR_DOMAIN, LOC_STATIC, -1,
-			 psymbol_placement::GLOBAL,
-			 unrelocated_addr (0),
-			 language_c, ccp->partial_symtabs, ccp->of);
+  scan->add_psymbol (name, true, VAR_DOMAIN, LOC_STATIC, false,
+		     psymbol_placement::GLOBAL);
   return 0;
 }
 
-/* Setup partial_symtab's describing each source file for which
-   debugging information is available.  */
+/* Find the partial symbols of the archive member of SCAN.  This only
+   reads the member's dict, and is called from worker threads.  */
 
 static void
-scan_partial_symbols (ctf_dict_t *cfp, psymtab_storage *partial_symtabs,
-		      struct ctf_per_tu_data *tup, const char *fname)
+scan_partial_symbols (ctf_member_scan *scan)
 {
-  struct objfile *of = tup->of;
-  bool isparent = false;
-
-  if (strcmp (fname, ".ctf") == 0)
-    {
-      fname = bfd_get_filename (of->obfd.get ());
-      isparent = true;
-    }
-
-  ctf_psymtab *pst = create_partial_symtab (fname, tup->arc, cfp,
-					    partial_symtabs, of);
+  ctf_dict_t *cfp = scan->fp;
 
-  struct ctf_context *ccx = &pst->context;
-  if (isparent == false)
-    ccx->pst = pst;
-
-  if (ctf_type_iter (cfp, ctf_psymtab_type_cb, ccx) == CTF_ERR)
+  if (ctf_type_iter (cfp, ctf_psymtab_type_cb, scan) == CTF_ERR)
     complaint (_("ctf_type_iter scan_partial_symbols failed - %s"),
 	       ctf_errmsg (ctf_errno (cfp)));
 
-  if (ctf_variable_iter (cfp, ctf_psymtab_var_cb, ccx) == CTF_ERR)
+  if (ctf_variable_iter (cfp, ctf_psymtab_var_cb, scan) == CTF_ERR)
     complaint (_("ctf_variable_iter scan_partial_symbols failed - %s"),
 	       ctf_errmsg (ctf_errno (cfp)));
 
   /* Scan CTF object and function sections which correspond to each
      STT_FUNC or STT_OBJECT entry in the symbol table,
      pick up what init_symtab has done.  */
-  ctf_psymtab_add_stt_obj (cfp, pst, of);
-  ctf_psymtab_add_stt_func (cfp, pst, of);
-
-  pst->end ();
+  ctf_psymtab_add_stt_obj (scan);
+  ctf_psymtab_add_stt_func (scan);
 }
 
-/* Callback to build the psymtab for archive member NAME.  */
+/* Setup the partial_symtab describing the archive member of SCAN, a
+   source file for which debugging information is available.  */
 
-static int
-build_ctf_archive_member (ctf_dict_t *ctf, const char *name, void *arg)
+static void
+build_ctf_member_psymtab (const ctf_member_scan &scan,
+			  psymtab_storage *partial_symtabs,
+			  struct ctf_per_tu_data *tup)
 {
-  struct ctf_per_tu_data *tup = (struct ctf_per_tu_data *) arg;
-  ctf_dict_t *parent = tup->fp;
+  struct objfile *of = tup->of;
+  const char *fname = scan.name;
 
-  if (strcmp (name, ".ctf") != 0)
-    ctf_import (ctf, parent);
+  if (strcmp (fname, ".ctf") == 0)
+    fname = bfd_get_filename (of->obfd.get ());
 
   if (info_verbose)
     {
-      gdb_printf (_("Scanning archive member %s..."), name);
+      gdb_printf (_("Scanning archive member %s..."), scan.name);
       gdb_flush (gdb_stdout);
     }
 
-  psymtab_storage *pss = tup->psf->get_partial_symtabs ().get ();
-  scan_partial_symbols (ctf, pss, tup, name);
+  ctf_psymtab *pst = create_partial_symtab (fname, tup->arc, scan.fp,
+					    partial_symtabs, of);
+
+  for (const ctf_pending_psymbol &psym : scan.psymbols)
+    pst->add_psymbol (psym.name, psym.copy_name,
+		      psym.domain, psym.aclass,
+		      psym.text_section ? SECT_OFF_TEXT (of) : -1,
+		      psym.where,
+		      unrelocated_addr (0),
+		      language_c, partial_symtabs, of);
+
+  pst->end ();
+}
+
+/* Callback to record archive member NAME, to be scanned later.  */
+
+static int
+build_ctf_archive_member (ctf_dict_t *ctf, const char *name, void *arg)
+{
+  std::vector<ctf_member_scan> *members
+    = (std::vector<ctf_member_scan> *) arg;
 
+  /* The member is closed when this returns, but the archive keeps it
+     open in its cache.  */
+  members->emplace_back (ctf, name);
   return 0;
 }
 
 /* Read CTF debugging information from a BFD section.  This is
    called from elfread.c.  It does a quick pass through the
-   .ctf section to set up the partial symbol table.  */
+   .ctf section to set up the partial symbol table.
+
+   The archive members are scanned in parallel, by worker threads,
+   and a psymtab is then created for each of them, in order.  */
 
 void
 elfctf_build_psymtabs (struct objfile *of)
@@ -1627,9 +1687,34 @@ elfctf_build_psymtabs (struct objfile *of)
   of->qf.emplace_front (psf);
   pcu.psf = psf;
 
-  if (ctf_archive_iter (arc, build_ctf_archive_member, &pcu) < 0)
+  std::vector<ctf_member_scan> members;
+  if (ctf_archive_iter (arc, build_ctf_archive_member, &members) < 0)
     error (_("ctf_archive_iter failed in input file %s: - %s"),
 	   bfd_get_filename (abfd), ctf_errmsg (err));
+
+  /* Importing the parent modifies it, so do it before any member is
+     scanned.  */
+  for (ctf_member_scan &member : members)
+    if (strcmp (member.name, ".ctf") != 0)
+      ctf_import (member.fp, fp);
+
+  {
+    /* Ensure that complaints are handled correctly.  */
+    complaint_interceptor complaint_handler;
+
+    using iter_type = std::vector<ctf_member_scan>::iterator;
+    gdb::parallel_for_each (1, members.begin (), members.end (),
+			    [] (iter_type iter, iter_type end)
+      {
+	scoped_trace_event trace ("ctf", "scan CTF archive members");
+	for (; iter != end; ++iter)
+	  scan_partial_symbols (&*iter);
+      });
+  }
+
+  psymtab_storage *pss = psf->get_partial_symtabs ().get ();
+  for (const ctf_member_scan &member : members)
+    build_ctf_member_psymtab (member, pss, &pcu);
 }
 
 #else
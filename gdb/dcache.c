@@ -25,6 +25,8 @@
 #include "inferior.h"
 #include "splay-tree.h"
 #include "gdbarch.h"
+#include "gdbsupport/byte-vector.h"
+#include "perf-counters.h"
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -51,6 +53,14 @@ static struct cmd_list_element *dcache_show_list = NULL;
    Lines are only allocated as needed, so DCACHE_SIZE really specifies the
    *maximum* number of lines in the cache.
 
+   When a miss is for the line just after the last lines that were
+   fetched, the accesses are probably sequential (a backtrace, printing
+   a string, a "find" over a range of memory), and the lines following
+   the missed one are fetched along with it, in a single target
+   request.  The number of lines read ahead doubles with each
+   sequential miss, up to DCACHE_READAHEAD, and drops back to zero on
+   a miss elsewhere, so random accesses still fetch a line at a time.
+
    At present, the cache is write-through rather than writeback: as soon
    as data is written to the cache, it is also immediately written to
    the target.  Therefore, cache lines are never "dirty".  Whether a given
@@ -83,6 +93,12 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* The maximum number of lines to read ahead of a sequential miss.  The
+   default, with the default line size, allows fetching 4KiB at a
+   time.  Zero disables readahead.  */
+#define DCACHE_DEFAULT_READAHEAD 63
+static unsigned dcache_readahead = DCACHE_DEFAULT_READAHEAD;
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -98,6 +114,7 @@ struct dcache_block
 
   CORE_ADDR addr;		/* address of data */
   int refs;			/* # hits */
+  bool readahead;		/* read ahead of a miss, not yet hit */
   gdb_byte data[1];		/* line_size bytes at given address */
 };
 
@@ -120,6 +137,22 @@ struct dcache_struct
   /* The process target of last inferior to use the cache or
      nullptr.  */
   process_stratum_target *proc_target;
+
+  /* The address just after the last lines fetched from the target.
+     A miss at this address is considered sequential.  */
+  CORE_ADDR next_line;
+
+  /* The number of lines to read ahead on the next sequential miss.  */
+  unsigned readahead;
+
+  /* Statistics, since the cache was created.  These are not reset
+     when the cache is invalidated.  */
+  ULONGEST hits;		/* byte reads found in the cache */
+  ULONGEST misses;		/* byte reads that fetched a line */
+  ULONGEST reads;		/* target read requests */
+  ULONGEST lines_read;		/* lines fetched, including readahead */
+  ULONGEST readahead_lines;	/* lines fetched by readahead */
+  ULONGEST readahead_hits;	/* readahead lines that were then used */
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
@@ -254,6 +287,8 @@ dcache_invalidate (DCACHE *dcache)
   dcache->size = 0;
   dcache->ptid = null_ptid;
   dcache->proc_target = nullptr;
+  dcache->next_line = 0;
+  dcache->readahead = 0;
 
   if (dcache->line_size != dcache_line_size)
     {
@@ -381,6 +416,7 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 
   db->addr = MASK (dcache, addr);
   db->refs = 0;
+  db->readahead = false;
 
   /* Put DB at the end of the list, it's the newest.  */
   append_block (&dcache->oldest, db);
@@ -391,6 +427,122 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
   return db;
 }
 
+/* Return the number of lines after the line at ADDR, which has just
+   missed, that should be fetched along with it, and update the
+   sequential access detection state.  */
+
+static unsigned
+dcache_readahead_lines (DCACHE *dcache, CORE_ADDR addr)
+{
+  if (addr != dcache->next_line)
+    {
+      /* Not a sequential access.  */
+      dcache->readahead = 0;
+      return 0;
+    }
+
+  /* Don't let readahead evict much of the cache.  */
+  unsigned limit = std::min (dcache_readahead, dcache_size / 4);
+
+  if (dcache->readahead == 0)
+    dcache->readahead = 1;
+  else
+    dcache->readahead *= 2;
+  dcache->readahead = std::min (dcache->readahead, limit);
+
+  /* Only read ahead within the memory region of ADDR, and stop at the
+     first line that is already cached.  */
+  struct mem_region *region = lookup_mem_region (addr);
+  if (region->attrib.mode == MEM_WO)
+    return 0;
+
+  unsigned count;
+  for (count = 0; count < dcache->readahead; ++count)
+    {
+      CORE_ADDR line = addr + (count + 1) * dcache->line_size;
+      CORE_ADDR line_end = line + dcache->line_size;
+
+      /* Check for wrapping around the end of the address space.  */
+      if (line_end <= addr)
+	break;
+      if (region->hi != 0 && line_end > region->hi)
+	break;
+      if (splay_tree_lookup (dcache->tree, (splay_tree_key) line) != nullptr)
+	break;
+    }
+
+  return count;
+}
+
+/* Counters for all the data caches, for "maint info perf-counters".  */
+
+static perf_counter dcache_hits_counter
+  ("dcache.hits", N_("Byte reads found in a data cache."));
+static perf_counter dcache_misses_counter
+  ("dcache.misses", N_("Byte reads that missed a data cache."));
+static perf_counter dcache_reads_counter
+  ("dcache.target-reads", N_("Target reads made to fill a data cache."));
+static perf_counter dcache_readahead_hits_counter
+  ("dcache.readahead-hits", N_("Data cache lines read ahead, then used."));
+
+/* Fetch the line containing ADDR, which is not in DCACHE, from the
+   target, along with any lines to read ahead.  Return the block for
+   ADDR, or NULL if it could not be read; in that case the block is
+   still in the cache, and must be invalidated by the caller.  */
+
+static struct dcache_block *
+dcache_fill (DCACHE *dcache, CORE_ADDR addr)
+{
+  CORE_ADDR line = MASK (dcache, addr);
+  unsigned count = dcache_readahead_lines (dcache, line);
+
+  if (count > 0)
+    {
+      size_t len = (count + 1) * dcache->line_size;
+      gdb::byte_vector buf (len);
+
+      ++dcache->reads;
+      ++dcache_reads_counter;
+      if (target_read_raw_memory (line, buf.data (), len) == 0)
+	{
+	  struct dcache_block *first = nullptr;
+
+	  for (unsigned i = 0; i <= count; ++i)
+	    {
+	      struct dcache_block *db
+		= dcache_alloc (dcache, line + i * dcache->line_size);
+
+	      memcpy (db->data, buf.data () + i * dcache->line_size,
+		      dcache->line_size);
+	      if (i == 0)
+		first = db;
+	      else
+		db->readahead = true;
+	    }
+
+	  dcache->lines_read += count + 1;
+	  dcache->readahead_lines += count;
+	  dcache->next_line = line + len;
+	  return first;
+	}
+
+      /* Reading ahead failed, perhaps because it went past the end of
+	 the readable memory.  Fall back to reading just the line that
+	 was asked for.  */
+      dcache->readahead = 0;
+    }
+
+  struct dcache_block *db = dcache_alloc (dcache, line);
+
+  ++dcache->reads;
+  ++dcache_reads_counter;
+  ++dcache->lines_read;
+  dcache->next_line = line + dcache->line_size;
+  if (!dcache_read_line (dcache, db))
+    return nullptr;
+  return db;
+}
+
 /* Using the data cache DCACHE, store in *PTR the contents of the byte at
    address ADDR in the remote machine.  
 
@@ -401,11 +553,23 @@ dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
 {
   struct dcache_block *db = dcache_hit (dcache, addr);
 
-  if (!db)
+  if (db != nullptr)
     {
-      db = dcache_alloc (dcache, addr);
-
-      if (!dcache_read_line (dcache, db))
+      ++dcache->hits;
+      ++dcache_hits_counter;
+      if (db->readahead)
+	{
+	  ++dcache->readahead_hits;
+	  ++dcache_readahead_hits_counter;
+	  db->readahead = false;
+	}
+    }
+  else
+    {
+      ++dcache->misses;
+      ++dcache_misses_counter;
+      db = dcache_fill (dcache, addr);
+      if (db == nullptr)
 	 return 0;
     }
 
@@ -459,6 +623,14 @@ dcache_init (void)
   dcache->line_size = dcache_line_size;
   dcache->ptid = null_ptid;
   dcache->proc_target = nullptr;
+  dcache->next_line = 0;
+  dcache->readahead = 0;
+  dcache->hits = 0;
+  dcache->misses = 0;
+  dcache->reads = 0;
+  dcache->lines_read = 0;
+  dcache->readahead_lines = 0;
+  dcache->readahead_hits = 0;
 
   return dcache;
 }
@@ -652,6 +824,53 @@ info_dcache_command (const char *exp, int tty)
   dcache_info_1 (target_dcache_get (), exp);
 }
 
+/* Print a statistic for "maint info dcache": NAME, VALUE, and, if
+   TOTAL is not zero, VALUE as a percentage of TOTAL.  */
+
+static void
+print_dcache_statistic (const char *name, ULONGEST value, ULONGEST total)
+{
+  if (total != 0)
+    gdb_printf ("  %-28s %s (%d%%)\n", name, pulongest (value),
+		(int) (value * 100.0 / total));
+  else
+    gdb_printf ("  %-28s %s\n", name, pulongest (value));
+}
+
+/* Implement the "maint info dcache" command.  */
+
+static void
+maint_info_dcache_command (const char *args, int from_tty)
+{
+  DCACHE *dcache = target_dcache_get ();
+
+  gdb_printf (_("Dcache %u lines of %u bytes each, "
+		"reading ahead up to %u lines.\n"),
+	      dcache_size,
+	      dcache ? (unsigned) dcache->line_size : dcache_line_size,
+	      dcache_readahead);
+
+  if (dcache == NULL)
+    {
+      gdb_printf (_("No data cache available.\n"));
+      return;
+    }
+
+  ULONGEST lookups = dcache->hits + dcache->misses;
+
+  gdb_printf (_("Statistics:\n"));
+  print_dcache_statistic (_("Byte reads:"), lookups, 0);
+  print_dcache_statistic (_("Hits:"), dcache->hits, lookups);
+  print_dcache_statistic (_("Misses:"), dcache->misses, lookups);
+  print_dcache_statistic (_("Target reads:"), dcache->reads, 0);
+  print_dcache_statistic (_("Lines read:"), dcache->lines_read, 0);
+  print_dcache_statistic (_("Lines read ahead:"), dcache->readahead_lines,
+			  dcache->lines_read);
+  print_dcache_statistic (_("Lines read ahead and used:"),
+			  dcache->readahead_hits, dcache->readahead_lines);
+  gdb_printf (_("Current readahead: %u lines\n"), dcache->readahead);
+}
+
 static void
 set_dcache_size (const char *args, int from_tty,
 		 struct cmd_list_element *c)
@@ -702,6 +921,14 @@ With no arguments, this command prints the cache configuration and a\n\
 summary of each line in the cache.  With an argument, dump\"\n\
 the contents of the given line."));
 
+  add_cmd ("dcache", class_maintenance, maint_info_dcache_command,
+	   _("\
+Print statistics about the dcache.\n\
+Usage: maint info dcache\n\
+This shows how many reads were served from the dcache, how many\n\
+target requests it made, and how well reading ahead is working."),
+	   &maintenanceinfolist);
+
   add_setshow_prefix_cmd ("dcache", class_obscure,
 			  _("\
 Use this command to set number of lines in dcache and line-size."),
@@ -717,6 +944,17 @@ Show dcache line size."),
 			     set_dcache_line_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+  add_setshow_zuinteger_cmd ("readahead", class_obscure,
+			     &dcache_readahead, _("\
+Set the maximum number of dcache lines to read ahead."), _("\
+Show the maximum number of dcache lines to read ahead."), _("\
+When memory is read sequentially through the dcache, the lines that\n\
+follow a missed line are fetched from the target along with it, in\n\
+a single request.  The number of lines read ahead grows with each\n\
+sequential miss, up to this limit.  Zero disables reading ahead."),
+			     NULL,
+			     NULL,
+			     &dcache_set_list, &dcache_show_list);
   add_setshow_zuinteger_cmd ("size", class_obscure,
 			     &dcache_size, _("\
 Set number of dcache lines."), _("\
@@ -26,6 +26,14 @@
 #include "cli/cli-style.h"
 #include "cli-out.h"
 #include "target.h"
+#include "gdbsupport/block-signals.h"
+#include "trace-events.h"
+#if CXX_STD_THREAD
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 /* Set/show debuginfod commands.  */
 static cmd_list_element *set_debuginfod_prefix_list;
@@ -52,6 +60,10 @@ static const char *debuginfod_enabled =
 
 static unsigned int debuginfod_verbose = 1;
 
+/* The maximum number of debuginfod queries made at a time when
+   prefetching debug info, or 0 to not prefetch.  */
+static unsigned int debuginfod_prefetch = 8;
+
 #ifndef HAVE_LIBDEBUGINFOD
 scoped_fd
 debuginfod_source_query (const unsigned char *build_id,
@@ -80,6 +92,11 @@ debuginfod_exec_query (const unsigned char *build_id,
   return scoped_fd (-ENOSYS);
 }
 
+void
+debuginfod_prefetch_debuginfo (const std::vector<gdb::byte_vector> &build_ids)
+{
+}
+
 #define NO_IMPL _("Support for debuginfod is not compiled into GDB.")
 
 #else
@@ -311,6 +328,7 @@ debuginfod_source_query (const unsigned char *build_id,
 	target_terminal::ours ();
       }
 
+    scoped_trace_event trace ("debuginfod", "query source", srcpath);
     fd = scoped_fd (debuginfod_find_source (c,
 					    build_id,
 					    build_id_len,
@@ -357,6 +375,7 @@ debuginfod_debuginfo_query (const unsigned char *build_id,
 	target_terminal::ours ();
       }
 
+    scoped_trace_event trace ("debuginfod", "query debuginfo", filename);
     fd = scoped_fd (debuginfod_find_debuginfo (c, build_id, build_id_len,
 					       &dname));
     debuginfod_set_user_data (c, nullptr);
@@ -400,6 +419,7 @@ debuginfod_exec_query (const unsigned char *build_id,
 	target_terminal::ours ();
       }
 
+    scoped_trace_event trace ("debuginfod", "query executable", filename);
     fd = scoped_fd (debuginfod_find_executable (c, build_id, build_id_len,
 						&dname));
     debuginfod_set_user_data (c, nullptr);
@@ -412,6 +432,183 @@ debuginfod_exec_query (const unsigned char *build_id,
 
   return fd;
 }
+
+#if CXX_STD_THREAD
+
+/* The state shared by the threads prefetching debug info.  */
+
+struct prefetch_state
+{
+  explicit prefetch_state (const std::vector<gdb::byte_vector> &build_ids)
+    : build_ids (build_ids)
+  {
+  }
+
+  /* The build-ids to query.  */
+  const std::vector<gdb::byte_vector> &build_ids;
+
+  /* The index in BUILD_IDS of the next build-id to query.  */
+  std::atomic<size_t> next { 0 };
+
+  /* Set when the user interrupted the prefetch.  The queries in
+     progress are then cancelled, and no new ones are made.  */
+  std::atomic<bool> cancelled { false };
+
+  /* MUTEX protects the fields below.  DONE_CV is notified when one of
+     them changes.  */
+  std::mutex mutex;
+  std::condition_variable done_cv;
+
+  /* The number of queries done, and the number of threads still
+     running.  */
+  size_t done = 0;
+  size_t running = 0;
+};
+
+/* The progress function of the clients used for prefetching.  Progress
+   is reported by the thread waiting for the prefetch, so this only
+   cancels the query when the prefetch was interrupted.  */
+
+static int
+prefetch_progressfn (debuginfod_client *c, long cur, long total)
+{
+  prefetch_state *state
+    = static_cast<prefetch_state *> (debuginfod_get_user_data (c));
+
+  return state->cancelled ? 1 : 0;
+}
+
+/* The body of a prefetching thread.  Query the build-ids of STATE,
+   using a client of its own, until there are none left.  */
+
+static void
+prefetch_worker (prefetch_state *state)
+{
+  debuginfod_client *c = debuginfod_begin ();
+
+  if (c != nullptr)
+    {
+      debuginfod_set_user_data (c, state);
+      debuginfod_set_progressfn (c, prefetch_progressfn);
+    }
+
+  for (size_t i = state->next++;
+       i < state->build_ids.size () && !state->cancelled;
+       i = state->next++)
+    {
+      if (c != nullptr)
+	{
+	  const gdb::byte_vector &build_id = state->build_ids[i];
+	  char *dname = nullptr;
+	  scoped_trace_event trace ("debuginfod", "prefetch debuginfo");
+	  int fd = debuginfod_find_debuginfo (c, build_id.data (),
+					      build_id.size (), &dname);
+
+	  /* Only the copy in the cache is wanted.  */
+	  if (fd >= 0)
+	    {
+	      close (fd);
+	      free (dname);
+	    }
+	}
+
+      std::lock_guard<std::mutex> guard (state->mutex);
+      ++state->done;
+      state->done_cv.notify_one ();
+    }
+
+  if (c != nullptr)
+    debuginfod_end (c);
+
+  std::lock_guard<std::mutex> guard (state->mutex);
+  --state->running;
+  state->done_cv.notify_one ();
+}
+
+#endif /* CXX_STD_THREAD */
+
+/* See debuginfod-support.h  */
+
+void
+debuginfod_prefetch_debuginfo (const std::vector<gdb::byte_vector> &build_ids)
+{
+#if CXX_STD_THREAD
+  /* A single query gains nothing from being made ahead of time.  */
+  if (build_ids.size () < 2
+      || debuginfod_prefetch == 0
+      || !debuginfod_is_enabled ())
+    return;
+
+  prefetch_state state (build_ids);
+  size_t num_threads = std::min<size_t> (debuginfod_prefetch,
+					 build_ids.size ());
+  std::vector<std::thread> threads;
+
+  {
+    /* Ensure that signals used by gdb are blocked in the new
+       threads.  */
+    gdb::block_signals blocker;
+    std::lock_guard<std::mutex> guard (state.mutex);
+
+    for (size_t i = 0; i < num_threads; ++i)
+      {
+	try
+	  {
+	    threads.emplace_back (prefetch_worker, &state);
+	    ++state.running;
+	  }
+	catch (const std::system_error &)
+	  {
+	    /* Make do with the threads that could be started; the
+	       debug info of the rest is queried when it is needed.  */
+	    break;
+	  }
+      }
+  }
+
+  if (threads.empty ())
+    return;
+
+  gdb::optional<target_terminal::scoped_restore_terminal_state> term_state;
+  if (target_supports_terminal_ours ())
+    {
+      term_state.emplace ();
+      target_terminal::ours ();
+    }
+
+  {
+    gdb::optional<ui_out::progress_update> progress;
+    if (debuginfod_verbose > 0)
+      progress.emplace ();
+
+    std::string msg
+      = string_printf (_("Downloading separate debug info for %zu files"),
+		       build_ids.size ());
+
+    std::unique_lock<std::mutex> lock (state.mutex);
+    while (state.running > 0)
+      {
+	state.done_cv.wait_for (lock, std::chrono::milliseconds (100));
+
+	if (!state.cancelled && check_quit_flag ())
+	  {
+	    gdb_printf (_("Cancelling download of separate debug info "
+			  "for %zu files...\n"),
+			build_ids.size () - state.done);
+	    state.cancelled = true;
+	  }
+
+	if (progress.has_value ())
+	  progress->update_progress (msg, "files",
+				     (double) state.done / build_ids.size (),
+				     build_ids.size ());
+      }
+  }
+
+  for (std::thread &thread : threads)
+    thread.join ();
+#endif /* CXX_STD_THREAD */
+}
 #endif
 
 /* Set callback for "set debuginfod enabled".  */
@@ -501,6 +698,15 @@ show_debuginfod_verbose_command (ui_file *file, int from_tty,
 	      value);
 }
 
+/* Show callback for "set debuginfod prefetch".  */
+
+static void
+show_debuginfod_prefetch_command (ui_file *file, int from_tty,
+				  cmd_list_element *cmd, const char *value)
+{
+  gdb_printf (file, _("Debuginfod prefetch is set to %s.\n"), value);
+}
+
 /* Register debuginfod commands.  */
 
 void _initialize_debuginfod ();
@@ -551,4 +757,18 @@ query.\nTo disable, set to zero.  Verbose output is displayed by default."),
 			     show_debuginfod_verbose_command,
 			     &set_debuginfod_prefix_list,
 			     &show_debuginfod_prefix_list);
+
+  /* set/show debuginfod prefetch */
+  add_setshow_zuinteger_cmd ("prefetch", class_support,
+			     &debuginfod_prefetch, _("\
+Set the number of concurrent debuginfod queries when prefetching."), _("\
+Show the number of concurrent debuginfod queries when prefetching."), _("\
+When shared libraries are loaded, GDB queries debuginfod for the separate\n\
+debug info of all of them at once, making up to this many queries at a\n\
+time, rather than querying for each library in turn as its symbols are\n\
+read.  To disable prefetching, set to zero."),
+			     nullptr,
+			     show_debuginfod_prefetch_command,
+			     &set_debuginfod_prefix_list,
+			     &show_debuginfod_prefix_list);
 }
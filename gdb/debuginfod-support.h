@@ -20,6 +20,7 @@
 #define DEBUGINFOD_SUPPORT_H
 
 #include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/byte-vector.h"
 
 /* Query debuginfod servers for a source file associated with an
    executable with BUILD_ID.  BUILD_ID can be given as a binary blob or
@@ -81,4 +82,17 @@ extern scoped_fd debuginfod_exec_query (const unsigned char *build_id,
 					const char *filename,
 					gdb::unique_xmalloc_ptr<char>
 					  *destname);
+
+/* Query debuginfod servers for the debug info files with the build-ids
+   in BUILD_IDS, each given as a binary blob, making up to "set
+   debuginfod prefetch" queries at a time.  The files are downloaded
+   into the debuginfod client cache, where a later
+   debuginfod_debuginfo_query for one of the build-ids finds it without
+   contacting the servers.  Return when all the queries are done or
+   the user interrupted them.  This does nothing if debuginfod is not
+   enabled or GDB is not built with debuginfod.  */
+
+extern void debuginfod_prefetch_debuginfo
+  (const std::vector<gdb::byte_vector> &build_ids);
+
 #endif /* DEBUGINFOD_SUPPORT_H */
@@ -34,6 +34,8 @@
 #include <chrono>
 #include <unordered_set>
 #include "cli/cli-cmds.h"
+#include "perf-counters.h"
+#include "trace-events.h"
 
 /* We don't want gdb to exit while it is in the process of writing to
    the index cache.  So, all live cooked index vectors are stored
@@ -249,12 +251,12 @@ cooked_index_shard::add (sect_offset die_offset, enum dwarf_tag tag,
 /* See cooked-index.h.  */
 
 void
-cooked_index_shard::finalize ()
+cooked_index_shard::finalize (const gdb::cancellation_token &token)
 {
   m_future = gdb::thread_pool::g_thread_pool->post_task ([this] ()
     {
       do_finalize ();
-    });
+    }, gdb::task_priority::background, token);
 }
 
 /* See cooked-index.h.  */
@@ -304,6 +306,8 @@ cooked_index_shard::handle_gnat_encoded_entry (cooked_index_entry *entry,
 void
 cooked_index_shard::do_finalize ()
 {
+  scoped_trace_event trace ("dwarf2", "finalize index shard");
+
   auto hash_name_ptr = [] (const void *p)
     {
       const cooked_index_entry *entry = (const cooked_index_entry *) p;
@@ -447,7 +451,7 @@ cooked_index::cooked_index (vec_type &&vec)
   : m_vector (std::move (vec))
 {
   for (auto &idx : m_vector)
-    idx->finalize ();
+    idx->finalize (m_cancel);
 
   /* ACTIVE_VECTORS is not locked, and this assert ensures that this
      will be caught if ever moved to the background.  */
@@ -474,11 +478,14 @@ cooked_index::start_writing_index (dwarf2_per_bfd *per_bfd)
 						   ] ()
 	{
 	  maybe_write_index (per_bfd, ctx);
-	});
+	}, gdb::task_priority::background, m_cancel);
 }
 
 cooked_index::~cooked_index ()
 {
+  /* Don't start any work that is still pending.  */
+  m_cancel.cancel ();
+
   /* The 'finalize' method may be run in a different thread.  If
      this object is destroyed before this completes, then the method
      will end up writing to freed memory.  Waiting for this to
@@ -524,11 +531,19 @@ cooked_index::get_addrmaps () const
   return result;
 }
 
+/* The number of name lookups in the cooked indexes, for "maint info
+   perf-counters".  */
+
+static perf_counter cooked_index_lookups_counter
+  ("cooked-index.lookups", N_("Name lookups in the DWARF indexes."));
+
 /* See cooked-index.h.  */
 
 cooked_index::range
 cooked_index::find (const std::string &name, bool completing) const
 {
+  ++cooked_index_lookups_counter;
+
   std::vector<cooked_index_shard::range> result_range;
   result_range.reserve (m_vector.size ());
   for (auto &entry : m_vector)
@@ -645,7 +660,13 @@ cooked_index::maybe_write_index (dwarf2_per_bfd *per_bfd,
   /* Wait for finalization.  */
   wait ();
 
+  /* If this index is being destroyed, some shards may not have been
+     finalized.  */
+  if (m_cancel.cancelled ())
+    return;
+
   /* (maybe) store an index in the cache.  */
+  scoped_trace_event trace ("dwarf2", "write index cache");
   global_index_cache.store (per_bfd, ctx);
 }
 
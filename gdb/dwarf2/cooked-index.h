@@ -271,8 +271,9 @@ class cooked_index_shard
 
   /* Finalize the index.  This should be called a single time, when
      the index has been fully populated.  It enters all the entries
-     into the internal table.  */
-  void finalize ();
+     into the internal table.  This is done in the background; it is
+     skipped if TOKEN is cancelled before it starts.  */
+  void finalize (const gdb::cancellation_token &token);
 
   /* Wait for this index's finalization to be complete.  */
   void wait (bool allow_quit = true) const;
@@ -430,6 +431,11 @@ class cooked_index : public dwarf_scanner_base
     m_write_future.wait ();
   }
 
+  void cancel_background_work () override
+  {
+    m_cancel.cancel ();
+  }
+
   /* Start writing to the index cache, if the user asked for this.  */
   void start_writing_index (dwarf2_per_bfd *per_bfd);
 
@@ -445,6 +451,10 @@ class cooked_index : public dwarf_scanner_base
 
   /* A future that tracks when the 'index_write' method is done.  */
   gdb::future<void> m_write_future;
+
+  /* Cancels the finalization of the shards and the writing of the
+     index, when this object is going away.  */
+  gdb::cancellation_token m_cancel;
 };
 
 #endif /* GDB_DWARF2_COOKED_INDEX_H */
@@ -26,6 +26,7 @@
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/filestuff.h"
 #include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/parallel-for.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/scoped_fd.h"
 #include "complaints.h"
@@ -38,6 +39,8 @@
 #include "objfiles.h"
 #include "ada-lang.h"
 #include "dwarf2/tag.h"
+#include "run-on-main-thread.h"
+#include "trace-events.h"
 
 #include <algorithm>
 #include <cmath>
@@ -68,6 +71,23 @@
     GDB_INDEX_CU_SET_VALUE((cu_index), (value)); \
   } while (0)
 
+/* Call CALLBACK on subranges of the elements from FIRST to LAST, like
+   gdb::parallel_for_each does.  Indexes are also written to the index
+   cache by a task of the thread pool, which must not wait for other
+   tasks, so the work is only spread over the worker threads when
+   called from the main thread.  */
+
+template<class RandomIt, class RangeFunction>
+static auto
+index_for_each (unsigned n, RandomIt first, RandomIt last,
+		RangeFunction callback)
+  -> decltype (gdb::parallel_for_each (n, first, last, callback))
+{
+  if (is_main_thread ())
+    return gdb::parallel_for_each (n, first, last, callback);
+  return gdb::sequential_for_each (n, first, last, callback);
+}
+
 /* The "save gdb-index" command.  */
 
 /* Write SIZE bytes from the buffer pointed to by DATA to FILE, with
@@ -171,6 +191,8 @@ struct symtab_index_entry
 {
   /* The name of the symbol.  */
   const char *name;
+  /* The hash of NAME, as computed by mapped_index_string_hash.  */
+  offset_type hash;
   /* The offset of the name in the constant pool.  */
   offset_type index_offset;
   /* A sorted vector of the indices of all the CUs that hold an object
@@ -193,8 +215,13 @@ struct mapped_symtab
   /* Minimize each entry in the symbol table, removing duplicates.  */
   void minimize ()
   {
-    for (symtab_index_entry &item : data)
-      item.minimize ();
+    using iter_type = std::vector<symtab_index_entry>::iterator;
+    index_for_each (1000, data.begin (), data.end (),
+		    [] (iter_type iter, iter_type end)
+      {
+	for (; iter != end; ++iter)
+	  iter->minimize ();
+      });
   }
 
   offset_type n_elements = 0;
@@ -202,18 +229,22 @@ struct mapped_symtab
 
   /* Temporary storage for names.  */
   auto_obstack m_string_obstack;
+
+  /* Temporary storage for the names computed by the worker
+     threads.  */
+  std::vector<std::unique_ptr<auto_obstack>> m_name_storage;
 };
 
-/* Find a slot in SYMTAB for the symbol NAME.  Returns a reference to
-   the slot.
+/* Find a slot in SYMTAB for the symbol NAME, whose hash is HASH.
+   Returns a reference to the slot.
 
    Function is used only during write_hash_table so no index format backward
    compatibility is needed.  */
 
 static symtab_index_entry &
-find_slot (struct mapped_symtab *symtab, const char *name)
+find_slot (struct mapped_symtab *symtab, const char *name, offset_type hash)
 {
-  offset_type index, step, hash = mapped_index_string_hash (INT_MAX, name);
+  offset_type index, step;
 
   index = hash & (symtab->data.size () - 1);
   step = ((hash * 17) & (symtab->data.size () - 1)) | 1;
@@ -240,18 +271,19 @@ hash_expand (struct mapped_symtab *symtab)
   for (auto &it : old_entries)
     if (it.name != NULL)
       {
-	auto &ref = find_slot (symtab, it.name);
+	auto &ref = find_slot (symtab, it.name, it.hash);
 	ref = std::move (it);
       }
 }
 
-/* Add an entry to SYMTAB.  NAME is the name of the symbol.
-   CU_INDEX is the index of the CU in which the symbol appears.
-   IS_STATIC is one if the symbol is static, otherwise zero (global).  */
+/* Add an entry to SYMTAB.  NAME is the name of the symbol, and HASH
+   its hash as computed by mapped_index_string_hash.  CU_INDEX is the
+   index of the CU in which the symbol appears.  IS_STATIC is one if
+   the symbol is static, otherwise zero (global).  */
 
 static void
 add_index_entry (struct mapped_symtab *symtab, const char *name,
-		 int is_static, gdb_index_symbol_kind kind,
+		 offset_type hash, int is_static, gdb_index_symbol_kind kind,
 		 offset_type cu_index)
 {
   offset_type cu_index_and_attrs;
@@ -260,10 +292,11 @@ add_index_entry (struct mapped_symtab *symtab, const char *name,
   if (4 * symtab->n_elements / 3 >= symtab->data.size ())
     hash_expand (symtab);
 
-  symtab_index_entry &slot = find_slot (symtab, name);
+  symtab_index_entry &slot = find_slot (symtab, name, hash);
   if (slot.name == NULL)
     {
       slot.name = name;
+      slot.hash = hash;
       /* index_offset is set later.  */
     }
 
@@ -545,12 +578,11 @@ class debug_names
   /* Is this symbol from DW_TAG_compile_unit or DW_TAG_type_unit?  */
   enum class unit_kind { cu, tu };
 
-  /* Insert one symbol.  */
-  void insert (const cooked_index_entry *entry)
+  /* Insert one symbol.  NAME is the full name of ENTRY.  */
+  void insert (const cooked_index_entry *entry, const char *name)
   {
     const auto it = m_cu_index_htab.find (entry->per_cu);
     gdb_assert (it != m_cu_index_htab.cend ());
-    const char *name = entry->full_name (&m_string_obstack);
 
     /* This is incorrect but it mirrors gdb's historical behavior; and
        because the current .debug_names generation is also incorrect,
@@ -630,20 +662,31 @@ class debug_names
       uint32_t hash;
       decltype (m_name_to_value_set)::const_iterator it;
     };
-    std::vector<std::forward_list<hash_it_pair>> bucket_hash;
-    bucket_hash.resize (m_bucket_table.size ());
+
+    /* The names are hashed by the worker threads.  */
+    std::vector<hash_it_pair> hashes;
+    hashes.reserve (name_count);
     for (decltype (m_name_to_value_set)::const_iterator it
 	   = m_name_to_value_set.cbegin ();
 	 it != m_name_to_value_set.cend ();
 	 ++it)
+      hashes.push_back ({ 0, it });
+
+    using iter_type = std::vector<hash_it_pair>::iterator;
+    index_for_each (1000, hashes.begin (), hashes.end (),
+		    [] (iter_type iter, iter_type end)
       {
-	const char *const name = it->first.c_str ();
-	const uint32_t hash = dwarf5_djb_hash (name);
-	hash_it_pair hashitpair;
-	hashitpair.hash = hash;
-	hashitpair.it = it;
-	auto &slot = bucket_hash[hash % bucket_hash.size()];
-	slot.push_front (std::move (hashitpair));
+	scoped_trace_event trace ("dwarf2", "hash .debug_names names");
+	for (; iter != end; ++iter)
+	  iter->hash = dwarf5_djb_hash (iter->it->first.c_str ());
+      });
+
+    std::vector<std::forward_list<hash_it_pair>> bucket_hash;
+    bucket_hash.resize (m_bucket_table.size ());
+    for (const hash_it_pair &hashitpair : hashes)
+      {
+	auto &slot = bucket_hash[hashitpair.hash % bucket_hash.size()];
+	slot.push_front (hashitpair);
       }
     for (size_t bucket_ix = 0; bucket_ix < bucket_hash.size (); ++bucket_ix)
       {
@@ -1130,6 +1173,38 @@ write_gdbindex_1 (FILE *out_file,
   assert_file_size (out_file, total_len);
 }
 
+/* The name under which a cooked index entry is written to the
+   .gdb_index symbol table, and its hash.  */
+
+struct gdb_index_name
+{
+  /* The name, or NULL if the entry is not written.  */
+  const char *name = nullptr;
+  /* The hash of NAME, as computed by mapped_index_string_hash.  */
+  offset_type hash = 0;
+};
+
+/* Return true if ENTRY is not written to the .gdb_index symbol
+   table.  */
+
+static bool
+gdb_index_skip_entry (const cooked_index_entry *entry)
+{
+  /* GDB never put C++ linkage names into .gdb_index.  The theory here
+     is that a linkage name will normally be in the minimal symbols
+     anyway, so including it in the index is usually redundant -- and
+     the cases where it would not be redundant are rare and not worth
+     supporting.  */
+  if (entry->per_cu->lang () == language_cplus
+      && (entry->flags & IS_LINKAGE) != 0)
+    return true;
+
+  /* Don't add type declarations to the index, except for Ada, whose
+     names are always added.  */
+  return (entry->per_cu->lang () != language_ada
+	  && (entry->flags & IS_TYPE_DECLARATION) != 0);
+}
+
 /* Write the contents of the internal "cooked" index.  */
 
 static void
@@ -1137,13 +1212,50 @@ write_cooked_index (cooked_index *table,
 		    const cu_index_map &cu_index_htab,
 		    struct mapped_symtab *symtab)
 {
+  std::vector<const cooked_index_entry *> entries;
   for (const cooked_index_entry *entry : table->all_entries ())
+    entries.push_back (entry);
+
+  /* Computing the full names of the entries and hashing them is done
+     by the worker threads.  Each task returns the storage of the
+     names it computed.  The names of Ada entries are encoded below,
+     because ada_encode is not thread-safe.  */
+  std::vector<gdb_index_name> names (entries.size ());
+  using iter_type = std::vector<const cooked_index_entry *>::iterator;
+  std::vector<std::unique_ptr<auto_obstack>> storage
+    = index_for_each (1000, entries.begin (), entries.end (),
+		      [&] (iter_type iter, iter_type end)
+      {
+	scoped_trace_event trace ("dwarf2", "compute .gdb_index names");
+	std::unique_ptr<auto_obstack> thread_storage (new auto_obstack);
+	for (; iter != end; ++iter)
+	  {
+	    const cooked_index_entry *entry = *iter;
+	    if (gdb_index_skip_entry (entry))
+	      continue;
+
+	    gdb_index_name &result = names[iter - entries.begin ()];
+	    result.name = entry->full_name (thread_storage.get ());
+	    if (entry->per_cu->lang () != language_ada)
+	      result.hash = mapped_index_string_hash (INT_MAX, result.name);
+	  }
+	return thread_storage;
+      });
+
+  /* Entering the names in the hash table is done in the order of the
+     entries, so that the index does not depend on the number of
+     threads.  */
+  for (size_t i = 0; i < entries.size (); ++i)
     {
+      const cooked_index_entry *entry = entries[i];
+      const char *name = names[i].name;
+      offset_type hash = names[i].hash;
+      if (name == nullptr)
+	continue;
+
       const auto it = cu_index_htab.find (entry->per_cu);
       gdb_assert (it != cu_index_htab.cend ());
 
-      const char *name = entry->full_name (&symtab->m_string_obstack);
-
       if (entry->per_cu->lang () == language_ada)
 	{
 	  /* In order for the index to work when read back into
@@ -1152,21 +1264,7 @@ write_cooked_index (cooked_index *table,
 	  std::string encoded = ada_encode (name, false);
 	  name = obstack_strdup (&symtab->m_string_obstack,
 				 encoded.c_str ());
-	}
-      else if (entry->per_cu->lang () == language_cplus
-	       && (entry->flags & IS_LINKAGE) != 0)
-	{
-	  /* GDB never put C++ linkage names into .gdb_index.  The
-	     theory here is that a linkage name will normally be in
-	     the minimal symbols anyway, so including it in the index
-	     is usually redundant -- and the cases where it would not
-	     be redundant are rare and not worth supporting.  */
-	  continue;
-	}
-      else if ((entry->flags & IS_TYPE_DECLARATION) != 0)
-	{
-	  /* Don't add type declarations to the index.  */
-	  continue;
+	  hash = mapped_index_string_hash (INT_MAX, name);
 	}
 
       gdb_index_symbol_kind kind;
@@ -1182,9 +1280,12 @@ write_cooked_index (cooked_index *table,
       else
 	kind = GDB_INDEX_SYMBOL_KIND_TYPE;
 
-      add_index_entry (symtab, name, (entry->flags & IS_STATIC) != 0,
+      add_index_entry (symtab, name, hash, (entry->flags & IS_STATIC) != 0,
 		       kind, it->second);
     }
+
+  for (auto &one_storage : storage)
+    symtab->m_name_storage.push_back (std::move (one_storage));
 }
 
 /* Write contents of a .gdb_index section for OBJFILE into OUT_FILE.
@@ -1313,8 +1414,28 @@ write_debug_names (dwarf2_per_bfd *per_bfd, cooked_index *table,
   gdb_assert (counter == per_bfd->all_comp_units.size ());
   gdb_assert (types_counter == per_bfd->all_type_units.size ());
 
+  std::vector<const cooked_index_entry *> entries;
   for (const cooked_index_entry *entry : table->all_entries ())
-    nametable.insert (entry);
+    entries.push_back (entry);
+
+  /* The full names of the entries are computed by the worker threads,
+     then inserted in the order of the entries.  */
+  std::vector<const char *> names (entries.size ());
+  using iter_type = std::vector<const cooked_index_entry *>::iterator;
+  std::vector<std::unique_ptr<auto_obstack>> storage
+    = index_for_each (1000, entries.begin (), entries.end (),
+		      [&] (iter_type iter, iter_type end)
+      {
+	scoped_trace_event trace ("dwarf2", "compute .debug_names names");
+	std::unique_ptr<auto_obstack> thread_storage (new auto_obstack);
+	for (; iter != end; ++iter)
+	  names[iter - entries.begin ()]
+	    = (*iter)->full_name (thread_storage.get ());
+	return thread_storage;
+      });
+
+  for (size_t i = 0; i < entries.size (); ++i)
+    nametable.insert (entries[i], names[i]);
 
   nametable.build ();
 
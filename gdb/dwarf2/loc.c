@@ -46,6 +46,8 @@
 #include <unordered_set>
 #include "gdbsupport/underlying.h"
 #include "gdbsupport/byte-vector.h"
+#include "perf-counters.h"
+#include <unordered_map>
 
 static struct value *dwarf2_evaluate_loc_desc_full
   (struct type *type, frame_info_ptr frame, const gdb_byte *data,
@@ -1489,6 +1491,293 @@ indirect_synthetic_pointer (sect_offset die, LONGEST byte_offset,
 						     per_objfile, type);
 }
 
+/* Most variables are in a register, at an offset from a register or
+   from the frame base, or at a static address.  Their location
+   expressions are decoded once into a dwarf2_loc_plan, so that reading
+   such a variable, for each "display" or "info locals" after each
+   step, does not set up the expression evaluator and interpret the
+   expression again.  Other expressions are interpreted as usual.  */
+
+struct dwarf2_loc_plan
+{
+  enum kind_type
+  {
+    /* Not one of the forms below; use the expression evaluator.  */
+    INTERPRET,
+    /* DW_OP_reg<n>, DW_OP_regx: in register REG.  */
+    REGISTER,
+    /* DW_OP_breg<n>, DW_OP_bregx: at register REG plus OFFSET.  */
+    REGISTER_OFFSET,
+    /* DW_OP_fbreg: at the frame base plus OFFSET.  */
+    FRAME_BASE_OFFSET,
+    /* DW_OP_call_frame_cfa: at the CFA.  */
+    CFA,
+    /* DW_OP_addr: at ADDR, plus the objfile's text section offset.  */
+    STATIC_ADDRESS,
+  };
+
+  kind_type kind = INTERPRET;
+
+  /* The size of the expression.  */
+  size_t size = 0;
+
+  int reg = 0;
+  LONGEST offset = 0;
+  CORE_ADDR addr = 0;
+};
+
+/* The plans of the location expressions of an objfile, by the address
+   of the expression.  */
+
+struct dwarf2_loc_plan_cache
+{
+  std::unordered_map<const gdb_byte *, dwarf2_loc_plan> plans;
+};
+
+static const registry<objfile>::key<dwarf2_loc_plan_cache>
+  dwarf2_loc_plan_cache_key;
+
+/* Whether location expressions are decoded into plans, set by "maint
+   set dwarf location-plans".  */
+
+static bool dwarf2_loc_plans_enabled = true;
+
+static perf_counter dwarf2_loc_plan_counter
+  ("dwarf2.location-plans",
+   N_("DWARF locations computed from a decoded plan."));
+static perf_counter dwarf2_loc_interpreted_counter
+  ("dwarf2.location-interpreted",
+   N_("DWARF location expressions interpreted by the evaluator."));
+
+/* Decode the location expression DATA of SIZE bytes into a plan.
+   ADDR_SIZE is the size of an address in the expression's CU.  */
+
+static dwarf2_loc_plan
+decode_loc_plan (const gdb_byte *data, size_t size, int addr_size,
+		 dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_loc_plan plan;
+  const gdb_byte *end = data + size;
+  const gdb_byte *op_ptr = data + 1;
+  enum dwarf_location_atom op = (enum dwarf_location_atom) data[0];
+  uint64_t reg = 0;
+  int64_t offset = 0;
+  dwarf2_loc_plan::kind_type kind;
+
+  plan.size = size;
+
+  if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+    {
+      kind = dwarf2_loc_plan::REGISTER;
+      reg = op - DW_OP_reg0;
+    }
+  else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+    {
+      kind = dwarf2_loc_plan::REGISTER_OFFSET;
+      reg = op - DW_OP_breg0;
+      op_ptr = gdb_read_sleb128 (op_ptr, end, &offset);
+    }
+  else if (op == DW_OP_regx)
+    {
+      kind = dwarf2_loc_plan::REGISTER;
+      op_ptr = gdb_read_uleb128 (op_ptr, end, &reg);
+    }
+  else if (op == DW_OP_bregx)
+    {
+      kind = dwarf2_loc_plan::REGISTER_OFFSET;
+      op_ptr = gdb_read_uleb128 (op_ptr, end, &reg);
+      if (op_ptr != nullptr)
+	op_ptr = gdb_read_sleb128 (op_ptr, end, &offset);
+    }
+  else if (op == DW_OP_fbreg)
+    {
+      kind = dwarf2_loc_plan::FRAME_BASE_OFFSET;
+      op_ptr = gdb_read_sleb128 (op_ptr, end, &offset);
+    }
+  else if (op == DW_OP_call_frame_cfa)
+    kind = dwarf2_loc_plan::CFA;
+  else if (op == DW_OP_addr && end - op_ptr == addr_size)
+    {
+      bfd_endian byte_order
+	= gdbarch_byte_order (per_objfile->objfile->arch ());
+
+      kind = dwarf2_loc_plan::STATIC_ADDRESS;
+      plan.addr = extract_unsigned_integer (op_ptr, addr_size, byte_order);
+      op_ptr += addr_size;
+    }
+  else
+    return plan;
+
+  /* The operation must be the whole expression.  */
+  if (op_ptr != end || reg > INT_MAX)
+    return plan;
+
+  plan.kind = kind;
+  plan.reg = reg;
+  plan.offset = offset;
+  return plan;
+}
+
+/* Return the plan of the location expression DATA of SIZE bytes from
+   PER_CU, decoding it the first time.  */
+
+static const dwarf2_loc_plan &
+get_loc_plan (const gdb_byte *data, size_t size,
+	      dwarf2_per_cu_data *per_cu, dwarf2_per_objfile *per_objfile)
+{
+  dwarf2_loc_plan_cache *cache
+    = dwarf2_loc_plan_cache_key.get (per_objfile->objfile);
+  if (cache == nullptr)
+    cache = dwarf2_loc_plan_cache_key.emplace (per_objfile->objfile);
+
+  auto inserted = cache->plans.emplace (data, dwarf2_loc_plan ());
+  dwarf2_loc_plan &plan = inserted.first->second;
+  if (inserted.second || plan.size != size)
+    plan = decode_loc_plan (data, size, per_cu->addr_size (), per_objfile);
+  return plan;
+}
+
+/* Compute the frame base of FRAME like DW_OP_fbreg does, using the
+   plan of the frame base expression.  Return false, and leave it to
+   the expression evaluator, if that expression has no plan.  */
+
+static bool
+loc_plan_frame_base (frame_info_ptr frame, dwarf2_per_cu_data *per_cu,
+		     dwarf2_per_objfile *per_objfile, CORE_ADDR *base)
+{
+  const block *bl = get_frame_block (frame, nullptr);
+  if (bl == nullptr)
+    return false;
+
+  symbol *framefunc = bl->linkage_function ();
+  if (framefunc == nullptr)
+    return false;
+
+  const gdb_byte *start;
+  size_t length;
+  func_get_frame_base_dwarf_block (framefunc,
+				   get_frame_address_in_block (frame),
+				   &start, &length);
+
+  const dwarf2_loc_plan &plan = get_loc_plan (start, length, per_cu,
+					      per_objfile);
+  switch (plan.kind)
+    {
+    case dwarf2_loc_plan::REGISTER:
+      *base = read_addr_from_reg (frame, plan.reg);
+      return true;
+    case dwarf2_loc_plan::REGISTER_OFFSET:
+      *base = read_addr_from_reg (frame, plan.reg) + plan.offset;
+      return true;
+    case dwarf2_loc_plan::CFA:
+      *base = dwarf2_frame_cfa (frame);
+      return true;
+    case dwarf2_loc_plan::STATIC_ADDRESS:
+      *base = plan.addr + per_objfile->objfile->text_section_offset ();
+      return true;
+    default:
+      return false;
+    }
+}
+
+/* Compute the value of the variable described by the location
+   expression DATA of SIZE bytes, like dwarf_expr_context::evaluate
+   and fetch_result would, from the plan of the expression.  The
+   arguments are those of dwarf2_evaluate_loc_desc_full.  Return NULL
+   if the expression must be interpreted.  */
+
+static struct value *
+dwarf2_evaluate_loc_plan (struct type *type, frame_info_ptr frame,
+			  const gdb_byte *data, size_t size,
+			  dwarf2_per_cu_data *per_cu,
+			  dwarf2_per_objfile *per_objfile,
+			  struct type *subobj_type,
+			  LONGEST subobj_byte_offset)
+{
+  const dwarf2_loc_plan &plan = get_loc_plan (data, size, per_cu,
+					      per_objfile);
+  if (plan.kind == dwarf2_loc_plan::INTERPRET
+      || (plan.kind != dwarf2_loc_plan::STATIC_ADDRESS && frame == nullptr))
+    return nullptr;
+
+  gdbarch *arch = per_objfile->objfile->arch ();
+
+  check_typedef (type);
+  check_typedef (subobj_type);
+
+  if (plan.kind == dwarf2_loc_plan::REGISTER)
+    {
+      if (subobj_byte_offset != 0)
+	return nullptr;
+
+      int gdb_regnum = dwarf_reg_to_regnum_or_error (get_frame_arch (frame),
+						     plan.reg);
+      value *retval = value_from_register (subobj_type, gdb_regnum, frame);
+      if (retval->optimized_out ())
+	{
+	  /* See dwarf_expr_context::fetch_result.  */
+	  value *tmp = value::allocate (subobj_type);
+	  retval->contents_copy (tmp, 0, 0, subobj_type->length ());
+	  retval = tmp;
+	}
+      ++dwarf2_loc_plan_counter;
+      return retval;
+    }
+
+  /* Addresses are computed as unsigned integers of the CU's address
+     size, which is not enough for these architectures.  */
+  if (gdbarch_integer_to_address_p (arch))
+    return nullptr;
+
+  CORE_ADDR address;
+  bool in_stack_memory = false;
+  switch (plan.kind)
+    {
+    case dwarf2_loc_plan::REGISTER_OFFSET:
+      address = read_addr_from_reg (frame, plan.reg) + plan.offset;
+      break;
+    case dwarf2_loc_plan::FRAME_BASE_OFFSET:
+      if (!loc_plan_frame_base (frame, per_cu, per_objfile, &address))
+	return nullptr;
+      address += plan.offset;
+      in_stack_memory = true;
+      break;
+    case dwarf2_loc_plan::CFA:
+      address = dwarf2_frame_cfa (frame);
+      in_stack_memory = true;
+      break;
+    case dwarf2_loc_plan::STATIC_ADDRESS:
+      address = plan.addr + per_objfile->objfile->text_section_offset ();
+      break;
+    default:
+      gdb_assert_not_reached ("unexpected location plan");
+    }
+
+  int addr_size = per_cu->addr_size ();
+  if (addr_size < sizeof (CORE_ADDR))
+    address &= ((CORE_ADDR) 1 << (8 * addr_size)) - 1;
+
+  struct type *ptr_type;
+  switch (subobj_type->code ())
+    {
+    case TYPE_CODE_FUNC:
+    case TYPE_CODE_METHOD:
+      ptr_type = builtin_type (arch)->builtin_func_ptr;
+      break;
+    default:
+      ptr_type = builtin_type (arch)->builtin_data_ptr;
+      break;
+    }
+  address = value_as_address (value_from_pointer (ptr_type, address));
+
+  value *retval = value_at_lazy (subobj_type, address + subobj_byte_offset,
+				 frame);
+  if (in_stack_memory)
+    retval->set_stack (true);
+  ++dwarf2_loc_plan_counter;
+  return retval;
+}
+
 /* Evaluate a location description, starting at DATA and with length
    SIZE, to find the current location of variable of TYPE in the
    context of FRAME.  If SUBOBJ_TYPE is non-NULL, return instead the
@@ -1522,8 +1811,17 @@ dwarf2_evaluate_loc_desc_full (struct type *type, frame_info_ptr frame,
 
   try
     {
-      retval = ctx.evaluate (data, size, as_lval, per_cu, frame, nullptr,
-			     type, subobj_type, subobj_byte_offset);
+      retval = nullptr;
+      if (dwarf2_loc_plans_enabled && as_lval && type != nullptr)
+	retval = dwarf2_evaluate_loc_plan (type, frame, data, size, per_cu,
+					   per_objfile, subobj_type,
+					   subobj_byte_offset);
+      if (retval == nullptr)
+	{
+	  ++dwarf2_loc_interpreted_counter;
+	  retval = ctx.evaluate (data, size, as_lval, per_cu, frame, nullptr,
+				 type, subobj_type, subobj_byte_offset);
+	}
     }
   catch (const gdb_exception_error &ex)
     {
@@ -4117,6 +4415,16 @@ const struct symbol_computed_ops dwarf2_loclist_funcs = {
   loclist_generate_c_location
 };
 
+/* Implement "maint show dwarf location-plans".  */
+
+static void
+show_dwarf_loc_plans (struct ui_file *file, int from_tty,
+		      struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("Decoding of simple DWARF location expressions "
+		      "is %s.\n"), value);
+}
+
 void _initialize_dwarf2loc ();
 void
 _initialize_dwarf2loc ()
@@ -4145,4 +4453,17 @@ conversational style, when possible."),
 			   show_dwarf_always_disassemble,
 			   &set_dwarf_cmdlist,
 			   &show_dwarf_cmdlist);
+
+  add_setshow_boolean_cmd ("location-plans", class_maintenance,
+			   &dwarf2_loc_plans_enabled, _("\
+Set whether simple DWARF location expressions are decoded once."), _("\
+Show whether simple DWARF location expressions are decoded once."), _("\
+When on, location expressions that name a register, an offset from a\n\
+register or from the frame base, or a static address are decoded the\n\
+first time they are used, and the locations of the variables they\n\
+describe are then computed without the DWARF expression evaluator."),
+			   NULL,
+			   show_dwarf_loc_plans,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
 }
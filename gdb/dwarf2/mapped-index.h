@@ -82,6 +82,13 @@ struct dwarf_scanner_base
   virtual void wait_completely ()
   {
   }
+
+  /* Cancel any background work on the debuginfo that has not started
+     yet, because the containing per-BFD object is being destroyed.
+     wait_completely must still be called afterwards.  */
+  virtual void cancel_background_work ()
+  {
+  }
 };
 
 /* Base class containing bits shared by both .gdb_index and
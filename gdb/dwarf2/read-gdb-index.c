@@ -720,7 +720,9 @@ create_addrmap_from_gdb_index (dwarf2_per_objfile *per_objfile,
   dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
   const gdb_byte *iter, *end;
 
-  addrmap_mutable mutable_map;
+  /* GDB writes the address table sorted by address, which lets the
+     fixed map be built directly from it.  */
+  std::vector<addrmap_range> ranges;
 
   iter = index->address_table.data ();
   end = iter + index->address_table.size ();
@@ -751,11 +753,11 @@ create_addrmap_from_gdb_index (dwarf2_per_objfile *per_objfile,
 
       lo = (ULONGEST) per_objfile->adjust ((unrelocated_addr) lo);
       hi = (ULONGEST) per_objfile->adjust ((unrelocated_addr) hi);
-      mutable_map.set_empty (lo, hi - 1, per_bfd->get_cu (cu_index));
+      ranges.push_back ({ lo, hi - 1, per_bfd->get_cu (cu_index) });
     }
 
   per_bfd->index_addrmap
-    = new (&per_bfd->obstack) addrmap_fixed (&per_bfd->obstack, &mutable_map);
+    = new (&per_bfd->obstack) addrmap_fixed (&per_bfd->obstack, ranges);
 }
 
 /* See read-gdb-index.h.  */
@@ -95,6 +95,8 @@
 #include "split-name.h"
 #include "gdbsupport/parallel-for.h"
 #include "gdbsupport/thread-pool.h"
+#include "perf-counters.h"
+#include "trace-events.h"
 
 /* When == 1, print basic high level tracing messages.
    When > 1, be more verbose.
@@ -1270,9 +1272,14 @@ dwarf2_per_bfd::dwarf2_per_bfd (bfd *obfd, const dwarf2_debug_sections *names,
 dwarf2_per_bfd::~dwarf2_per_bfd ()
 {
   /* Data from the per-BFD may be needed when finalizing the cooked
-     index table, so wait here while this happens.  */
+     index table, so wait here while this happens.  Finalizing and
+     writing an index for an objfile that is going away is pointless,
+     so skip that work if it has not started yet.  */
   if (index_table != nullptr)
-    index_table->wait_completely ();
+    {
+      index_table->cancel_background_work ();
+      index_table->wait_completely ();
+    }
 
   for (auto &per_cu : all_units)
     {
@@ -1618,6 +1625,19 @@ struct quick_file_names
   /* The file names from the line table after being run through
      gdb_realpath.  These are computed lazily.  */
   const char **real_names;
+
+  /* Whether NUM_LINES and LINES have been computed, see
+     dw2_get_file_lines.  */
+  bool lines_read;
+
+  /* For each file name, the number of entries in LINES.  NULL if the
+     line numbers could not be read.  */
+  unsigned int *num_lines;
+
+  /* For each file name, the sorted line numbers of the rows of the
+     line number program for that file.  NULL if the line numbers
+     could not be read.  */
+  const unsigned int **lines;
 };
 
 /* With OBJF_READNOW, the DWARF reader expands all CUs immediately.
@@ -1652,6 +1672,16 @@ struct readnow_functions : public dwarf2_base_index_functions
   {
     return true;
   }
+
+  bool expand_symtabs_for_line
+    (struct objfile *objfile,
+     gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     int line,
+     gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+    override
+  {
+    return true;
+  }
 };
 
 /* Utility hash function for a stmt_list_hash.  */
@@ -2108,6 +2138,9 @@ dw2_get_file_names_reader (const struct die_reader_specs *reader,
 	    include_names.size () * sizeof (const char *));
 
   qfn->real_names = NULL;
+  qfn->lines_read = false;
+  qfn->num_lines = NULL;
+  qfn->lines = NULL;
 
   lh_cu->file_names = qfn;
 }
@@ -2159,6 +2192,244 @@ dw2_get_real_path (dwarf2_per_objfile *per_objfile,
   return qfn->real_names[index];
 }
 
+/* Return true if the file name at INDEX in QFN matches FILE_MATCHER,
+   comparing the name as given, its base name and its real path as
+   the file matcher expects.  */
+
+static bool
+dw2_file_name_matches
+  (dwarf2_per_objfile *per_objfile, struct quick_file_names *qfn, int index,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher)
+{
+  if (file_matcher (qfn->file_names[index], false))
+    return true;
+
+  /* Before we invoke realpath, which can get expensive when many
+     files are involved, do a quick comparison of the basenames.  */
+  if (!basenames_may_differ
+      && !file_matcher (lbasename (qfn->file_names[index]), true))
+    return false;
+
+  return file_matcher (dw2_get_real_path (per_objfile, qfn, index), false);
+}
+
+/* Decode the line number program of LH, calling FUN with the file
+   entry and line number of each row.  The addresses are not computed,
+   and no row is dropped, so this yields a superset of the lines that
+   dwarf_decode_lines records.  Return false if the program uses
+   something this does not handle, in which case the rows seen so far
+   are incomplete.  */
+
+static bool
+dw2_decode_line_numbers
+  (struct line_header *lh, bfd *abfd,
+   gdb::function_view<void (const file_entry *, unsigned int)> fun)
+{
+  const gdb_byte *line_ptr = lh->statement_program_start;
+  const gdb_byte *line_end = lh->statement_program_end;
+  unsigned int bytes_read;
+
+  if (lh->line_range == 0)
+    return false;
+
+  while (line_ptr < line_end)
+    {
+      /* The part of the line number state machine that we need,
+	 reset at the start of each sequence.  */
+      file_name_index file = 1;
+      unsigned int line = 1;
+      bool end_sequence = false;
+
+      while (line_ptr < line_end && !end_sequence)
+	{
+	  unsigned char op_code = read_1_byte (abfd, line_ptr);
+	  line_ptr += 1;
+
+	  if (op_code >= lh->opcode_base)
+	    {
+	      unsigned char adj_opcode = op_code - lh->opcode_base;
+	      line += lh->line_base + adj_opcode % lh->line_range;
+	      fun (lh->file_name_at (file), line);
+	    }
+	  else switch (op_code)
+	    {
+	    case DW_LNS_extended_op:
+	      {
+		ULONGEST extended_len
+		  = read_unsigned_leb128 (abfd, line_ptr, &bytes_read);
+		line_ptr += bytes_read;
+		if (extended_len == 0 || extended_len > line_end - line_ptr)
+		  return false;
+
+		unsigned char extended_op = read_1_byte (abfd, line_ptr);
+		if (extended_op == DW_LNE_end_sequence)
+		  end_sequence = true;
+		else if (extended_op == DW_LNE_define_file)
+		  return false;
+		line_ptr += extended_len;
+	      }
+	      break;
+	    case DW_LNS_copy:
+	      fun (lh->file_name_at (file), line);
+	      break;
+	    case DW_LNS_advance_line:
+	      line += read_signed_leb128 (abfd, line_ptr, &bytes_read);
+	      line_ptr += bytes_read;
+	      break;
+	    case DW_LNS_set_file:
+	      file = (file_name_index) read_unsigned_leb128 (abfd, line_ptr,
+							     &bytes_read);
+	      line_ptr += bytes_read;
+	      break;
+	    case DW_LNS_advance_pc:
+	    case DW_LNS_set_column:
+	      (void) read_unsigned_leb128 (abfd, line_ptr, &bytes_read);
+	      line_ptr += bytes_read;
+	      break;
+	    case DW_LNS_negate_stmt:
+	    case DW_LNS_set_basic_block:
+	    case DW_LNS_const_add_pc:
+	    case DW_LNS_set_prologue_end:
+	      break;
+	    case DW_LNS_fixed_advance_pc:
+	      line_ptr += 2;
+	      break;
+	    default:
+	      {
+		/* Unknown standard opcode, ignore it.  */
+		for (int i = 0; i < lh->standard_opcode_lengths[op_code]; i++)
+		  {
+		    (void) read_unsigned_leb128 (abfd, line_ptr, &bytes_read);
+		    line_ptr += bytes_read;
+		  }
+	      }
+	    }
+	}
+    }
+
+  return true;
+}
+
+/* Compute the NUM_LINES and LINES fields of QFN, the file names of
+   PER_CU, by decoding the line number program without expanding the
+   CU.  Return false if the line numbers could not be read.  */
+
+static bool
+dw2_get_file_lines (dwarf2_per_cu_data *per_cu,
+		    dwarf2_per_objfile *per_objfile,
+		    struct quick_file_names *qfn)
+{
+  if (qfn->lines_read)
+    return qfn->lines != NULL;
+  qfn->lines_read = true;
+
+  cutu_reader reader (per_cu, per_objfile);
+  if (reader.dummy_p)
+    return false;
+
+  struct dwarf2_cu *cu = reader.cu;
+  struct attribute *attr = dwarf2_attr (reader.comp_unit_die,
+					DW_AT_stmt_list, cu);
+  if (attr == nullptr || !attr->form_is_unsigned ())
+    return false;
+
+  file_and_directory &fnd = find_file_and_directory (reader.comp_unit_die,
+						      cu);
+  line_header_up lh
+    = dwarf_decode_line_header ((sect_offset) attr->as_unsigned (), cu,
+				fnd.get_comp_dir ());
+  if (lh == nullptr)
+    return false;
+
+  /* Map each file entry of LH to the index of its name in QFN.  The
+     names are computed as dw2_get_file_names_reader does; being
+     interned, they can be compared by address.  */
+  std::unordered_map<const char *, int> name_index;
+  for (int j = qfn->num_file_names - 1; j >= 0; --j)
+    name_index[qfn->file_names[j]] = j;
+
+  std::vector<int> entry_index;
+  for (const file_entry &entry : lh->file_names ())
+    {
+      std::string name_holder;
+      const char *name = compute_include_file_name (lh.get (), entry, fnd,
+						    name_holder);
+      if (name == nullptr)
+	name = fnd.get_name ();
+
+      int index = -1;
+      if (name != nullptr)
+	{
+	  auto iter = name_index.find (per_objfile->objfile->intern (name));
+	  if (iter != name_index.end ())
+	    index = iter->second;
+	}
+      entry_index.push_back (index);
+    }
+
+  std::vector<std::vector<unsigned int>> lines (qfn->num_file_names);
+  bool valid = true;
+  auto record = [&] (const file_entry *fe, unsigned int line)
+    {
+      int index = (fe == nullptr
+		   ? -1 : entry_index[fe - lh->file_names ().data ()]);
+      if (index < 0)
+	valid = false;
+      else
+	lines[index].push_back (line);
+    };
+
+  if (!dw2_decode_line_numbers (lh.get (), per_objfile->objfile->obfd.get (),
+				record)
+      || !valid)
+    return false;
+
+  struct obstack *obstack = &per_objfile->per_bfd->obstack;
+  qfn->num_lines = XOBNEWVEC (obstack, unsigned int, qfn->num_file_names);
+  const unsigned int **file_lines
+    = XOBNEWVEC (obstack, const unsigned int *, qfn->num_file_names);
+  for (int j = 0; j < qfn->num_file_names; ++j)
+    {
+      std::vector<unsigned int> &vec = lines[j];
+      std::sort (vec.begin (), vec.end ());
+      vec.erase (std::unique (vec.begin (), vec.end ()), vec.end ());
+
+      unsigned int *copy = XOBNEWVEC (obstack, unsigned int, vec.size ());
+      std::copy (vec.begin (), vec.end (), copy);
+      qfn->num_lines[j] = vec.size ();
+      file_lines[j] = copy;
+    }
+  qfn->lines = file_lines;
+
+  return true;
+}
+
+/* Return true if PER_CU, whose file names match FILE_MATCHER, may have
+   a line table entry for LINE in a file that matches FILE_MATCHER.  */
+
+static bool
+dw2_cu_may_have_line
+  (dwarf2_per_cu_data *per_cu, dwarf2_per_objfile *per_objfile,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   unsigned int line)
+{
+  struct quick_file_names *qfn = dw2_get_file_names (per_cu, per_objfile);
+  if (qfn == nullptr || !dw2_get_file_lines (per_cu, per_objfile, qfn))
+    return true;
+
+  for (int j = 0; j < qfn->num_file_names; ++j)
+    {
+      const unsigned int *begin = qfn->lines[j];
+      const unsigned int *end = begin + qfn->num_lines[j];
+
+      if (std::binary_search (begin, end, line)
+	  && dw2_file_name_matches (per_objfile, qfn, j, file_matcher))
+	return true;
+    }
+
+  return false;
+}
+
 struct symtab *
 dwarf2_base_index_functions::find_last_source_symtab (struct objfile *objfile)
 {
@@ -3116,23 +3387,7 @@ dw_expand_symtabs_matching_file_matcher
 
       for (int j = 0; j < file_data->num_file_names; ++j)
 	{
-	  const char *this_real_name;
-
-	  if (file_matcher (file_data->file_names[j], false))
-	    {
-	      per_cu->mark = 1;
-	      break;
-	    }
-
-	  /* Before we invoke realpath, which can get expensive when many
-	     files are involved, do a quick comparison of the basenames.  */
-	  if (!basenames_may_differ
-	      && !file_matcher (lbasename (file_data->file_names[j]),
-				true))
-	    continue;
-
-	  this_real_name = dw2_get_real_path (per_objfile, file_data, j);
-	  if (file_matcher (this_real_name, false))
+	  if (dw2_file_name_matches (per_objfile, file_data, j, file_matcher))
 	    {
 	      per_cu->mark = 1;
 	      break;
@@ -3147,6 +3402,40 @@ dw_expand_symtabs_matching_file_matcher
     }
 }
 
+/* See quick-symbol.h.  */
+
+bool
+dwarf2_base_index_functions::expand_symtabs_for_line
+  (struct objfile *objfile,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   int line,
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+{
+  dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+
+  dw_expand_symtabs_matching_file_matcher (per_objfile, file_matcher);
+
+  for (dwarf2_per_cu_data *per_cu : all_units_range (per_objfile->per_bfd))
+    {
+      QUIT;
+
+      /* A header included by many CUs has rows in only some of them;
+	 there is no point expanding the others.  */
+      if (file_matcher != nullptr
+	  && line > 0
+	  && per_cu->mark
+	  && !per_cu->is_debug_types
+	  && !dw2_cu_may_have_line (per_cu, per_objfile, file_matcher, line))
+	continue;
+
+      if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
+					    file_matcher, expansion_notify))
+	return false;
+    }
+
+  return true;
+}
+
 
 /* A helper for dw2_find_pc_sect_compunit_symtab which finds the most specific
    symtab.  */
@@ -4076,6 +4365,18 @@ read_cutu_die_from_dwo (dwarf2_cu *cu,
   return 1;
 }
 
+#if CXX_STD_THREAD
+/* Serializes looking up and reading DWO and DWP files, see
+   lookup_dwo_unit.  */
+static std::mutex dwo_lock;
+#endif
+
+static struct dwp_file *get_dwp_file (dwarf2_per_objfile *per_objfile);
+
+static std::string find_dwo_file (dwarf2_per_objfile *per_objfile,
+				  const char *file_name,
+				  const char *comp_dir);
+
 /* Return the signature of the compile unit, if found. In DWARF 4 and before,
    the signature is in the DW_AT_GNU_dwo_id attribute. In DWARF 5 and later, the
    signature is part of the header.  */
@@ -4098,14 +4399,6 @@ lookup_dwo_id (struct dwarf2_cu *cu, struct die_info* comp_unit_die)
 static struct dwo_unit *
 lookup_dwo_unit (dwarf2_cu *cu, die_info *comp_unit_die, const char *dwo_name)
 {
-#if CXX_STD_THREAD
-  /* We need a lock here both to handle the DWO hash table, and BFD,
-     which is not thread-safe.  */
-  static std::mutex dwo_lock;
-
-  std::lock_guard<std::mutex> guard (dwo_lock);
-#endif
-
   dwarf2_per_cu_data *per_cu = cu->per_cu;
   struct dwo_unit *dwo_unit;
   const char *comp_dir;
@@ -4116,6 +4409,22 @@ lookup_dwo_unit (dwarf2_cu *cu, die_info *comp_unit_die, const char *dwo_name)
   dwo_name = dwarf2_dwo_name (comp_unit_die, cu);
   comp_dir = dwarf2_string_attr (comp_unit_die, DW_AT_comp_dir, cu);
 
+#if CXX_STD_THREAD
+  /* We need a lock here both to handle the DWO hash table, and BFD,
+     which is not thread-safe.  */
+  std::unique_lock<std::mutex> guard (dwo_lock);
+
+  /* Searching the directories for the DWO file does not need the lock,
+     so that the indexing threads can do it concurrently.  Do it now;
+     open_dwo_file then finds the result cached.  */
+  if (get_dwp_file (cu->per_objfile) == nullptr && dwo_name != nullptr)
+    {
+      guard.unlock ();
+      find_dwo_file (cu->per_objfile, dwo_name, comp_dir);
+      guard.lock ();
+    }
+#endif
+
   if (per_cu->is_debug_types)
     dwo_unit = lookup_dwo_type_unit (cu, dwo_name, comp_dir);
   else
@@ -5084,6 +5393,13 @@ process_skeletonless_type_units (dwarf2_per_objfile *per_objfile,
     }
 }
 
+/* The time spent indexing DWARF, for "maint info perf-counters".  */
+
+static perf_counter dwarf2_index_time_counter
+  ("dwarf2.index-usec", N_("Microseconds spent indexing DWARF."));
+static perf_counter dwarf2_index_units_counter
+  ("dwarf2.indexed-units", N_("DWARF units indexed."));
+
 /* Build the partial symbol table by doing a quick pass through the
    .debug_info and .debug_abbrev sections.  */
 
@@ -5092,6 +5408,8 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
 {
   struct objfile *objfile = per_objfile->objfile;
   dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  scoped_perf_timer timer (dwarf2_index_time_counter);
+  scoped_trace_event trace ("dwarf2", "index DWARF", objfile_name (objfile));
 
   dwarf_read_debug_printf ("Building psymtabs of objfile %s ...",
 			   objfile_name (objfile));
@@ -5100,6 +5418,7 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
 
   cooked_index_storage index_storage;
   create_all_units (per_objfile);
+  dwarf2_index_units_counter += per_bfd->all_units.size ();
   build_type_psymtabs (per_objfile, &index_storage);
   std::vector<std::unique_ptr<cooked_index_shard>> indexes;
 
@@ -5134,6 +5453,7 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
 				per_bfd->all_units.end (),
 				[=] (iter_type iter, iter_type end)
       {
+	scoped_trace_event task_trace ("dwarf2", "index units");
 	std::vector<gdb_exception> errors;
 	cooked_index_storage thread_storage;
 	for (; iter != end; ++iter)
@@ -9128,23 +9448,18 @@ lookup_dwo_unit_in_dwp (dwarf2_per_objfile *per_objfile,
 	 dwp_file->name);
 }
 
-/* Subroutine of open_dwo_file,open_dwp_file to simplify them.
-   Open the file specified by FILE_NAME and hand it off to BFD for
-   preliminary analysis.  Return a newly initialized bfd *, which
-   includes a canonicalized copy of FILE_NAME.
-   If IS_DWP is TRUE, we're opening a DWP file, otherwise a DWO file.
-   SEARCH_CWD is true if the current directory is to be searched.
-   It will be searched before debug-file-directory.
-   If successful, the file is added to the bfd include table of the
-   objfile's bfd (see gdb_bfd_record_inclusion).
-   If unable to find/open the file, return NULL.
-   NOTE: This function is derived from symfile_bfd_open.  */
+/* Subroutine of try_open_dwop_file and find_dwo_file.
+   Search for the file specified by FILE_NAME the way try_open_dwop_file
+   does, and return a descriptor for it, storing its real path in
+   *ABSOLUTE_NAME.  Return a negative value if it is not found.
+   This does not use BFD, so it can be called without holding
+   DWO_LOCK.  */
 
-static gdb_bfd_ref_ptr
-try_open_dwop_file (dwarf2_per_objfile *per_objfile,
-		    const char *file_name, int is_dwp, int search_cwd)
+static scoped_fd
+search_dwop_file (dwarf2_per_objfile *per_objfile, const char *file_name,
+		  int is_dwp, int search_cwd,
+		  gdb::unique_xmalloc_ptr<char> *absolute_name)
 {
-  int desc;
   /* Blech.  OPF_TRY_CWD_FIRST also disables searching the path list if
      FILE_NAME contains a '/'.  So we can't use it.  Instead prepend "."
      to debug_file_directory.  */
@@ -9178,14 +9493,23 @@ try_open_dwop_file (dwarf2_per_objfile *per_objfile,
   if (is_dwp)
     flags |= OPF_SEARCH_IN_PATH;
 
-  gdb::unique_xmalloc_ptr<char> absolute_name;
-  desc = openp (search_path, flags, file_name,
-		O_RDONLY | O_BINARY, &absolute_name);
-  if (desc < 0)
-    return NULL;
+  return scoped_fd (openp (search_path, flags, file_name,
+			   O_RDONLY | O_BINARY, absolute_name));
+}
+
+/* Subroutine of try_open_dwop_file and open_dwo_file.
+   Hand the file ABSOLUTE_NAME, open as DESC if that is not -1, off to
+   BFD for preliminary analysis.  Return a newly initialized bfd *, or
+   NULL if the file cannot be used.
+   If successful, the file is added to the bfd include table of the
+   objfile's bfd (see gdb_bfd_record_inclusion).  */
 
-  gdb_bfd_ref_ptr sym_bfd (gdb_bfd_open (absolute_name.get (),
-					 gnutarget, desc));
+static gdb_bfd_ref_ptr
+open_dwop_bfd (dwarf2_per_objfile *per_objfile, const char *absolute_name,
+	       scoped_fd desc)
+{
+  gdb_bfd_ref_ptr sym_bfd (gdb_bfd_open (absolute_name, gnutarget,
+					 desc.release ()));
   if (sym_bfd == NULL)
     return NULL;
 
@@ -9201,44 +9525,111 @@ try_open_dwop_file (dwarf2_per_objfile *per_objfile,
   return sym_bfd;
 }
 
-/* Try to open DWO file FILE_NAME.
-   COMP_DIR is the DW_AT_comp_dir attribute.
-   The result is the bfd handle of the file.
-   If there is a problem finding or opening the file, return NULL.
-   Upon success, the canonicalized path of the file is stored in the bfd,
-   same as symfile_bfd_open.  */
+/* Subroutine of open_dwp_file to simplify it.
+   Open the file specified by FILE_NAME and hand it off to BFD for
+   preliminary analysis.  Return a newly initialized bfd *, which
+   includes a canonicalized copy of FILE_NAME.
+   If IS_DWP is TRUE, we're opening a DWP file, otherwise a DWO file.
+   SEARCH_CWD is true if the current directory is to be searched.
+   It will be searched before debug-file-directory.
+   If successful, the file is added to the bfd include table of the
+   objfile's bfd (see gdb_bfd_record_inclusion).
+   If unable to find/open the file, return NULL.
+   NOTE: This function is derived from symfile_bfd_open.  */
 
 static gdb_bfd_ref_ptr
-open_dwo_file (dwarf2_per_objfile *per_objfile,
-	       const char *file_name, const char *comp_dir)
+try_open_dwop_file (dwarf2_per_objfile *per_objfile,
+		    const char *file_name, int is_dwp, int search_cwd)
 {
-  if (IS_ABSOLUTE_PATH (file_name))
-    return try_open_dwop_file (per_objfile, file_name,
-			       0 /*is_dwp*/, 0 /*search_cwd*/);
+  gdb::unique_xmalloc_ptr<char> absolute_name;
+  scoped_fd desc = search_dwop_file (per_objfile, file_name, is_dwp,
+				     search_cwd, &absolute_name);
+  if (desc.get () < 0)
+    return NULL;
 
-  /* Before trying the search path, try DWO_NAME in COMP_DIR.  */
+  return open_dwop_bfd (per_objfile, absolute_name.get (), std::move (desc));
+}
+
+/* Search for the DWO file FILE_NAME, whose DW_AT_comp_dir attribute is
+   COMP_DIR, and return its real path, or the empty string if it cannot
+   be found.
+   The result is cached in the per-BFD object, so each DWO file is only
+   searched for once.  This does not use BFD, so the DWO files of
+   different units can be searched for concurrently.  */
+
+static std::string
+find_dwo_file (dwarf2_per_objfile *per_objfile, const char *file_name,
+	       const char *comp_dir)
+{
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+
+  /* The result also depends on where the search looks.  */
+  std::string key = string_printf ("%s%c%s%c%s%c%s", file_name, '\0',
+				   comp_dir == nullptr ? "" : comp_dir, '\0',
+				   objfile_name (per_objfile->objfile), '\0',
+				   debug_file_directory.c_str ());
+
+  {
+#if CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (per_bfd->dwo_paths_lock);
+#endif
+    auto iter = per_bfd->dwo_paths.find (key);
+    if (iter != per_bfd->dwo_paths.end ())
+      return iter->second;
+  }
 
-  if (comp_dir != NULL)
+  gdb::unique_xmalloc_ptr<char> absolute_name;
+
+  if (IS_ABSOLUTE_PATH (file_name))
+    search_dwop_file (per_objfile, file_name, 0 /*is_dwp*/, 0 /*search_cwd*/,
+		      &absolute_name);
+  else
     {
-      std::string path_to_try = path_join (comp_dir, file_name);
+      /* Before trying the search path, try DWO_NAME in COMP_DIR.  */
+      if (comp_dir != NULL)
+	{
+	  std::string path_to_try = path_join (comp_dir, file_name);
 
-      /* NOTE: If comp_dir is a relative path, this will also try the
-	 search path, which seems useful.  */
-      gdb_bfd_ref_ptr abfd (try_open_dwop_file
-	(per_objfile, path_to_try.c_str (), 0 /*is_dwp*/, 1 /*search_cwd*/));
+	  /* NOTE: If comp_dir is a relative path, this will also try the
+	     search path, which seems useful.  */
+	  search_dwop_file (per_objfile, path_to_try.c_str (),
+			    0 /*is_dwp*/, 1 /*search_cwd*/, &absolute_name);
+	}
 
-      if (abfd != NULL)
-	return abfd;
+      /* That didn't work, try debug-file-directory, which, despite its
+	 name, is a list of paths.  */
+      if (absolute_name == nullptr && !debug_file_directory.empty ())
+	search_dwop_file (per_objfile, file_name, 0 /*is_dwp*/,
+			  1 /*search_cwd*/, &absolute_name);
     }
 
-  /* That didn't work, try debug-file-directory, which, despite its name,
-     is a list of paths.  */
+  std::string result;
+  if (absolute_name != nullptr)
+    result = absolute_name.get ();
 
-  if (debug_file_directory.empty ())
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (per_bfd->dwo_paths_lock);
+#endif
+  per_bfd->dwo_paths.emplace (std::move (key), result);
+  return result;
+}
+
+/* Try to open DWO file FILE_NAME.
+   COMP_DIR is the DW_AT_comp_dir attribute.
+   The result is the bfd handle of the file.
+   If there is a problem finding or opening the file, return NULL.
+   Upon success, the canonicalized path of the file is stored in the bfd,
+   same as symfile_bfd_open.  */
+
+static gdb_bfd_ref_ptr
+open_dwo_file (dwarf2_per_objfile *per_objfile,
+	       const char *file_name, const char *comp_dir)
+{
+  std::string path = find_dwo_file (per_objfile, file_name, comp_dir);
+  if (path.empty ())
     return NULL;
 
-  return try_open_dwop_file (per_objfile, file_name,
-			     0 /*is_dwp*/, 1 /*search_cwd*/);
+  return open_dwop_bfd (per_objfile, path.c_str (), scoped_fd (-1));
 }
 
 /* This function is mapped across the sections and remembers the offset and
@@ -16701,6 +17092,33 @@ struct cooked_index_functions : public dwarf2_base_index_functions
      domain_enum domain,
      enum search_domain kind) override;
 
+  bool expand_symtabs_matching_names
+    (struct objfile *objfile,
+     gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     gdb::function_view<expand_symtabs_symbol_matcher_factory_ftype>
+       make_matcher,
+     block_search_flags search_flags,
+     enum search_domain kind) override;
+
+  bool expand_symtabs_for_line
+    (struct objfile *objfile,
+     gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     int line,
+     gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+    override
+  {
+    dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+    cooked_index *table
+      = (gdb::checked_static_cast<cooked_index *>
+	 (per_objfile->per_bfd->index_table.get ()));
+    if (table == nullptr)
+      return true;
+
+    table->wait ();
+    return dwarf2_base_index_functions::expand_symtabs_for_line
+      (objfile, file_matcher, line, expansion_notify);
+  }
+
   bool can_lazily_read_symbols () override
   {
     return true;
@@ -16712,6 +17130,23 @@ struct cooked_index_functions : public dwarf2_base_index_functions
       dwarf2_build_psymtabs (objfile);
   }
 
+  bool map_symbol_names (struct objfile *objfile,
+			 gdb::function_view<void (const char *)> fun) override
+  {
+    dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+    cooked_index *table
+      = (gdb::checked_static_cast<cooked_index *>
+	 (per_objfile->per_bfd->index_table.get ()));
+    if (table == nullptr)
+      return true;
+
+    table->wait ();
+
+    for (const cooked_index_entry *entry : table->all_entries ())
+      fun (entry->name);
+    return true;
+  }
+
   enum language lookup_global_symbol_language (struct objfile *objfile,
 					       const char *name,
 					       domain_enum domain,
@@ -16869,6 +17304,23 @@ cooked_index_functions::expand_symtabs_matching
     = lookup_name->make_ignore_params ();
   bool completing = lookup_name->completion_mode ();
 
+  /* When completing, only the names of the matching symbols matter.
+     Once a CU providing a name has been expanded, other CUs providing
+     the same name need not be; this avoids expanding every CU that
+     includes some header.  The completer then filters the symbols by
+     kind, for instance keeping only functions for a linespec, so a
+     name is only known once a CU providing it with the same tag was
+     expanded.  C++ functions are the exception, as their symbol names
+     include the parameters and so may differ between CUs.  Searches
+     that use a completion-mode lookup name to match any name, like
+     "info functions", do want every symbol, so this is only done for
+     real completion, which has no symbol matcher.  */
+  bool skip_completed_names
+    = (completing
+       && symbol_matcher == nullptr
+       && lookup_name != &lookup_name_info::match_any ());
+  std::set<std::pair<enum dwarf_tag, std::string>> completed_names;
+
   /* Unique styles of language splitting.  */
   static const enum language unique_styles[] =
   {
@@ -16951,6 +17403,16 @@ cooked_index_functions::expand_symtabs_matching
 		continue;
 	    }
 
+	  if (skip_completed_names
+	      && (entry->tag != DW_TAG_subprogram
+		  || entry->per_cu->lang (false) != language_cplus))
+	    {
+	      auto_obstack temp_storage;
+	      const char *full_name = entry->full_name (&temp_storage);
+	      if (!completed_names.emplace (entry->tag, full_name).second)
+		continue;
+	    }
+
 	  if (!dw2_expand_symtabs_matching_one (entry->per_cu, per_objfile,
 						file_matcher,
 						expansion_notify))
@@ -16961,6 +17423,100 @@ cooked_index_functions::expand_symtabs_matching
   return true;
 }
 
+bool
+cooked_index_functions::expand_symtabs_matching_names
+     (struct objfile *objfile,
+      gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+      gdb::function_view<expand_symtabs_symbol_matcher_factory_ftype>
+	make_matcher,
+      block_search_flags search_flags,
+      enum search_domain kind)
+{
+  dwarf2_per_objfile *per_objfile = get_dwarf2_per_objfile (objfile);
+
+  cooked_index *table
+    = (gdb::checked_static_cast<cooked_index *>
+       (per_objfile->per_bfd->index_table.get ()));
+  if (table == nullptr)
+    return true;
+
+  table->wait ();
+
+  dw_expand_symtabs_matching_file_matcher (per_objfile, file_matcher);
+
+  /* First select the entries that need their name matched, which is
+     cheap.  */
+  std::vector<const cooked_index_entry *> candidates;
+  for (const cooked_index_entry *entry : table->all_entries ())
+    {
+      /* No need to consider symbols from expanded CUs.  */
+      if (per_objfile->symtab_set_p (entry->per_cu))
+	continue;
+
+      /* If file-matching was done, we don't need to consider
+	 symbols from unmarked CUs.  */
+      if (file_matcher != nullptr && !entry->per_cu->mark)
+	continue;
+
+      if (!entry->matches (search_flags)
+	  || !entry->matches (kind))
+	continue;
+
+      candidates.push_back (entry);
+    }
+
+  QUIT;
+
+  /* Then match the names in parallel.  Each task returns the CUs of
+     the entries it matched, in order.  The worker threads must not
+     throw, so QUIT is only checked afterwards.  */
+  using cu_list = std::vector<dwarf2_per_cu_data *>;
+  std::vector<cu_list> results
+    = gdb::parallel_for_each
+	(1000, candidates.begin (), candidates.end (),
+	 [&] (std::vector<const cooked_index_entry *>::iterator iter,
+	      std::vector<const cooked_index_entry *>::iterator end)
+	 {
+	   scoped_trace_event task_trace ("dwarf2", "match index names");
+	   std::function<expand_symtabs_symbol_matcher_ftype> symbol_matcher
+	     = make_matcher ();
+	   std::unordered_set<dwarf2_per_cu_data *> seen;
+	   cu_list matched;
+
+	   for (; iter != end; ++iter)
+	     {
+	       const cooked_index_entry *entry = *iter;
+
+	       /* Once a CU matched, there is no need to match its other
+		  names.  */
+	       if (seen.count (entry->per_cu) != 0)
+		 continue;
+
+	       auto_obstack temp_storage;
+	       const char *full_name = entry->full_name (&temp_storage);
+	       if (symbol_matcher (full_name))
+		 {
+		   seen.insert (entry->per_cu);
+		   matched.push_back (entry->per_cu);
+		 }
+	     }
+
+	   return matched;
+	 });
+
+  for (const cu_list &matched : results)
+    for (dwarf2_per_cu_data *per_cu : matched)
+      {
+	QUIT;
+
+	if (!dw2_expand_symtabs_matching_one (per_cu, per_objfile,
+					      file_matcher, nullptr))
+	  return false;
+      }
+
+  return true;
+}
+
 /* Return a new cooked_index_functions object.  */
 
 static quick_symbol_functions_up
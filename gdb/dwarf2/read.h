@@ -22,6 +22,9 @@
 
 #include <queue>
 #include <unordered_map>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 #include "dwarf2/comp-unit-head.h"
 #include "dwarf2/cooked-index.h"
 #include "dwarf2/file-and-dir.h"
@@ -512,6 +515,17 @@ struct dwarf2_per_bfd
      This is NULL if the table hasn't been allocated yet.  */
   htab_up dwo_files;
 
+  /* Where DWO files were found on disk, see find_dwo_file.  This maps
+     the search key of a DWO file to its real path, or to the empty
+     string if it could not be found.  */
+  std::unordered_map<std::string, std::string> dwo_paths;
+
+#if CXX_STD_THREAD
+  /* Protects DWO_PATHS, which is used without holding the lock that
+     protects DWO_FILES.  */
+  std::mutex dwo_paths_lock;
+#endif
+
   /* True if we've checked for whether there is a DWP file.  */
   bool dwp_checked = false;
 
@@ -865,6 +879,13 @@ struct dwarf2_base_index_functions : public quick_symbol_functions
 
   void expand_all_symtabs (struct objfile *objfile) override;
 
+  bool expand_symtabs_for_line
+    (struct objfile *objfile,
+     gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     int line,
+     gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+    override;
+
   /* A helper function that finds the per-cu object from an "adjusted"
      PC -- a PC with the base text offset removed.  */
   virtual dwarf2_per_cu_data *find_per_cu (dwarf2_per_bfd *per_bfd,
@@ -51,6 +51,7 @@
 #include "debuginfod-support.h"
 #include "dwarf2/public.h"
 #include "cli/cli-cmds.h"
+#include "trace-events.h"
 
 /* Whether ctf should always be read, or only if no dwarf is present.  */
 static bool always_read_ctf;
@@ -1070,6 +1071,8 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
   long symcount = 0, dynsymcount = 0, synthcount, storage_needed;
   asymbol **symbol_table = NULL, **dyn_symbol_table = NULL;
   asymbol *synthsyms;
+  scoped_trace_event trace ("symbols", "read minimal symbols",
+			    objfile_name (objfile));
 
   symtab_create_debug_printf ("reading minimal symbols of objfile %s",
 			      objfile_name (objfile));
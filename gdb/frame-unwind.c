@@ -102,6 +102,8 @@ frame_unwind_prepend_unwinder (struct gdbarch *gdbarch,
   entry->unwinder = unwinder;
   entry->next = (*table->osabi_head);
   (*table->osabi_head) = entry;
+
+  frame_memo_clear ();
 }
 
 void
@@ -115,6 +117,8 @@ frame_unwind_append_unwinder (struct gdbarch *gdbarch,
   for (ip = table->osabi_head; (*ip) != NULL; ip = &(*ip)->next);
   (*ip) = GDBARCH_OBSTACK_ZALLOC (gdbarch, struct frame_unwind_table_entry);
   (*ip)->unwinder = unwinder;
+
+  frame_memo_clear ();
 }
 
 /* Call SNIFFER from UNWINDER.  If it succeeded set UNWINDER for
@@ -177,6 +181,48 @@ frame_unwind_try_unwinder (frame_info_ptr this_frame, void **this_cache,
   gdb_assert_not_reached ("frame_unwind_try_unwinder");
 }
 
+/* Try UNWINDER, the unwinder remembered for THIS_FRAME's pc, see
+   frame_remembered_unwinder.  It is kept only if it claims the frame and
+   gives it the ID of a frame that was on the stack the last time the
+   thread stopped; otherwise THIS_FRAME is left unchanged and 0 is
+   returned, and the caller tries the unwinders in order as usual.  */
+
+static int
+frame_unwind_try_remembered (frame_info_ptr this_frame, void **this_cache,
+			     const struct frame_unwind *unwinder)
+{
+  if (!frame_unwind_try_unwinder (this_frame, this_cache, unwinder))
+    return 0;
+
+  unsigned int entry_generation = get_frame_cache_generation ();
+  bool remembered = false;
+
+  try
+    {
+      frame_id id = outer_frame_id;
+      unwinder->this_id (this_frame, this_cache, &id);
+      remembered = frame_remembered_p (this_frame, id);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      frame_debug_printf ("caught exception: %s", ex.message->c_str ());
+      if (get_frame_cache_generation () != entry_generation)
+	throw;
+    }
+
+  if (remembered)
+    {
+      frame_debug_printf ("remembered unwinder \"%s\"", unwinder->name);
+      return 1;
+    }
+
+  if (*this_cache != nullptr && unwinder->dealloc_cache != nullptr)
+    unwinder->dealloc_cache (this_frame.get (), *this_cache);
+  *this_cache = nullptr;
+  frame_cleanup_after_sniffer (this_frame);
+  return 0;
+}
+
 /* Iterate through sniffers for THIS_FRAME frame until one returns with an
    unwinder implementation.  THIS_FRAME->UNWIND must be NULL, it will get set
    by this function.  Possibly initialize THIS_CACHE.  */
@@ -204,7 +250,21 @@ frame_unwind_find_by_frame (frame_info_ptr this_frame, void **this_cache)
 				   unwinder_from_target))
     return;
 
-  for (entry = table->list; entry != NULL; entry = entry->next)
+  /* The unwinders before the OSABI part of the list, for dummy, tail
+     call and inline frames, must get the first chance; a frame claimed
+     by one of them is never remembered.  Then try the unwinder that
+     claimed the frame the last time the thread stopped, if any.  */
+  for (entry = table->list; entry != *table->osabi_head; entry = entry->next)
+    if (frame_unwind_try_unwinder (this_frame, this_cache, entry->unwinder))
+      return;
+
+  const struct frame_unwind *remembered
+    = frame_remembered_unwinder (this_frame);
+  if (remembered != nullptr
+      && frame_unwind_try_remembered (this_frame, this_cache, remembered))
+    return;
+
+  for (; entry != NULL; entry = entry->next)
     if (frame_unwind_try_unwinder (this_frame, this_cache, entry->unwinder))
       return;
 
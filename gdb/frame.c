@@ -43,6 +43,9 @@
 #include "hashtab.h"
 #include "valprint.h"
 #include "cli/cli-option.h"
+#include "perf-counters.h"
+#include <unordered_map>
+#include <unordered_set>
 
 /* The sentinel frame terminates the innermost end of the frame chain.
    If unwound, it returns the information needed to construct an
@@ -315,6 +318,14 @@ frame_stash_add (frame_info *frame)
   return true;
 }
 
+/* Counters of frame stash lookups, for "maint info perf-counters".  */
+
+static perf_counter frame_stash_hits_counter
+  ("frame-stash.hits", N_("Frame ID lookups found in the frame stash."));
+static perf_counter frame_stash_misses_counter
+  ("frame-stash.misses",
+   N_("Frame ID lookups that missed the frame stash."));
+
 /* Internal function to search the frame stash for an entry with the
    given frame ID.  If found, return that frame.  Otherwise return
    NULL.  */
@@ -327,6 +338,10 @@ frame_stash_find (struct frame_id id)
 
   dummy.this_id.value = id;
   frame = (frame_info *) htab_find (frame_stash, &dummy);
+  if (frame != nullptr)
+    ++frame_stash_hits_counter;
+  else
+    ++frame_stash_misses_counter;
   return frame_info_ptr (frame);
 }
 
@@ -340,6 +355,255 @@ frame_stash_invalidate (void)
   htab_empty (frame_stash);
 }
 
+/* The frames of a thread, other than the innermost one, are remembered
+   when the frame cache is invalidated.  When the thread stops again, a
+   frame with the same pc and ID as a remembered frame -- that is, the
+   same return address and CFA -- is taken to be that frame, still on
+   the stack, and is given the unwinder that claimed it before without
+   trying the others first.  The start of the function at a frame's
+   address is remembered too, saving a symbol lookup per frame.  This
+   way, after a "step" or "next", only the innermost frames cost as
+   much to unwind as they did the first time.  */
+
+/* A remembered frame: its pc and its ID.  */
+
+struct frame_memo_key
+{
+  CORE_ADDR pc;
+  frame_id id;
+
+  bool operator== (const frame_memo_key &other) const
+  {
+    return pc == other.pc && id == other.id;
+  }
+};
+
+/* Hash a frame_memo_key.  Only the stack address of the ID is used,
+   since frame IDs may have wildcard code and special addresses.  */
+
+struct frame_memo_key_hash
+{
+  size_t operator() (const frame_memo_key &key) const
+  {
+    return std::hash<CORE_ADDR> () (key.pc) * 31 + key.id.stack_addr;
+  }
+};
+
+/* What is remembered of the frames of a thread.  */
+
+struct frame_memo
+{
+  /* The thread's process target.  */
+  process_stratum_target *target = nullptr;
+
+  /* The remembered frames.  */
+  std::unordered_set<frame_memo_key, frame_memo_key_hash> frames;
+
+  /* For each pc of a remembered frame, the unwinder that claimed it,
+     or NULL if frames at that pc were claimed by different
+     unwinders.  */
+  std::unordered_map<CORE_ADDR, const frame_unwind *> unwinders;
+
+  /* The start of the function at an address in a frame, as found by
+     get_pc_function_start.  */
+  std::unordered_map<CORE_ADDR, CORE_ADDR> functions;
+};
+
+/* A thread's memo is emptied when it holds more frames than this, so
+   that it doesn't grow without bounds.  */
+
+static const size_t frame_memo_max_frames = 100000;
+
+/* Whether frames are remembered across stops, set by "maint set
+   frame-memo".  */
+
+static bool frame_memo_enabled = true;
+
+/* The frame memos, by thread.  */
+
+static std::unordered_map<ptid_t, frame_memo> frame_memos;
+
+/* The thread whose frames are in the frame cache, set when the
+   sentinel frame is created.  */
+
+static ptid_t frame_cache_ptid;
+static process_stratum_target *frame_cache_target;
+
+/* Counters of frames found in the memo, for "maint info
+   perf-counters".  */
+
+static perf_counter frame_memo_hits_counter
+  ("frame-memo.hits",
+   N_("Frames found still on the stack since the previous stop."));
+static perf_counter frame_memo_misses_counter
+  ("frame-memo.misses",
+   N_("Frames whose remembered unwinder had to be discarded."));
+
+/* Return the memo of the thread whose frames are in the frame cache,
+   or NULL.  If CREATE, create it if needed.  */
+
+static frame_memo *
+current_frame_memo (bool create)
+{
+  if (!frame_memo_enabled || frame_cache_target == nullptr)
+    return nullptr;
+
+  auto iter = frame_memos.find (frame_cache_ptid);
+  if (iter != frame_memos.end ()
+      && iter->second.target != frame_cache_target)
+    {
+      /* A thread of another target, with the same ptid.  */
+      frame_memos.erase (iter);
+      iter = frame_memos.end ();
+    }
+
+  if (iter == frame_memos.end ())
+    {
+      if (!create)
+	return nullptr;
+      iter = frame_memos.emplace (frame_cache_ptid, frame_memo ()).first;
+      iter->second.target = frame_cache_target;
+    }
+
+  return &iter->second;
+}
+
+/* Remember the frames in the frame cache, other than the innermost
+   one, before the frame cache is invalidated.  */
+
+static void
+frame_memo_remember_frames ()
+{
+  if (sentinel_frame == nullptr || sentinel_frame->prev == nullptr)
+    return;
+
+  frame_memo *memo = nullptr;
+  for (frame_info *fi = sentinel_frame->prev->prev_p
+			 ? sentinel_frame->prev->prev : nullptr;
+       fi != nullptr;
+       fi = fi->prev_p ? fi->prev : nullptr)
+    {
+      if (fi->this_id.p != frame_id_status::COMPUTED
+	  || fi->unwind == nullptr
+	  || (fi->unwind->type != NORMAL_FRAME
+	      && fi->unwind->type != SIGTRAMP_FRAME)
+	  || fi->next->prev_pc.status != CC_VALUE)
+	continue;
+
+      if (memo == nullptr)
+	{
+	  memo = current_frame_memo (true);
+	  if (memo == nullptr)
+	    return;
+	  if (memo->frames.size () > frame_memo_max_frames)
+	    {
+	      memo->frames.clear ();
+	      memo->unwinders.clear ();
+	      memo->functions.clear ();
+	    }
+	}
+
+      CORE_ADDR pc = fi->next->prev_pc.value;
+      memo->frames.insert ({pc, fi->this_id.value});
+
+      auto inserted = memo->unwinders.emplace (pc, fi->unwind);
+      if (!inserted.second && inserted.first->second != fi->unwind)
+	inserted.first->second = nullptr;
+    }
+}
+
+/* See frame.h.  */
+
+const struct frame_unwind *
+frame_remembered_unwinder (frame_info_ptr this_frame)
+{
+  if (this_frame->level < 1)
+    return nullptr;
+
+  frame_memo *memo = current_frame_memo (false);
+  CORE_ADDR pc;
+  if (memo == nullptr || !get_frame_pc_if_available (this_frame, &pc))
+    return nullptr;
+
+  auto iter = memo->unwinders.find (pc);
+  if (iter == memo->unwinders.end ())
+    return nullptr;
+  return iter->second;
+}
+
+/* See frame.h.  */
+
+bool
+frame_remembered_p (frame_info_ptr this_frame, const frame_id &id)
+{
+  frame_memo *memo = current_frame_memo (false);
+  CORE_ADDR pc;
+
+  if (memo != nullptr
+      && get_frame_pc_if_available (this_frame, &pc)
+      && memo->frames.find ({pc, id}) != memo->frames.end ())
+    {
+      ++frame_memo_hits_counter;
+      return true;
+    }
+
+  /* The caller computed ID with an unwinder that it is about to
+     discard.  THIS_FRAME's function depends on the unwinder (see
+     get_frame_address_in_block), so forget it.  */
+  this_frame->next->prev_func.status = CC_UNKNOWN;
+  this_frame->next->prev_func.addr = 0;
+
+  ++frame_memo_misses_counter;
+  return false;
+}
+
+/* Return the start of the function containing ADDR_IN_BLOCK, an
+   address in THIS_FRAME, using the memo if THIS_FRAME is not the
+   innermost frame.  */
+
+static CORE_ADDR
+frame_memo_function_start (frame_info_ptr this_frame, CORE_ADDR addr_in_block)
+{
+  frame_memo *memo = (this_frame->level >= 1
+		      ? current_frame_memo (false) : nullptr);
+  if (memo == nullptr)
+    return get_pc_function_start (addr_in_block);
+
+  auto iter = memo->functions.find (addr_in_block);
+  if (iter != memo->functions.end ())
+    return iter->second;
+
+  CORE_ADDR func = get_pc_function_start (addr_in_block);
+  if (func != 0)
+    memo->functions.emplace (addr_in_block, func);
+  return func;
+}
+
+/* See frame.h.  */
+
+void
+frame_memo_clear ()
+{
+  frame_memos.clear ();
+}
+
+/* Implement "maint set frame-memo".  */
+
+static void
+set_frame_memo (const char *args, int from_tty, struct cmd_list_element *c)
+{
+  frame_memo_clear ();
+}
+
+/* Implement "maint show frame-memo".  */
+
+static void
+show_frame_memo (struct ui_file *file, int from_tty,
+		 struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("Remembering frames across stops is %s.\n"), value);
+}
+
 /* See frame.h  */
 scoped_restore_selected_frame::scoped_restore_selected_frame ()
 {
@@ -1071,7 +1335,8 @@ get_frame_func_if_available (frame_info_ptr this_frame, CORE_ADDR *pc)
       else
 	{
 	  next_frame->prev_func.status = CC_VALUE;
-	  next_frame->prev_func.addr = get_pc_function_start (addr_in_block);
+	  next_frame->prev_func.addr
+	    = frame_memo_function_start (this_frame, addr_in_block);
 
 	  frame_debug_printf ("this_frame=%d -> %s",
 			      this_frame->level,
@@ -1686,9 +1951,13 @@ get_current_frame (void)
     validate_registers_access ();
 
   if (sentinel_frame == NULL)
-    sentinel_frame =
-      create_sentinel_frame (current_program_space, get_current_regcache (),
-			     0, 0).get ();
+    {
+      sentinel_frame =
+	create_sentinel_frame (current_program_space, get_current_regcache (),
+			       0, 0).get ();
+      frame_cache_ptid = inferior_ptid;
+      frame_cache_target = current_inferior ()->process_target ();
+    }
 
   /* Set the current frame before computing the frame id, to avoid
      recursion inside compute_frame_id, in case the frame's
@@ -2115,6 +2384,9 @@ reinit_frame_cache (void)
   /* Invalidate cache.  */
   if (sentinel_frame != nullptr)
     {
+      frame_memo_remember_frames ();
+      frame_cache_target = nullptr;
+
       /* If frame 0's id is not computed, it is not in the frame stash, so its
 	 dealloc functions will not be called when emptying the frame stash.
 	 Call frame_info_del manually in that case.  */
@@ -3342,6 +3614,24 @@ _initialize_frame ()
 
   gdb::observers::target_changed.attach (frame_observer_target_changed,
 					 "frame");
+  gdb::observers::new_objfile.attach ([] (struct objfile *objfile)
+    {
+      frame_memo_clear ();
+    }, "frame");
+  gdb::observers::free_objfile.attach ([] (struct objfile *objfile)
+    {
+      frame_memo_clear ();
+    }, "frame");
+  gdb::observers::thread_exit.attach ([] (thread_info *tp,
+					  gdb::optional<ULONGEST> exit_code,
+					  bool silent)
+    {
+      frame_memos.erase (tp->ptid);
+    }, "frame");
+  gdb::observers::inferior_exit.attach ([] (inferior *inf)
+    {
+      frame_memo_clear ();
+    }, "frame");
 
   add_setshow_prefix_cmd ("backtrace", class_maintenance,
 			  _("\
@@ -3380,4 +3670,16 @@ When non-zero, frame specific internal debugging is enabled."),
   add_cmd ("frame-id", class_maintenance, maintenance_print_frame_id,
 	   _("Print the current frame-id."),
 	   &maintenanceprintlist);
+
+  add_setshow_boolean_cmd ("frame-memo", class_maintenance,
+			   &frame_memo_enabled, _("\
+Set whether GDB remembers frames across stops."), _("\
+Show whether GDB remembers frames across stops."), _("\
+When on, GDB remembers the frames of each thread when the thread resumes.\n\
+When the thread stops again, frames that are still on the stack, with\n\
+the same pc and frame ID, are unwound with the unwinder that was chosen\n\
+for them before, without trying the other unwinders first."),
+			   set_frame_memo, show_frame_memo,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
 }
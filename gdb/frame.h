@@ -977,6 +977,29 @@ extern void frame_prepare_for_sniffer (frame_info_ptr frame,
 
 extern void frame_cleanup_after_sniffer (frame_info_ptr frame);
 
+/* Return the unwinder that claimed the frames at THIS_FRAME's pc the
+   last time the current thread stopped, or NULL.  Only frames other
+   than the innermost one are remembered.  */
+
+extern const struct frame_unwind *frame_remembered_unwinder
+  (frame_info_ptr this_frame);
+
+/* Return true if a frame with THIS_FRAME's pc and the frame ID ID was
+   on the stack the last time the current thread stopped.  ID is
+   THIS_FRAME's ID as computed by its remembered unwinder; if false is
+   returned, what THIS_FRAME cached about its function is discarded
+   too, since the caller is going to choose another unwinder.  */
+
+extern bool frame_remembered_p (frame_info_ptr this_frame,
+				const frame_id &id);
+
+/* Forget the frames remembered across stops, for all threads.  This
+   must be called when the set of unwinders changes, since a frame
+   remembered with an unwinder must not skip unwinders that were not
+   there when it was remembered.  */
+
+extern void frame_memo_clear ();
+
 /* Notes (cagney/2002-11-27, drow/2003-09-06):
 
    You might think that calls to this function can simply be replaced by a
@@ -33,6 +33,7 @@
 #include "gdbsupport/fileio.h"
 #include "inferior.h"
 #include "cli/cli-style.h"
+#include "trace-events.h"
 #include <unordered_map>
 
 /* An object of this type is stored in the section's user data when
@@ -478,6 +479,7 @@ gdb_bfd_open (const char *name, const char *target, int fd,
   bfd *abfd;
   struct gdb_bfd_cache_search search;
   struct stat st;
+  scoped_trace_event trace ("bfd", "open BFD", name);
 
   if (is_target_filename (name))
     {
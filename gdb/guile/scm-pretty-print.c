@@ -970,12 +970,17 @@ gdbscm_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   enum ext_lang_rc result = EXT_LANG_RC_NOP;
   enum guile_string_repr_result print_result;
 
-  if (value->lazy ())
-    value->fetch_lazy ();
+  /* A large array that is to be read piecemeal while it is printed
+     is left lazy, for a printer to read what it needs of it.  */
+  if (!val_print_array_in_chunks_p (value, language))
+    {
+      if (value->lazy ())
+	value->fetch_lazy ();
 
-  /* No pretty-printer support for unavailable values.  */
-  if (!value->bytes_available (0, type->length ()))
-    return EXT_LANG_RC_NOP;
+      /* No pretty-printer support for unavailable values.  */
+      if (!value->bytes_available (0, type->length ()))
+	return EXT_LANG_RC_NOP;
+    }
 
   if (!gdb_scheme_initialized)
     return EXT_LANG_RC_NOP;
@@ -104,6 +104,10 @@ struct linespec
      code to use the default symtab.  */
   std::vector<symtab *> file_symtabs;
 
+  /* If non-zero, FILE_SYMTABS was collected for this line, and may
+     lack the symtabs of the file that have no code for it.  */
+  int file_symtabs_line = 0;
+
   /* A list of matching function symbols and minimal symbols.  Both lists
      may be empty if no matching symbols were found.  */
   std::vector<block_symbol> function_symbols;
@@ -363,7 +367,7 @@ static std::vector<symtab_and_line> decode_objc (struct linespec_state *self,
 						 const char *arg);
 
 static std::vector<symtab *> symtabs_from_filename
-  (const char *, struct program_space *pspace);
+  (const char *, struct program_space *pspace, int line = 0);
 
 static std::vector<block_symbol> find_label_symbols
   (struct linespec_state *self,
@@ -397,7 +401,8 @@ static void add_all_symbol_names_from_pspace
 
 static std::vector<symtab *>
   collect_symtabs_from_filename (const char *file,
-				 struct program_space *pspace);
+				 struct program_space *pspace,
+				 int line = 0);
 
 static std::vector<symtab_and_line> decode_digits_ordinary
   (struct linespec_state *self,
@@ -2084,6 +2089,18 @@ create_sals_line_offset (struct linespec_state *self,
 
       std::vector<symtab_and_line> intermediate_results
 	= decode_digits_ordinary (self, ls, val.line, &best_entry);
+      if (intermediate_results.empty () && ls->file_symtabs_line != 0)
+	{
+	  /* The line has no code.  Look for the best alternative line
+	     in all the symtabs of the file, not only in those that were
+	     collected for the line.  */
+	  ls->file_symtabs
+	    = symtabs_from_filename (ls->explicit_loc.source_filename,
+				     self->search_pspace);
+	  ls->file_symtabs_line = 0;
+	  intermediate_results = decode_digits_ordinary (self, ls, val.line,
+							 &best_entry);
+	}
       if (intermediate_results.empty () && best_entry != NULL)
 	intermediate_results = decode_digits_ordinary (self, ls,
 						       best_entry->line,
@@ -2325,10 +2342,17 @@ convert_explicit_location_spec_to_linespec
 
   if (source_filename != NULL)
     {
+      /* When looking for a line of the file, only the symtabs with code
+	 for that line need to be found.  */
+      if (function_name == NULL && label_name == NULL
+	  && line_offset.sign == LINE_OFFSET_NONE && !self->list_mode)
+	result->file_symtabs_line = line_offset.offset;
+
       try
 	{
 	  result->file_symtabs
-	    = symtabs_from_filename (source_filename, self->search_pspace);
+	    = symtabs_from_filename (source_filename, self->search_pspace,
+				     result->file_symtabs_line);
 	}
       catch (const gdb_exception_error &except)
 	{
@@ -2444,6 +2468,28 @@ convert_explicit_location_spec_to_sals
    if no file is validly specified.  Callers must check that.
    Also, the line number returned may be invalid.  */
 
+/* If STREAM, the rest of a linespec after a file name, is a colon
+   followed by a plain line number that ends the linespec, return that
+   line number.  Otherwise, return zero.  */
+
+static int
+linespec_peek_line_number (const char *stream)
+{
+  stream = skip_spaces (stream);
+  if (*stream != ':')
+    return 0;
+  stream = skip_spaces (stream + 1);
+  if (!isdigit (*stream))
+    return 0;
+
+  char *end;
+  unsigned long line = strtoul (stream, &end, 10);
+  if ((*end != '\0' && !isspace (*end)) || line > INT_MAX)
+    return 0;
+
+  return line;
+}
+
 /* Parse the linespec in ARG, which must not be nullptr.  MATCH_TYPE
    indicates how function names should be matched.  */
 
@@ -2550,12 +2596,20 @@ parse_linespec (linespec_parser *parser, const char *arg,
       token = linespec_lexer_lex_one (parser);
       gdb::unique_xmalloc_ptr<char> user_filename = copy_token_string (token);
 
+      /* If a plain line number follows, only the symtabs with code for
+	 that line need to be found.  */
+      if (!PARSER_STATE (parser)->list_mode
+	  && parser->completion_tracker == NULL)
+	PARSER_RESULT (parser)->file_symtabs_line
+	  = linespec_peek_line_number (PARSER_STREAM (parser));
+
       /* Check if the input is a filename.  */
       try
 	{
 	  PARSER_RESULT (parser)->file_symtabs
 	    = symtabs_from_filename (user_filename.get (),
-				     PARSER_STATE (parser)->search_pspace);
+				     PARSER_STATE (parser)->search_pspace,
+				     PARSER_RESULT (parser)->file_symtabs_line);
 	}
       catch (gdb_exception_error &ex)
 	{
@@ -3689,11 +3743,13 @@ symtab_collector::operator () (struct symtab *symtab)
 
 /* Given a file name, return a list of all matching symtabs.  If
    SEARCH_PSPACE is not NULL, the search is restricted to just that
-   program space.  */
+   program space.  If LINE is positive, symtabs that are known to have
+   no code for LINE may be left out, unless that leaves none.  */
 
 static std::vector<symtab *>
 collect_symtabs_from_filename (const char *file,
-			       struct program_space *search_pspace)
+			       struct program_space *search_pspace,
+			       int line)
 {
   symtab_collector collector;
 
@@ -3706,27 +3762,32 @@ collect_symtabs_from_filename (const char *file,
 	    continue;
 
 	  set_current_program_space (pspace);
-	  iterate_over_symtabs (file, collector);
+	  iterate_over_symtabs (file, collector, line);
 	}
     }
   else
     {
       set_current_program_space (search_pspace);
-      iterate_over_symtabs (file, collector);
+      iterate_over_symtabs (file, collector, line);
     }
 
-  return collector.release_symtabs ();
+  std::vector<symtab *> result = collector.release_symtabs ();
+  if (result.empty () && line > 0)
+    return collect_symtabs_from_filename (file, search_pspace, 0);
+  return result;
 }
 
 /* Return all the symtabs associated to the FILENAME.  If SEARCH_PSPACE is
-   not NULL, the search is restricted to just that program space.  */
+   not NULL, the search is restricted to just that program space.  LINE
+   is as for collect_symtabs_from_filename.  */
 
 static std::vector<symtab *>
 symtabs_from_filename (const char *filename,
-		       struct program_space *search_pspace)
+		       struct program_space *search_pspace,
+		       int line)
 {
   std::vector<symtab *> result
-    = collect_symtabs_from_filename (filename, search_pspace);
+    = collect_symtabs_from_filename (filename, search_pspace, line);
 
   if (result.empty ())
     {
@@ -41,7 +41,7 @@ struct macro_table
 
   /* The bcache we should use to hold macro names, argument names, and
      definitions, or zero if we should use xmalloc.  */
-  gdb::bcache *bcache;
+  gdb::concurrent_bcache *bcache;
 
   /* The main source file for this compilation unit --- the one whose
      name was given to the compiler.  This is the root of the
@@ -1020,7 +1020,7 @@ macro_for_each_in_scope (struct macro_source_file *file, int line,
 
 
 struct macro_table *
-new_macro_table (struct obstack *obstack, gdb::bcache *b,
+new_macro_table (struct obstack *obstack, gdb::concurrent_bcache *b,
 		 struct compunit_symtab *cust)
 {
   struct macro_table *t;
@@ -42,6 +42,7 @@
 #include "gdbsupport/selftest.h"
 #include "inferior.h"
 #include "gdbsupport/thread-pool.h"
+#include "gdbsupport/parallel-for.h"
 
 #include "cli/cli-decode.h"
 #include "cli/cli-utils.h"
@@ -1458,6 +1459,16 @@ such as demangling symbol names."),
 				       &maintenance_set_cmdlist,
 				       &maintenance_show_cmdlist);
 
+  add_setshow_boolean_cmd ("parallel-for", class_maintenance,
+			   &gdb::parallel_for_each_debug, _("\
+Set parallel-for debugging."), _("\
+Show parallel-for debugging."), _("\
+When on, GDB prints how the work of each parallel loop is split\n\
+across the worker threads, and how long each thread took."),
+			   nullptr,
+			   nullptr,
+			   &setdebuglist, &showdebuglist);
+
   /* Add the "maint set/show selftest" commands.  */
   static cmd_list_element *set_selftest_cmdlist = nullptr;
   static cmd_list_element *show_selftest_cmdlist = nullptr;
@@ -21,6 +21,7 @@
 #include "mi-cmds.h"
 #include "ada-lang.h"
 #include "arch-utils.h"
+#include "perf-counters.h"
 
 /* Implement the "-info-ada-exceptions" GDB/MI command.  */
 
@@ -106,3 +107,23 @@ mi_cmd_info_os (const char *command, const char *const *argv, int argc)
       break;
     }
 }
+
+/* Implement the "-info-perf-counters" GDB/MI command.  */
+
+void
+mi_cmd_info_perf_counters (const char *command, const char *const *argv,
+			   int argc)
+{
+  switch (argc)
+    {
+    case 0:
+      print_perf_counters (current_uiout, nullptr);
+      break;
+    case 1:
+      print_perf_counters (current_uiout, argv[0]);
+      break;
+    default:
+      error (_("Usage: -info-perf-counters [REGEXP]"));
+      break;
+    }
+}
@@ -38,6 +38,8 @@
 #include "gdbsupport/gdb-safe-ctype.h"
 #include "inferior.h"
 #include "observable.h"
+#include "stack-groups.h"
+#include "source.h"
 
 enum what_to_list { locals, arguments, all };
 
@@ -212,6 +214,63 @@ mi_cmd_stack_info_depth (const char *command, const char *const *argv,
   current_uiout->field_signed ("depth", i);
 }
 
+/* Print the backtraces of all the stopped threads, grouping threads
+   with identical backtraces together.  With an argument, print at most
+   that many frames of each thread.  */
+
+void
+mi_cmd_stack_list_all_threads (const char *command, const char *const *argv,
+			       int argc)
+{
+  struct ui_out *uiout = current_uiout;
+  int max_depth = -1;
+
+  if (argc > 1)
+    error (_("-stack-list-all-threads: Usage: [MAX_DEPTH]"));
+
+  if (argc == 1)
+    max_depth = atoi (argv[0]);
+
+  stack_groups stacks = collect_stack_groups (max_depth);
+
+  ui_out_emit_list groups_emitter (uiout, "groups");
+  for (const stack_group &group : stacks.groups)
+    {
+      ui_out_emit_tuple group_emitter (uiout, "group");
+
+      {
+	ui_out_emit_tuple ids_emitter (uiout, "thread-ids");
+	for (const thread_info_ref &tp : group.threads)
+	  uiout->field_signed ("thread-id", tp->global_num);
+      }
+
+      ui_out_emit_list frames_emitter (uiout, "frames");
+      for (int level = 0; level < group.frames.size (); ++level)
+	{
+	  const stack_location &loc = stacks.locations[group.frames[level]];
+	  ui_out_emit_tuple frame_emitter (uiout, "frame");
+
+	  uiout->field_signed ("level", level);
+	  uiout->field_core_addr ("addr", loc.gdbarch, loc.pc);
+
+	  const char *funname = loc.function_name ();
+	  if (funname != nullptr)
+	    uiout->field_string ("func", funname);
+
+	  if (loc.symtab != nullptr)
+	    {
+	      uiout->field_string ("file",
+				   symtab_to_filename_for_display (loc.symtab));
+	      uiout->field_string ("fullname", symtab_to_fullname (loc.symtab));
+	      uiout->field_signed ("line", loc.line);
+	    }
+
+	  if (loc.solib != nullptr)
+	    uiout->field_string ("from", loc.solib);
+	}
+    }
+}
+
 /* Print a list of the locals for the current frame.  With argument of
    0, print only the names, with argument of 1 print also the
    values.  */
@@ -33,9 +33,20 @@
 #include "gdbsupport/gdb_optional.h"
 #include "inferior.h"
 
+/* The time spent updating one root varobj, and the work done, as
+   reported by -var-update when -enable-timings is in effect.  */
+
+struct mi_var_update_timing
+{
+  std::string name;
+  std::chrono::steady_clock::duration wallclock;
+  varobj_update_stats stats;
+};
+
 static void varobj_update_one (struct varobj *var,
 			       enum print_values print_values,
-			       bool is_explicit);
+			       bool is_explicit,
+			       std::vector<mi_var_update_timing> *timings);
 
 static int mi_print_value_p (struct varobj *var,
 			     enum print_values print_values);
@@ -601,7 +612,8 @@ mi_cmd_var_assign (const char *command, const char *const *argv, int argc)
 
 static void
 mi_cmd_var_update_iter (struct varobj *var, bool only_floating,
-			enum print_values print_values)
+			enum print_values print_values,
+			std::vector<mi_var_update_timing> *timings)
 {
   bool thread_stopped;
 
@@ -622,7 +634,7 @@ mi_cmd_var_update_iter (struct varobj *var, bool only_floating,
 
   if (thread_stopped
       && (!only_floating || varobj_floating_p (var)))
-    varobj_update_one (var, print_values, false /* implicit */);
+    varobj_update_one (var, print_values, false /* implicit */, timings);
 }
 
 void
@@ -645,26 +657,57 @@ mi_cmd_var_update (const char *command, const char *const *argv, int argc)
   else
     print_values = PRINT_NO_VALUES;
 
-  ui_out_emit_list list_emitter (uiout, "changelist");
+  std::vector<mi_var_update_timing> timings;
+  std::vector<mi_var_update_timing> *timings_ptr
+    = mi_timings_enabled_p () ? &timings : nullptr;
 
-  /* Check if the parameter is a "*", which means that we want to
-     update all variables.  */
-
-  if ((*name == '*' || *name == '@') && (*(name + 1) == '\0'))
-    {
-      /* varobj_update_one automatically updates all the children of
-	 VAROBJ.  Therefore update each VAROBJ only once by iterating
-	 only the root VAROBJs.  */
-
-      all_root_varobjs ([=] (varobj *var)
-	{ mi_cmd_var_update_iter (var, *name == '0', print_values); });
-    }
-  else
+  {
+    ui_out_emit_list list_emitter (uiout, "changelist");
+
+    /* Check if the parameter is a "*", which means that we want to
+       update all variables.  */
+
+    if ((*name == '*' || *name == '@') && (*(name + 1) == '\0'))
+      {
+	/* Read the memory behind all the root values at once, rather
+	   than once per root.  */
+	scoped_varobj_prefetch prefetch;
+
+	/* varobj_update_one automatically updates all the children of
+	   VAROBJ.  Therefore update each VAROBJ only once by iterating
+	   only the root VAROBJs.  */
+
+	all_root_varobjs ([=] (varobj *var)
+	  {
+	    mi_cmd_var_update_iter (var, *name == '0', print_values,
+				    timings_ptr);
+	  });
+      }
+    else
+      {
+	/* Get varobj handle, if a valid var obj name was specified.  */
+	struct varobj *var = varobj_get_handle (name);
+
+	varobj_update_one (var, print_values, true /* explicit */,
+			   timings_ptr);
+      }
+  }
+
+  if (timings_ptr != nullptr)
     {
-      /* Get varobj handle, if a valid var obj name was specified.  */
-      struct varobj *var = varobj_get_handle (name);
+      ui_out_emit_list list_emitter (uiout, "update-timings");
 
-      varobj_update_one (var, print_values, true /* explicit */);
+      for (const mi_var_update_timing &t : timings)
+	{
+	  using namespace std::chrono;
+
+	  ui_out_emit_tuple tuple_emitter (uiout, nullptr);
+	  uiout->field_string ("name", t.name);
+	  uiout->field_fmt ("wallclock", "%0.5f",
+			    duration<double> (t.wallclock).count ());
+	  uiout->field_signed ("updated", t.stats.updated);
+	  uiout->field_signed ("skipped", t.stats.skipped);
+	}
     }
 }
 
@@ -672,11 +715,27 @@ mi_cmd_var_update (const char *command, const char *const *argv, int argc)
 
 static void
 varobj_update_one (struct varobj *var, enum print_values print_values,
-		   bool is_explicit)
+		   bool is_explicit,
+		   std::vector<mi_var_update_timing> *timings)
 {
   struct ui_out *uiout = current_uiout;
+  std::vector<varobj_update_result> changes;
+
+  if (timings != nullptr)
+    {
+      using namespace std::chrono;
 
-  std::vector<varobj_update_result> changes = varobj_update (&var, is_explicit);
+      mi_var_update_timing t;
+      t.name = varobj_get_objname (var);
+
+      steady_clock::time_point start = steady_clock::now ();
+      changes = varobj_update (&var, is_explicit, &t.stats);
+      t.wallclock = steady_clock::now () - start;
+
+      timings->push_back (std::move (t));
+    }
+  else
+    changes = varobj_update (&var, is_explicit);
   
   for (const varobj_update_result &r : changes)
     {
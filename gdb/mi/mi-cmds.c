@@ -296,6 +296,7 @@ add_builtin_mi_commands ()
   add_mi_cmd_mi ("info-ada-exceptions", mi_cmd_info_ada_exceptions);
   add_mi_cmd_mi ("info-gdb-mi-command", mi_cmd_info_gdb_mi_command);
   add_mi_cmd_mi ("info-os", mi_cmd_info_os);
+  add_mi_cmd_mi ("info-perf-counters", mi_cmd_info_perf_counters);
   add_mi_cmd_mi ("interpreter-exec", mi_cmd_interpreter_exec);
   add_mi_cmd_mi ("list-features", mi_cmd_list_features);
   add_mi_cmd_mi ("list-target-features", mi_cmd_list_target_features);
@@ -303,6 +304,7 @@ add_builtin_mi_commands ()
   add_mi_cmd_mi ("remove-inferior", mi_cmd_remove_inferior);
   add_mi_cmd_mi ("stack-info-depth", mi_cmd_stack_info_depth);
   add_mi_cmd_mi ("stack-info-frame", mi_cmd_stack_info_frame);
+  add_mi_cmd_mi ("stack-list-all-threads", mi_cmd_stack_list_all_threads);
   add_mi_cmd_mi ("stack-list-arguments", mi_cmd_stack_list_args);
   add_mi_cmd_mi ("stack-list-frames", mi_cmd_stack_list_frames);
   add_mi_cmd_mi ("stack-list-locals", mi_cmd_stack_list_locals);
@@ -2287,6 +2287,14 @@ mi_print_timing_maybe (struct ui_file *file)
     print_diff_now (file, current_command_ts);
 }
 
+/* See mi-main.h.  */
+
+bool
+mi_timings_enabled_p ()
+{
+  return do_timings;
+}
+
 static void
 print_diff (struct ui_file *file, struct mi_timestamp *start,
 	    struct mi_timestamp *end)
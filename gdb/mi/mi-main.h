@@ -30,6 +30,10 @@ extern void mi_load_progress (const char *section_name,
 
 extern void mi_print_timing_maybe (struct ui_file *file);
 
+/* Return true if -enable-timings is in effect.  */
+
+extern bool mi_timings_enabled_p ();
+
 /* Whether MI is in async mode.  */
 
 extern int mi_async_p (void);
@@ -50,11 +50,13 @@
 #include "cp-support.h"
 #include "language.h"
 #include "cli/cli-utils.h"
+#include "gdbcmd.h"
 #include "gdbsupport/symbol.h"
 #include <algorithm>
 #include "gdbsupport/gdb-safe-ctype.h"
 #include "gdbsupport/parallel-for.h"
 #include "inferior.h"
+#include "trace-events.h"
 
 #if CXX_STD_THREAD
 #include <mutex>
@@ -734,6 +736,321 @@ msym_prefer_to_msym_type (lookup_msym_prefer prefer)
   gdb_assert_not_reached ("unhandled lookup_msym_prefer");
 }
 
+/* Search the minimal symbols of OBJFILE for the one that
+   lookup_minimal_symbol_by_pc_section should return for UNREL_PC,
+   SECTION and WANT_TYPE.  Return its index, or -1 if there is none.
+   In the latter case, set *PREVIOUS to the index of the closest symbol
+   before UNREL_PC that should be reported as the previous symbol, or
+   to -1.
+
+   This only reads the minimal symbols and sections of OBJFILE, so it
+   can be called from worker threads.  */
+
+static int
+search_msymbols_by_pc (struct objfile *objfile, unrelocated_addr unrel_pc,
+		       struct obj_section *section,
+		       minimal_symbol_type want_type, int *previous)
+{
+  int lo;
+  int hi;
+  int newobj;
+  int best_zero_sized = -1;
+  const minimal_symbol *msymbol = objfile->per_bfd->msymbols.get ();
+
+  *previous = -1;
+
+  lo = 0;
+  hi = objfile->per_bfd->minimal_symbol_count - 1;
+
+  /* This code assumes that the minimal symbols are sorted by
+     ascending address values.  If the pc value is greater than or
+     equal to the first symbol's address, then some symbol in this
+     minimal symbol table is a suitable candidate for being the
+     "best" symbol.  This includes the last real symbol, for cases
+     where the pc value is larger than any address in this vector.
+
+     By iterating until the address associated with the current
+     hi index (the endpoint of the test interval) is less than
+     or equal to the desired pc value, we accomplish two things:
+     (1) the case where the pc value is larger than any minimal
+     symbol address is trivially solved, (2) the address associated
+     with the hi index is always the one we want when the iteration
+     terminates.  In essence, we are iterating the test interval
+     down until the pc value is pushed out of it from the high end.
+
+     Warning: this code is trickier than it would appear at first.  */
+
+  if (hi < 0 || unrel_pc < msymbol[lo].unrelocated_address ())
+    return -1;
+
+  while (msymbol[hi].unrelocated_address () > unrel_pc)
+    {
+      /* pc is still strictly less than highest address.  */
+      /* Note "new" will always be >= lo.  */
+      newobj = (lo + hi) / 2;
+      if ((msymbol[newobj].unrelocated_address () >= unrel_pc)
+	  || (lo == newobj))
+	{
+	  hi = newobj;
+	}
+      else
+	{
+	  lo = newobj;
+	}
+    }
+
+  /* If we have multiple symbols at the same address, we want
+     hi to point to the last one.  That way we can find the
+     right symbol if it has an index greater than hi.  */
+  while (hi < objfile->per_bfd->minimal_symbol_count - 1
+	 && (msymbol[hi].unrelocated_address ()
+	     == msymbol[hi + 1].unrelocated_address ()))
+    hi++;
+
+  /* Skip various undesirable symbols.  */
+  while (hi >= 0)
+    {
+      /* Skip any absolute symbols.  This is apparently
+	 what adb and dbx do, and is needed for the CM-5.
+	 There are two known possible problems: (1) on
+	 ELF, apparently end, edata, etc. are absolute.
+	 Not sure ignoring them here is a big deal, but if
+	 we want to use them, the fix would go in
+	 elfread.c.  (2) I think shared library entry
+	 points on the NeXT are absolute.  If we want
+	 special handling for this it probably should be
+	 triggered by a special mst_abs_or_lib or some
+	 such.  */
+
+      if (msymbol[hi].type () == mst_abs)
+	{
+	  hi--;
+	  continue;
+	}
+
+      /* If SECTION was specified, skip any symbol from
+	 wrong section.  */
+      if (section
+	  /* Some types of debug info, such as COFF,
+	     don't fill the bfd_section member, so don't
+	     throw away symbols on those platforms.  */
+	  && msymbol[hi].obj_section (objfile) != nullptr
+	  && (!matching_obj_sections
+	      (msymbol[hi].obj_section (objfile),
+	       section)))
+	{
+	  hi--;
+	  continue;
+	}
+
+      /* If we are looking for a trampoline and this is a
+	 text symbol, or the other way around, check the
+	 preceding symbol too.  If they are otherwise
+	 identical prefer that one.  */
+      if (hi > 0
+	  && msymbol[hi].type () != want_type
+	  && msymbol[hi - 1].type () == want_type
+	  && (msymbol[hi].size () == msymbol[hi - 1].size ())
+	  && (msymbol[hi].unrelocated_address ()
+	      == msymbol[hi - 1].unrelocated_address ())
+	  && (msymbol[hi].obj_section (objfile)
+	      == msymbol[hi - 1].obj_section (objfile)))
+	{
+	  hi--;
+	  continue;
+	}
+
+      /* If the minimal symbol has a zero size, save it
+	 but keep scanning backwards looking for one with
+	 a non-zero size.  A zero size may mean that the
+	 symbol isn't an object or function (e.g. a
+	 label), or it may just mean that the size was not
+	 specified.  */
+      if (msymbol[hi].size () == 0)
+	{
+	  if (best_zero_sized == -1)
+	    best_zero_sized = hi;
+	  hi--;
+	  continue;
+	}
+
+      /* If we are past the end of the current symbol, try
+	 the previous symbol if it has a larger overlapping
+	 size.  This happens on i686-pc-linux-gnu with glibc;
+	 the nocancel variants of system calls are inside
+	 the cancellable variants, but both have sizes.  */
+      if (hi > 0
+	  && msymbol[hi].size () != 0
+	  && unrel_pc >= msymbol[hi].unrelocated_end_address ()
+	  && unrel_pc < msymbol[hi - 1].unrelocated_end_address ())
+	{
+	  hi--;
+	  continue;
+	}
+
+      /* Otherwise, this symbol must be as good as we're going
+	 to get.  */
+      break;
+    }
+
+  /* If HI has a zero size, and best_zero_sized is set,
+     then we had two or more zero-sized symbols; prefer
+     the first one we found (which may have a higher
+     address).  Also, if we ran off the end, be sure
+     to back up.  */
+  if (best_zero_sized != -1
+      && (hi < 0 || msymbol[hi].size () == 0))
+    hi = best_zero_sized;
+
+  /* If the minimal symbol has a non-zero size, and this
+     PC appears to be outside the symbol's contents, then
+     refuse to use this symbol.  If we found a zero-sized
+     symbol with an address greater than this symbol's,
+     use that instead.  We assume that if symbols have
+     specified sizes, they do not overlap.  */
+
+  if (hi >= 0
+      && msymbol[hi].size () != 0
+      && unrel_pc >= msymbol[hi].unrelocated_end_address ())
+    {
+      if (best_zero_sized != -1)
+	hi = best_zero_sized;
+      else
+	{
+	  /* This symbol is the closest previous symbol.  */
+	  *previous = hi;
+	  return -1;
+	}
+    }
+
+  return hi;
+}
+
+/* Whether lookup_minimal_symbol_by_pc_section uses the per-section
+   indexes built by build_msymbol_pc_index.  */
+
+static bool use_msymbol_pc_index = true;
+
+/* Build the minimal_symbol_pc_index of each section of OBJFILE, whose
+   minimal symbols have just been installed.  */
+
+static void
+build_msymbol_pc_index (struct objfile *objfile)
+{
+  objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+  const minimal_symbol *msymbols = per_bfd->msymbols.get ();
+  int count = per_bfd->minimal_symbol_count;
+
+  per_bfd->msymbol_pc_index.clear ();
+  if (count == 0)
+    return;
+
+  /* The answer for an address can only change at the start or the end
+     of a minimal symbol.  The starts are already sorted; sort the
+     ends too.  */
+  std::vector<unrelocated_addr> ends;
+  for (int i = 0; i < count; ++i)
+    if (msymbols[i].size () != 0)
+      ends.push_back (msymbols[i].unrelocated_end_address ());
+  std::sort (ends.begin (), ends.end ());
+
+  per_bfd->msymbol_pc_index.resize (objfile->sections_end
+				     - objfile->sections_start);
+
+  for (obj_section *osect : objfile->sections ())
+    {
+      minimal_symbol_pc_index &index
+	= per_bfd->msymbol_pc_index[osect - objfile->sections_start];
+      asection *bfd_sect = osect->the_bfd_section;
+      unrelocated_addr lo = unrelocated_addr (bfd_section_vma (bfd_sect));
+      unrelocated_addr hi
+	= unrelocated_addr (bfd_section_vma (bfd_sect)
+			    + bfd_section_size (bfd_sect));
+      if (hi <= lo)
+	continue;
+
+      /* Collect the addresses within the section where the answer may
+	 change.  */
+      std::vector<unrelocated_addr> points;
+      points.push_back (lo);
+
+      auto first = std::upper_bound (msymbols, msymbols + count, lo,
+				     [] (unrelocated_addr addr,
+					 const minimal_symbol &msym)
+				     {
+				       return addr < msym.unrelocated_address ();
+				     });
+      for (auto iter = first;
+	   iter < msymbols + count && iter->unrelocated_address () < hi;
+	   ++iter)
+	points.push_back (iter->unrelocated_address ());
+
+      for (auto iter = std::upper_bound (ends.begin (), ends.end (), lo);
+	   iter != ends.end () && *iter < hi;
+	   ++iter)
+	points.push_back (*iter);
+
+      std::sort (points.begin (), points.end ());
+      points.erase (std::unique (points.begin (), points.end ()),
+		    points.end ());
+
+      /* Compute the answer at each point.  */
+      std::vector<minimal_symbol_pc_index::result> results (points.size ());
+      gdb::parallel_for_each (1000, points.begin (), points.end (),
+	[&] (std::vector<unrelocated_addr>::iterator start,
+	     std::vector<unrelocated_addr>::iterator end)
+	{
+	  for (auto iter = start; iter < end; ++iter)
+	    {
+	      minimal_symbol_pc_index::result &r
+		= results[iter - points.begin ()];
+	      r.found = search_msymbols_by_pc (objfile, *iter, osect,
+					       mst_text, &r.previous);
+	    }
+	});
+
+      /* Merge neighboring ranges with the same answer.  */
+      for (size_t i = 0; i < points.size (); ++i)
+	{
+	  if (!index.results.empty () && index.results.back () == results[i])
+	    continue;
+	  index.starts.push_back (points[i]);
+	  index.results.push_back (results[i]);
+	}
+      index.starts.shrink_to_fit ();
+      index.results.shrink_to_fit ();
+      index.end = hi;
+    }
+}
+
+/* Look up UNREL_PC in the minimal_symbol_pc_index of SECTION, an
+   obj_section of OBJFILE.  If the index covers UNREL_PC, store the
+   answer in *RESULT and return true.  */
+
+static bool
+lookup_msymbol_pc_index (struct objfile *objfile, struct obj_section *section,
+			 unrelocated_addr unrel_pc,
+			 minimal_symbol_pc_index::result *result)
+{
+  if (!use_msymbol_pc_index || section->objfile != objfile)
+    return false;
+
+  size_t idx = section - objfile->sections_start;
+  if (idx >= objfile->per_bfd->msymbol_pc_index.size ())
+    return false;
+
+  const minimal_symbol_pc_index &index
+    = objfile->per_bfd->msymbol_pc_index[idx];
+  if (index.starts.empty ()
+      || unrel_pc < index.starts[0] || unrel_pc >= index.end)
+    return false;
+
+  auto iter = std::upper_bound (index.starts.begin (), index.starts.end (),
+				unrel_pc);
+  *result = index.results[iter - index.starts.begin () - 1];
+  return true;
+}
+
 /* See minsyms.h.
 
    Note that we need to look through ALL the minimal symbol tables
@@ -747,10 +1064,6 @@ lookup_minimal_symbol_by_pc_section (CORE_ADDR pc_in, struct obj_section *sectio
 				     lookup_msym_prefer prefer,
 				     bound_minimal_symbol *previous)
 {
-  int lo;
-  int hi;
-  int newobj;
-  struct minimal_symbol *msymbol;
   struct minimal_symbol *best_symbol = NULL;
   struct objfile *best_objfile = NULL;
   struct bound_minimal_symbol result;
@@ -783,204 +1096,53 @@ lookup_minimal_symbol_by_pc_section (CORE_ADDR pc_in, struct obj_section *sectio
 
   for (objfile *objfile : section->objfile->separate_debug_objfiles ())
     {
-      CORE_ADDR pc = pc_in;
-
-      /* If this objfile has a minimal symbol table, go search it
-	 using a binary search.  */
+      /* If this objfile has a minimal symbol table, go search it,
+	 using the precomputed index of SECTION if there is one.  */
 
       if (objfile->per_bfd->minimal_symbol_count > 0)
 	{
-	  int best_zero_sized = -1;
-
-	  msymbol = objfile->per_bfd->msymbols.get ();
-	  lo = 0;
-	  hi = objfile->per_bfd->minimal_symbol_count - 1;
-
-	  /* This code assumes that the minimal symbols are sorted by
-	     ascending address values.  If the pc value is greater than or
-	     equal to the first symbol's address, then some symbol in this
-	     minimal symbol table is a suitable candidate for being the
-	     "best" symbol.  This includes the last real symbol, for cases
-	     where the pc value is larger than any address in this vector.
-
-	     By iterating until the address associated with the current
-	     hi index (the endpoint of the test interval) is less than
-	     or equal to the desired pc value, we accomplish two things:
-	     (1) the case where the pc value is larger than any minimal
-	     symbol address is trivially solved, (2) the address associated
-	     with the hi index is always the one we want when the iteration
-	     terminates.  In essence, we are iterating the test interval
-	     down until the pc value is pushed out of it from the high end.
-
-	     Warning: this code is trickier than it would appear at first.  */
-
+	  struct minimal_symbol *msymbol = objfile->per_bfd->msymbols.get ();
 	  unrelocated_addr unrel_pc;
-	  if (frob_address (objfile, pc, &unrel_pc)
-	      && unrel_pc >= msymbol[lo].unrelocated_address ())
-	    {
-	      while (msymbol[hi].unrelocated_address () > unrel_pc)
-		{
-		  /* pc is still strictly less than highest address.  */
-		  /* Note "new" will always be >= lo.  */
-		  newobj = (lo + hi) / 2;
-		  if ((msymbol[newobj].unrelocated_address () >= unrel_pc)
-		      || (lo == newobj))
-		    {
-		      hi = newobj;
-		    }
-		  else
-		    {
-		      lo = newobj;
-		    }
-		}
-
-	      /* If we have multiple symbols at the same address, we want
-		 hi to point to the last one.  That way we can find the
-		 right symbol if it has an index greater than hi.  */
-	      while (hi < objfile->per_bfd->minimal_symbol_count - 1
-		     && (msymbol[hi].unrelocated_address ()
-			 == msymbol[hi + 1].unrelocated_address ()))
-		hi++;
-
-	      /* Skip various undesirable symbols.  */
-	      while (hi >= 0)
-		{
-		  /* Skip any absolute symbols.  This is apparently
-		     what adb and dbx do, and is needed for the CM-5.
-		     There are two known possible problems: (1) on
-		     ELF, apparently end, edata, etc. are absolute.
-		     Not sure ignoring them here is a big deal, but if
-		     we want to use them, the fix would go in
-		     elfread.c.  (2) I think shared library entry
-		     points on the NeXT are absolute.  If we want
-		     special handling for this it probably should be
-		     triggered by a special mst_abs_or_lib or some
-		     such.  */
-
-		  if (msymbol[hi].type () == mst_abs)
-		    {
-		      hi--;
-		      continue;
-		    }
 
-		  /* If SECTION was specified, skip any symbol from
-		     wrong section.  */
-		  if (section
-		      /* Some types of debug info, such as COFF,
-			 don't fill the bfd_section member, so don't
-			 throw away symbols on those platforms.  */
-		      && msymbol[hi].obj_section (objfile) != nullptr
-		      && (!matching_obj_sections
-			  (msymbol[hi].obj_section (objfile),
-			   section)))
-		    {
-		      hi--;
-		      continue;
-		    }
-
-		  /* If we are looking for a trampoline and this is a
-		     text symbol, or the other way around, check the
-		     preceding symbol too.  If they are otherwise
-		     identical prefer that one.  */
-		  if (hi > 0
-		      && msymbol[hi].type () != want_type
-		      && msymbol[hi - 1].type () == want_type
-		      && (msymbol[hi].size () == msymbol[hi - 1].size ())
-		      && (msymbol[hi].unrelocated_address ()
-			  == msymbol[hi - 1].unrelocated_address ())
-		      && (msymbol[hi].obj_section (objfile)
-			  == msymbol[hi - 1].obj_section (objfile)))
-		    {
-		      hi--;
-		      continue;
-		    }
+	  if (!frob_address (objfile, pc_in, &unrel_pc))
+	    continue;
 
-		  /* If the minimal symbol has a zero size, save it
-		     but keep scanning backwards looking for one with
-		     a non-zero size.  A zero size may mean that the
-		     symbol isn't an object or function (e.g. a
-		     label), or it may just mean that the size was not
-		     specified.  */
-		  if (msymbol[hi].size () == 0)
-		    {
-		      if (best_zero_sized == -1)
-			best_zero_sized = hi;
-		      hi--;
-		      continue;
-		    }
+	  minimal_symbol_pc_index::result found;
+	  if (prefer != lookup_msym_prefer::TEXT
+	      || !lookup_msymbol_pc_index (objfile, section, unrel_pc, &found))
+	    found.found = search_msymbols_by_pc (objfile, unrel_pc, section,
+						 want_type, &found.previous);
 
-		  /* If we are past the end of the current symbol, try
-		     the previous symbol if it has a larger overlapping
-		     size.  This happens on i686-pc-linux-gnu with glibc;
-		     the nocancel variants of system calls are inside
-		     the cancellable variants, but both have sizes.  */
-		  if (hi > 0
-		      && msymbol[hi].size () != 0
-		      && unrel_pc >= msymbol[hi].unrelocated_end_address ()
-		      && unrel_pc < msymbol[hi - 1].unrelocated_end_address ())
-		    {
-		      hi--;
-		      continue;
-		    }
-
-		  /* Otherwise, this symbol must be as good as we're going
-		     to get.  */
-		  break;
-		}
-
-	      /* If HI has a zero size, and best_zero_sized is set,
-		 then we had two or more zero-sized symbols; prefer
-		 the first one we found (which may have a higher
-		 address).  Also, if we ran off the end, be sure
-		 to back up.  */
-	      if (best_zero_sized != -1
-		  && (hi < 0 || msymbol[hi].size () == 0))
-		hi = best_zero_sized;
-
-	      /* If the minimal symbol has a non-zero size, and this
-		 PC appears to be outside the symbol's contents, then
-		 refuse to use this symbol.  If we found a zero-sized
-		 symbol with an address greater than this symbol's,
-		 use that instead.  We assume that if symbols have
-		 specified sizes, they do not overlap.  */
-
-	      if (hi >= 0
-		  && msymbol[hi].size () != 0
-		  && unrel_pc >= msymbol[hi].unrelocated_end_address ())
+	  if (found.found < 0)
+	    {
+	      /* If needed record this symbol as the closest
+		 previous symbol.  */
+	      if (previous != nullptr && found.previous >= 0)
 		{
-		  if (best_zero_sized != -1)
-		    hi = best_zero_sized;
-		  else
+		  minimal_symbol *prev = &msymbol[found.previous];
+
+		  if (previous->minsym == nullptr
+		      || (prev->unrelocated_address ()
+			  > previous->minsym->unrelocated_address ()))
 		    {
-		      /* If needed record this symbol as the closest
-			 previous symbol.  */
-		      if (previous != nullptr)
-			{
-			  if (previous->minsym == nullptr
-			      || (msymbol[hi].unrelocated_address ()
-				  > previous->minsym->unrelocated_address ()))
-			    {
-			      previous->minsym = &msymbol[hi];
-			      previous->objfile = objfile;
-			    }
-			}
-		      /* Go on to the next object file.  */
-		      continue;
+		      previous->minsym = prev;
+		      previous->objfile = objfile;
 		    }
 		}
+	      /* Go on to the next object file.  */
+	      continue;
+	    }
 
-	      /* The minimal symbol indexed by hi now is the best one in this
-		 objfile's minimal symbol table.  See if it is the best one
-		 overall.  */
+	  /* The minimal symbol indexed by FOUND now is the best one in
+	     this objfile's minimal symbol table.  See if it is the best
+	     one overall.  */
 
-	      if (hi >= 0
-		  && ((best_symbol == NULL) ||
-		      (best_symbol->unrelocated_address () <
-		       msymbol[hi].unrelocated_address ())))
-		{
-		  best_symbol = &msymbol[hi];
-		  best_objfile = objfile;
-		}
+	  if ((best_symbol == NULL) ||
+	      (best_symbol->unrelocated_address () <
+	       msymbol[found.found].unrelocated_address ()))
+	    {
+	      best_symbol = &msymbol[found.found];
+	      best_objfile = objfile;
 	    }
 	}
     }
@@ -1471,6 +1633,7 @@ minimal_symbol_reader::install ()
       gdb::parallel_for_each (10, &msymbols[0], &msymbols[mcount],
 	 [&] (minimal_symbol *start, minimal_symbol *end)
 	 {
+	   scoped_trace_event trace ("symbols", "demangle minimal symbols");
 	   for (minimal_symbol *msym = start; msym < end; ++msym)
 	     {
 	       size_t idx = msym - msymbols;
@@ -1520,6 +1683,8 @@ minimal_symbol_reader::install ()
 	 });
 
       build_minimal_symbol_hash_tables (m_objfile, hash_values);
+
+      build_msymbol_pc_index (m_objfile);
     }
 }
 
@@ -1709,3 +1874,22 @@ find_minsym_type_and_address (minimal_symbol *msymbol,
       return builtin_type (objfile)->nodebug_unknown_symbol;
     }
 }
+
+void _initialize_minsyms ();
+void
+_initialize_minsyms ()
+{
+  add_setshow_boolean_cmd ("msymbol-pc-index", class_maintenance,
+			   &use_msymbol_pc_index, _("\
+Set whether minimal symbol lookups by address use precomputed indexes."),
+			   _("\
+Show whether minimal symbol lookups by address use precomputed indexes."),
+			   _("\
+When on, looking up the minimal symbol containing an address uses a\n\
+table built for each section when the minimal symbols are read.\n\
+When off, the minimal symbols are searched on each lookup.  The\n\
+results are the same; this is only useful to measure the difference."),
+			   nullptr, nullptr,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+}
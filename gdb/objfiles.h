@@ -214,6 +214,38 @@ struct minimal_symbol_iterator
   struct minimal_symbol *m_msym;
 };
 
+/* A precomputed answer to lookup_minimal_symbol_by_pc_section for the
+   addresses of one section of an objfile, when that section is passed
+   in and the default preference is used.
+
+   The section's unrelocated addresses, from STARTS[0] to END, are
+   split into ranges within which the answer does not change.  Range I
+   starts at STARTS[I]; the starts are kept apart from the answers so
+   that the binary search touches as little memory as possible.  */
+
+struct minimal_symbol_pc_index
+{
+  /* The answer for one range.  */
+  struct result
+  {
+    /* Index of the minimal symbol found, or -1 if none.  */
+    int found;
+
+    /* If FOUND is -1, index of the closest symbol before the range
+       that would be reported as the previous symbol, or -1.  */
+    int previous;
+
+    bool operator== (const result &other) const
+    {
+      return found == other.found && previous == other.previous;
+    }
+  };
+
+  std::vector<unrelocated_addr> starts;
+  std::vector<result> results;
+  unrelocated_addr end {};
+};
+
 /* Some objfile data is hung off the BFD.  This enables sharing of the
    data across all objfiles using the BFD.  The data is stored in an
    instance of this structure, and associated with the BFD using the
@@ -228,7 +260,8 @@ struct objfile_per_bfd_storage
   ~objfile_per_bfd_storage ();
 
   /* Intern STRING in this object's string cache and return the unique copy.
-     The copy has the same lifetime as this object.
+     The copy has the same lifetime as this object.  This may be called
+     from worker threads.
 
      STRING must be null-terminated.  */
 
@@ -255,9 +288,9 @@ struct objfile_per_bfd_storage
 
   auto_obstack storage_obstack;
 
-  /* String cache.  */
+  /* String cache.  This can be used by several threads at once.  */
 
-  gdb::bcache string_cache;
+  gdb::concurrent_bcache string_cache;
 
   /* The gdbarch associated with the BFD.  Note that this gdbarch is
      determined solely from BFD information, without looking at target
@@ -297,6 +330,12 @@ struct objfile_per_bfd_storage
   gdb::unique_xmalloc_ptr<minimal_symbol> msymbols;
   int minimal_symbol_count = 0;
 
+  /* For each section index, the minimal_symbol_pc_index of that
+     section, built when the minimal symbols are installed.  The entry
+     for a section is empty if none was built.  */
+
+  std::vector<minimal_symbol_pc_index> msymbol_pc_index;
+
   /* The number of minimal symbols read, before any minimal symbol
      de-duplication is applied.  Note in particular that this has only
      a passing relationship with the actual size of the table above;
@@ -536,10 +575,15 @@ struct objfile
      If a match is found, the "partial" symbol table is expanded.
      Then, this calls iterate_over_some_symtabs (or equivalent) over
      all newly-created symbol tables, passing CALLBACK to it.
-     The result of this call is returned.  */
+     The result of this call is returned.
+
+     If LINE is positive, only the symbol tables whose line tables may
+     have an entry for LINE need be expanded; see
+     quick_symbol_functions::expand_symtabs_for_line.  */
   bool map_symtabs_matching_filename
     (const char *name, const char *real_path,
-     gdb::function_view<bool (symtab *)> callback);
+     gdb::function_view<bool (symtab *)> callback,
+     int line = 0);
 
   /* Check to see if the symbol is defined in a "partial" symbol table
      of this objfile.  BLOCK_INDEX should be either GLOBAL_BLOCK or
@@ -590,6 +634,14 @@ struct objfile
      domain_enum domain,
      enum search_domain kind);
 
+  /* See quick_symbol_functions.  */
+  bool expand_symtabs_matching_names
+    (gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     gdb::function_view<expand_symtabs_symbol_matcher_factory_ftype>
+       make_matcher,
+     block_search_flags search_flags,
+     enum search_domain kind);
+
   /* See quick_symbol_functions.  */
   struct compunit_symtab *find_pc_sect_compunit_symtab
     (struct bound_minimal_symbol msymbol,
@@ -604,6 +656,11 @@ struct objfile
   /* See quick_symbol_functions.  */
   struct compunit_symtab *find_compunit_symtab_by_address (CORE_ADDR address);
 
+  /* Call FUN with the name of every symbol in the indexes of this
+     objfile; see quick_symbol_functions::map_symbol_names.  Return
+     false if some index cannot enumerate its names.  */
+  bool map_symbol_names (gdb::function_view<void (const char *)> fun);
+
   /* See quick_symbol_functions.  */
   enum language lookup_global_symbol_language (const char *name,
 					       domain_enum domain,
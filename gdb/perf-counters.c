@@ -0,0 +1,240 @@
+/* Performance counters for GDB.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "perf-counters.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "ui-out.h"
+#include "gdbsupport/gdb_regex.h"
+#include "gdbsupport/selftest.h"
+#include "gdbsupport/thread-pool.h"
+
+#include <algorithm>
+
+/* Return the registry of counters.  This is a function, rather than
+   a global, because counters are registered by the constructors of
+   other globals.  */
+
+static std::vector<perf_counter_info> &
+perf_counter_registry ()
+{
+  static std::vector<perf_counter_info> registry;
+  return registry;
+}
+
+/* Add a counter to the registry, keeping it sorted by name.  */
+
+static void
+register_perf_counter (const char *name, const char *doc,
+		       std::function<ULONGEST ()> read)
+{
+  std::vector<perf_counter_info> &registry = perf_counter_registry ();
+  auto iter = std::lower_bound (registry.begin (), registry.end (), name,
+				[] (const perf_counter_info &info,
+				    const char *key)
+				{
+				  return strcmp (info.name, key) < 0;
+				});
+  registry.insert (iter, perf_counter_info { name, doc, std::move (read) });
+}
+
+/* See perf-counters.h.  */
+
+const std::vector<perf_counter_info> &
+all_perf_counters ()
+{
+  return perf_counter_registry ();
+}
+
+/* See perf-counters.h.  */
+
+void
+add_perf_gauge (const char *name, const char *doc,
+		std::function<ULONGEST ()> read)
+{
+  register_perf_counter (name, doc, std::move (read));
+}
+
+/* See perf-counters.h.  */
+
+perf_counter::perf_counter (const char *name, const char *doc)
+  : m_name (name)
+{
+  register_perf_counter (name, doc, [this] ()
+    {
+      return value ();
+    });
+}
+
+/* See perf-counters.h.  */
+
+perf_counter::~perf_counter ()
+{
+  std::vector<perf_counter_info> &registry = perf_counter_registry ();
+  auto iter = std::find_if (registry.begin (), registry.end (),
+			    [this] (const perf_counter_info &info)
+			    {
+			      return info.name == m_name;
+			    });
+  if (iter != registry.end ())
+    registry.erase (iter);
+}
+
+/* See perf-counters.h.  */
+
+void
+print_perf_counters (struct ui_out *uiout, const char *regexp)
+{
+  gdb::optional<compiled_regex> pattern;
+  if (regexp != nullptr && *regexp != '\0')
+    pattern.emplace (regexp, REG_NOSUB,
+		     _("Invalid perf-counter regular expression"));
+
+  std::vector<const perf_counter_info *> matches;
+  size_t name_width = strlen ("Name");
+  for (const perf_counter_info &info : all_perf_counters ())
+    if (!pattern.has_value ()
+	|| pattern->exec (info.name, 0, nullptr, 0) == 0)
+      {
+	matches.push_back (&info);
+	name_width = std::max (name_width, strlen (info.name));
+      }
+
+  /* The CLI prints nothing at all for an empty table.  */
+  if (matches.empty () && pattern.has_value () && !uiout->is_mi_like_p ())
+    {
+      uiout->message (_("No performance counter matches \"%s\".\n"),
+		      regexp);
+      return;
+    }
+
+  ui_out_emit_table table_emitter (uiout, 3, matches.size (),
+				   "perf-counters");
+  uiout->table_header (name_width, ui_left, "name", "Name");
+  uiout->table_header (14, ui_right, "value", "Value");
+  uiout->table_header (1, ui_noalign, "description", "Description");
+  uiout->table_body ();
+
+  for (const perf_counter_info *info : matches)
+    {
+      ui_out_emit_tuple tuple_emitter (uiout, "counter");
+      uiout->field_string ("name", info->name);
+      uiout->field_string ("value", pulongest (info->read ()));
+      uiout->field_string ("description", _(info->doc));
+      uiout->text ("\n");
+    }
+}
+
+/* Implement "maint info perf-counters".  */
+
+static void
+maintenance_info_perf_counters (const char *args, int from_tty)
+{
+  print_perf_counters (current_uiout, args);
+}
+
+#if GDB_SELF_TEST
+namespace selftests {
+
+/* Check that counters and gauges are registered in name order, that
+   they can be read, and that counters are removed from the registry
+   when they are destroyed.  */
+
+static void
+test_perf_counters ()
+{
+  /* These counters only exist while the test runs, so that they do
+     not show up in "maint info perf-counters".  */
+  gdb::optional<perf_counter> test_counter;
+  test_counter.emplace ("selftest.counter",
+			N_("A counter used by the selftests."));
+  perf_counter test_timer ("selftest.timer",
+			   N_("A timer used by the selftests."));
+
+  ++*test_counter;
+  *test_counter += 2;
+  SELF_CHECK (test_counter->value () == 3);
+
+  /* The timer adds the time spent in its scope, in microseconds.  */
+  {
+    scoped_perf_timer timer (test_timer);
+
+    auto start = std::chrono::steady_clock::now ();
+    while (std::chrono::steady_clock::now () - start
+	   < std::chrono::milliseconds (2))
+      ;
+  }
+  SELF_CHECK (test_timer.value () >= 2000);
+
+  const char *prev = nullptr;
+  bool found = false;
+  for (const perf_counter_info &info : all_perf_counters ())
+    {
+      if (prev != nullptr)
+	SELF_CHECK (strcmp (prev, info.name) <= 0);
+      prev = info.name;
+
+      if (strcmp (info.name, "selftest.counter") == 0)
+	{
+	  SELF_CHECK (info.read () == 3);
+	  found = true;
+	}
+    }
+  SELF_CHECK (found);
+
+  test_counter.reset ();
+  for (const perf_counter_info &info : all_perf_counters ())
+    SELF_CHECK (strcmp (info.name, "selftest.counter") != 0);
+}
+
+} /* namespace selftests */
+#endif /* GDB_SELF_TEST */
+
+void _initialize_perf_counters ();
+void
+_initialize_perf_counters ()
+{
+  add_perf_gauge ("thread-pool.queued-tasks",
+		  N_("Tasks posted to the thread pool but not yet started."),
+		  [] ()
+		  {
+		    return gdb::thread_pool::g_thread_pool->queued_tasks ();
+		  });
+  add_perf_gauge ("thread-pool.threads",
+		  N_("Worker threads in the thread pool."),
+		  [] ()
+		  {
+		    return gdb::thread_pool::g_thread_pool->thread_count ();
+		  });
+
+  add_cmd ("perf-counters", class_maintenance,
+	   maintenance_info_perf_counters, _("\
+Show GDB's performance counters.\n\
+Usage: maintenance info perf-counters [REGEXP]\n\
+The counters record cache hits and misses, traffic to the target and\n\
+the time spent reading symbols, since GDB started.  If REGEXP is given,\n\
+only the counters whose name matches it are shown."),
+	   &maintenanceinfolist);
+
+#if GDB_SELF_TEST
+  selftests::register_test ("perf-counters",
+			    selftests::test_perf_counters);
+#endif
+}
@@ -0,0 +1,149 @@
+/* Performance counters for GDB.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+struct ui_out;
+
+/* Performance counters give one place to look at the hit rates of
+   GDB's caches, the traffic to the target and the time spent in the
+   expensive phases of symbol reading.  Each counter has a name, such
+   as "dcache.hits", and a description.  All counters can be listed
+   with "maint info perf-counters", the -info-perf-counters MI command,
+   or gdb.perf_counters in Python.
+
+   There are two kinds of counters.  A perf_counter is a value that
+   is incremented where the event happens; incrementing it is a single
+   relaxed atomic addition, so counters are always enabled and may be
+   updated by worker threads.  A gauge is a function that computes its
+   value when the counters are read, which suits statistics that are
+   already kept elsewhere, such as the length of a queue.  */
+
+/* A registered counter or gauge.  */
+
+struct perf_counter_info
+{
+  /* The name of the counter.  */
+  const char *name;
+
+  /* A description of what is being counted, marked for translation
+     with N_.  */
+  const char *doc;
+
+  /* Return the current value of the counter.  */
+  std::function<ULONGEST ()> read;
+};
+
+/* Return all the registered counters, sorted by name.  */
+
+extern const std::vector<perf_counter_info> &all_perf_counters ();
+
+/* Register a gauge called NAME, described by DOC, whose value is
+   computed by READ.  READ is only called from the main thread.  NAME
+   and DOC must be static strings.  */
+
+extern void add_perf_gauge (const char *name, const char *doc,
+			    std::function<ULONGEST ()> read);
+
+/* Print the counters whose name matches REGEXP, or all of them if
+   REGEXP is NULL or empty, as a table on UIOUT.  */
+
+extern void print_perf_counters (struct ui_out *uiout, const char *regexp);
+
+/* A counter of events.  These are meant to be global objects, which
+   registers them when GDB starts.  A counter is removed from the
+   registry when it is destroyed.  NAME and DOC must be static
+   strings.  */
+
+class perf_counter
+{
+public:
+
+  perf_counter (const char *name, const char *doc);
+  ~perf_counter ();
+  DISABLE_COPY_AND_ASSIGN (perf_counter);
+
+  /* Add N to the counter.  This may be called from any thread.  */
+  void increment (ULONGEST n = 1)
+  {
+    m_value.fetch_add (n, std::memory_order_relaxed);
+  }
+
+  perf_counter &operator++ ()
+  {
+    increment ();
+    return *this;
+  }
+
+  perf_counter &operator+= (ULONGEST n)
+  {
+    increment (n);
+    return *this;
+  }
+
+  /* Return the current value of the counter.  */
+  ULONGEST value () const
+  {
+    return m_value.load (std::memory_order_relaxed);
+  }
+
+private:
+
+  /* The name under which this counter is registered.  */
+  const char *m_name;
+
+  std::atomic<ULONGEST> m_value { 0 };
+};
+
+/* Add the wall-clock time spent in a scope, in microseconds, to a
+   perf_counter.  This is used to time a phase of work, such as
+   indexing the DWARF of an objfile.  */
+
+class scoped_perf_timer
+{
+public:
+
+  explicit scoped_perf_timer (perf_counter &counter)
+    : m_counter (counter),
+      m_start (std::chrono::steady_clock::now ())
+  {
+  }
+
+  ~scoped_perf_timer ()
+  {
+    auto elapsed = std::chrono::steady_clock::now () - m_start;
+    m_counter += (std::chrono::duration_cast<std::chrono::microseconds>
+		  (elapsed).count ());
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_perf_timer);
+
+private:
+
+  perf_counter &m_counter;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+#endif /* PERF_COUNTERS_H */
@@ -151,6 +151,7 @@ def register_pretty_printer(obj, printer, replace=False):
             i = i + 1
 
     obj.pretty_printers.insert(0, printer)
+    gdb.invalidate_cached_pretty_printers()
 
 
 class RegexpCollectionPrettyPrinter(PrettyPrinter):
@@ -165,6 +166,10 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
     register_pretty_printer(obj, pretty_printer)
     """
 
+    # The lookup below depends only on the type of the value, so GDB may
+    # cache its result for each type.
+    cacheable = True
+
     class RegexpSubprinter(SubPrettyPrinter):
         def __init__(self, name, regexp, gen_printer):
             super(RegexpCollectionPrettyPrinter.RegexpSubprinter, self).__init__(name)
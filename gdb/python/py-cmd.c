@@ -106,6 +106,10 @@ cmdpy_function (const char *args, int from_tty, cmd_list_element *command)
 
   gdbpy_enter enter_py;
 
+  /* The command may change the pretty-printer lists, as "enable
+     pretty-printer" does.  */
+  gdbpy_invalidate_pretty_printer_cache ();
+
   if (! obj)
     error (_("Invalid invocation of Python command object."));
   if (! PyObject_HasAttr ((PyObject *) obj, invoke_cst))
@@ -567,6 +567,63 @@ infpy_read_memory (PyObject *self, PyObject *args, PyObject *kw)
   return gdbpy_buffer_to_membuf (std::move (buffer), addr, length);
 }
 
+/* Implementation of Inferior.read_memory_into (address, buffer [, length]).
+   Reads LENGTH bytes of the inferior's memory at ADDRESS directly into
+   BUFFER, a Python object supporting the writable buffer protocol (for
+   example a bytearray).  If LENGTH is not given, the whole of BUFFER is
+   filled.  Unlike Inferior.read_memory, no intermediate buffer is
+   allocated, so a caller can reuse BUFFER across many reads.  The
+   function returns nothing.  Returns NULL on error, with a python
+   exception set.  */
+static PyObject *
+infpy_read_memory_into (PyObject *self, PyObject *args, PyObject *kw)
+{
+  inferior_object *inf = (inferior_object *) self;
+  CORE_ADDR addr, length;
+  PyObject *addr_obj, *length_obj = nullptr;
+  static const char *keywords[] = { "address", "buffer", "length", NULL };
+  Py_buffer pybuf;
+
+  INFPY_REQUIRE_VALID (inf);
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "Ow*|O", keywords,
+					&addr_obj, &pybuf, &length_obj))
+    return nullptr;
+
+  Py_buffer_up buffer_up (&pybuf);
+
+  if (get_addr_from_python (addr_obj, &addr) < 0)
+    return nullptr;
+
+  if (length_obj == nullptr)
+    length = pybuf.len;
+  else if (get_addr_from_python (length_obj, &length) < 0)
+    return nullptr;
+
+  if (length > pybuf.len)
+    {
+      PyErr_SetString (PyExc_ValueError,
+		       _("The length is larger than the buffer."));
+      return nullptr;
+    }
+
+  try
+    {
+      /* Use this scoped-restore because we want to be able to read
+	 memory from an unwinder.  */
+      scoped_restore_current_inferior_for_memory restore_inferior
+	(inf->inferior);
+
+      read_memory (addr, (gdb_byte *) pybuf.buf, length);
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  Py_RETURN_NONE;
+}
+
 /* Implementation of Inferior.write_memory (address, buffer [, length]).
    Writes the contents of BUFFER (a Python object supporting the read
    buffer protocol) at ADDRESS in the inferior's memory.  Write LENGTH
@@ -1062,6 +1119,10 @@ Return true if this inferior is valid, false if not." },
     METH_VARARGS | METH_KEYWORDS,
     "read_memory (address, length) -> buffer\n\
 Return a buffer object for reading from the inferior's memory." },
+  { "read_memory_into", (PyCFunction) infpy_read_memory_into,
+    METH_VARARGS | METH_KEYWORDS,
+    "read_memory_into (address, buffer [, length])\n\
+Read the inferior's memory into the given writable buffer object." },
   { "write_memory", (PyCFunction) infpy_write_memory,
     METH_VARARGS | METH_KEYWORDS,
     "write_memory (address, buffer [, length])\n\
@@ -21,6 +21,8 @@
 #include "gdbthread.h"
 #include "inferior.h"
 #include "python-internal.h"
+#include "stack-groups.h"
+#include "source.h"
 
 extern PyTypeObject thread_object_type
     CPYCHECKER_TYPE_OBJECT_FOR_TYPEDEF ("thread_object");
@@ -361,6 +363,132 @@ gdbpy_selected_thread (PyObject *self, PyObject *args)
   Py_RETURN_NONE;
 }
 
+/* Convert LOC, a location from a stack_groups, to a dictionary with
+   the keys "pc", "function", "filename", "line" and "solib".  Return
+   NULL with a Python exception set on error.  */
+
+static gdbpy_ref<>
+stack_location_to_dict (const stack_location &loc)
+{
+  gdbpy_ref<> dict (PyDict_New ());
+  if (dict == nullptr)
+    return nullptr;
+
+  gdbpy_ref<> pc = gdb_py_object_from_ulongest (loc.pc);
+  if (pc == nullptr || PyDict_SetItemString (dict.get (), "pc", pc.get ()) < 0)
+    return nullptr;
+
+  gdbpy_ref<> function;
+  const char *funname = loc.function_name ();
+  if (funname != nullptr)
+    function.reset (PyUnicode_FromString (funname));
+  else
+    function = gdbpy_ref<>::new_reference (Py_None);
+  if (function == nullptr
+      || PyDict_SetItemString (dict.get (), "function", function.get ()) < 0)
+    return nullptr;
+
+  gdbpy_ref<> filename, line;
+  if (loc.symtab != nullptr)
+    {
+      filename.reset (PyUnicode_FromString (symtab_to_filename_for_display
+					    (loc.symtab)));
+      line = gdb_py_object_from_longest (loc.line);
+    }
+  else
+    {
+      filename = gdbpy_ref<>::new_reference (Py_None);
+      line = gdbpy_ref<>::new_reference (Py_None);
+    }
+  if (filename == nullptr || line == nullptr
+      || PyDict_SetItemString (dict.get (), "filename", filename.get ()) < 0
+      || PyDict_SetItemString (dict.get (), "line", line.get ()) < 0)
+    return nullptr;
+
+  gdbpy_ref<> solib;
+  if (loc.solib != nullptr)
+    solib.reset (PyUnicode_FromString (loc.solib));
+  else
+    solib = gdbpy_ref<>::new_reference (Py_None);
+  if (solib == nullptr
+      || PyDict_SetItemString (dict.get (), "solib", solib.get ()) < 0)
+    return nullptr;
+
+  return dict;
+}
+
+/* Implementation of gdb.thread_stack_groups ([max_depth]) -> list.
+   Returns the backtraces of all the stopped threads, grouped by
+   identical backtrace.  */
+
+PyObject *
+gdbpy_thread_stack_groups (PyObject *self, PyObject *args, PyObject *kw)
+{
+  static const char *keywords[] = { "max_depth", nullptr };
+  int max_depth = -1;
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "|i", keywords,
+					&max_depth))
+    return nullptr;
+
+  stack_groups stacks;
+  try
+    {
+      stacks = collect_stack_groups (max_depth);
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  /* Each location is converted only once, however many frames it
+     appears in.  */
+  std::vector<gdbpy_ref<>> locations (stacks.locations.size ());
+
+  gdbpy_ref<> result (PyList_New (0));
+  if (result == nullptr)
+    return nullptr;
+
+  for (const stack_group &group : stacks.groups)
+    {
+      gdbpy_ref<> threads (PyTuple_New (group.threads.size ()));
+      if (threads == nullptr)
+	return nullptr;
+      for (int i = 0; i < group.threads.size (); ++i)
+	{
+	  gdbpy_ref<> thread = thread_to_thread_object (group.threads[i].get ());
+	  if (thread == nullptr)
+	    return nullptr;
+	  PyTuple_SET_ITEM (threads.get (), i, thread.release ());
+	}
+
+      gdbpy_ref<> frames (PyList_New (group.frames.size ()));
+      if (frames == nullptr)
+	return nullptr;
+      for (int i = 0; i < group.frames.size (); ++i)
+	{
+	  gdbpy_ref<> &loc = locations[group.frames[i]];
+	  if (loc == nullptr)
+	    {
+	      loc = stack_location_to_dict (stacks.locations[group.frames[i]]);
+	      if (loc == nullptr)
+		return nullptr;
+	    }
+	  PyList_SET_ITEM (frames.get (), i, loc.get ());
+	  Py_INCREF (loc.get ());
+	}
+
+      gdbpy_ref<> dict (PyDict_New ());
+      if (dict == nullptr
+	  || PyDict_SetItemString (dict.get (), "threads", threads.get ()) < 0
+	  || PyDict_SetItemString (dict.get (), "frames", frames.get ()) < 0
+	  || PyList_Append (result.get (), dict.get ()) < 0)
+	return nullptr;
+    }
+
+  return result.release ();
+}
+
 static int CPYCHECKER_NEGATIVE_RESULT_SETS_EXCEPTION
 gdbpy_initialize_thread (void)
 {
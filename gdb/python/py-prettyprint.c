@@ -26,6 +26,8 @@
 #include "python.h"
 #include "python-internal.h"
 #include "cli/cli-style.h"
+#include "observable.h"
+#include <unordered_map>
 
 extern PyTypeObject printer_object_type;
 
@@ -45,14 +47,75 @@ enum gdbpy_string_repr_result
    printing.  */
 const struct value_print_options *gdbpy_current_print_options;
 
+/* Cache of pretty-printer lookups, keyed by the type of the value
+   being printed.  Each entry is either the lookup function that
+   recognized values of that type, or Py_None if no lookup function
+   did.  Only searches that consulted nothing but "cacheable" lookup
+   functions are recorded here; see search_pp_list.  */
+
+static std::unordered_map<struct type *, gdbpy_ref<>> pp_lookup_cache;
+
+/* The program space for which PP_LOOKUP_CACHE was filled in.  */
+
+static program_space *pp_lookup_cache_pspace;
+
+/* See python-internal.h.  */
+
+void
+gdbpy_invalidate_pretty_printer_cache ()
+{
+  pp_lookup_cache.clear ();
+  pp_lookup_cache_pspace = nullptr;
+}
+
+/* State of a single search for a pretty-printer.  */
+
+struct pp_search_state
+{
+  /* The lookup function that returned the printer, if one was
+     found.  */
+  gdbpy_ref<> function;
+
+  /* True while every lookup function consulted so far has declared
+     that its result depends only on the type of the value.  */
+  bool cacheable = true;
+};
+
+/* Return true if the lookup function FUNCTION has a true "cacheable"
+   attribute.  Errors are ignored and treated as false.  */
+
+static bool
+pp_function_cacheable_p (PyObject *function)
+{
+  if (!PyObject_HasAttr (function, gdbpy_cacheable_cst))
+    return false;
+
+  gdbpy_ref<> attr (PyObject_GetAttr (function, gdbpy_cacheable_cst));
+  if (attr == NULL)
+    {
+      PyErr_Clear ();
+      return false;
+    }
+
+  int cmp = PyObject_IsTrue (attr.get ());
+  if (cmp == -1)
+    {
+      PyErr_Clear ();
+      return false;
+    }
+
+  return cmp;
+}
+
 /* Helper function for find_pretty_printer which iterates over a list,
    calls each function and inspects output.  This will return a
    printer object if one recognizes VALUE.  If no printer is found, it
    will return None.  On error, it will set the Python error and
-   return NULL.  */
+   return NULL.  STATE is updated to record the function that was
+   found, and whether the result may be cached.  */
 
 static gdbpy_ref<>
-search_pp_list (PyObject *list, PyObject *value)
+search_pp_list (PyObject *list, PyObject *value, pp_search_state *state)
 {
   Py_ssize_t pp_list_size, list_index;
 
@@ -79,12 +142,18 @@ search_pp_list (PyObject *list, PyObject *value)
 	    continue;
 	}
 
+      if (state->cacheable && !pp_function_cacheable_p (function))
+	state->cacheable = false;
+
       gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (function, value,
 							 NULL));
       if (printer == NULL)
 	return NULL;
       else if (printer != Py_None)
-	return printer;
+	{
+	  state->function = gdbpy_ref<>::new_reference (function);
+	  return printer;
+	}
     }
 
   return gdbpy_ref<>::new_reference (Py_None);
@@ -97,7 +166,7 @@ search_pp_list (PyObject *list, PyObject *value)
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static PyObject *
-find_pretty_printer_from_objfiles (PyObject *value)
+find_pretty_printer_from_objfiles (PyObject *value, pp_search_state *state)
 {
   for (objfile *obj : current_program_space->objfiles ())
     {
@@ -110,7 +179,7 @@ find_pretty_printer_from_objfiles (PyObject *value)
 	}
 
       gdbpy_ref<> pp_list (objfpy_get_printers (objf.get (), NULL));
-      gdbpy_ref<> function (search_pp_list (pp_list.get (), value));
+      gdbpy_ref<> function (search_pp_list (pp_list.get (), value, state));
 
       /* If there is an error in any objfile list, abort the search and exit.  */
       if (function == NULL)
@@ -130,14 +199,14 @@ find_pretty_printer_from_objfiles (PyObject *value)
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static gdbpy_ref<>
-find_pretty_printer_from_progspace (PyObject *value)
+find_pretty_printer_from_progspace (PyObject *value, pp_search_state *state)
 {
   gdbpy_ref<> obj = pspace_to_pspace_object (current_program_space);
 
   if (obj == NULL)
     return NULL;
   gdbpy_ref<> pp_list (pspy_get_printers (obj.get (), NULL));
-  return search_pp_list (pp_list.get (), value);
+  return search_pp_list (pp_list.get (), value, state);
 }
 
 /* Subroutine of find_pretty_printer to simplify it.
@@ -147,7 +216,7 @@ find_pretty_printer_from_progspace (PyObject *value)
    Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
 
 static gdbpy_ref<>
-find_pretty_printer_from_gdb (PyObject *value)
+find_pretty_printer_from_gdb (PyObject *value, pp_search_state *state)
 {
   /* Fetch the global pretty printer list.  */
   if (gdb_python_module == NULL
@@ -158,29 +227,77 @@ find_pretty_printer_from_gdb (PyObject *value)
   if (pp_list == NULL || ! PyList_Check (pp_list.get ()))
     return gdbpy_ref<>::new_reference (Py_None);
 
-  return search_pp_list (pp_list.get (), value);
+  return search_pp_list (pp_list.get (), value, state);
 }
 
-/* Find the pretty-printing constructor function for VALUE.  If no
-   pretty-printer exists, return None.  If one exists, return a new
-   reference.  On error, set the Python error and return NULL.  */
+/* Search all the pretty-printer lists for a printer for VALUE.  The
+   result is as for find_pretty_printer.  */
 
 static gdbpy_ref<>
-find_pretty_printer (PyObject *value)
+search_all_pp_lists (PyObject *value, pp_search_state *state)
 {
   /* Look at the pretty-printer list for each objfile
      in the current program-space.  */
-  gdbpy_ref<> function (find_pretty_printer_from_objfiles (value));
+  gdbpy_ref<> function (find_pretty_printer_from_objfiles (value, state));
   if (function == NULL || function != Py_None)
     return function;
 
   /* Look at the pretty-printer list for the current program-space.  */
-  function = find_pretty_printer_from_progspace (value);
+  function = find_pretty_printer_from_progspace (value, state);
   if (function == NULL || function != Py_None)
     return function;
 
   /* Look at the pretty-printer list in the gdb module.  */
-  return find_pretty_printer_from_gdb (value);
+  return find_pretty_printer_from_gdb (value, state);
+}
+
+/* Find the pretty-printing constructor function for VALUE.  If no
+   pretty-printer exists, return None.  If one exists, return a new
+   reference.  On error, set the Python error and return NULL.
+
+   Searching every list for each value is expensive when printing
+   large containers, so the outcome of a search is remembered for the
+   type of VALUE, provided that only cacheable lookup functions were
+   consulted.  */
+
+static gdbpy_ref<>
+find_pretty_printer (PyObject *value)
+{
+  struct type *type = value_object_to_value (value)->type ();
+
+  if (pp_lookup_cache_pspace != current_program_space)
+    {
+      gdbpy_invalidate_pretty_printer_cache ();
+      pp_lookup_cache_pspace = current_program_space;
+    }
+
+  auto iter = pp_lookup_cache.find (type);
+  if (iter != pp_lookup_cache.end ())
+    {
+      if (iter->second == Py_None)
+	return gdbpy_ref<>::new_reference (Py_None);
+
+      gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (iter->second.get (),
+							 value, NULL));
+      if (printer == NULL || printer != Py_None)
+	return printer;
+
+      /* The lookup function did not recognize this value after all.
+	 Forget about it and do a full search.  */
+      pp_lookup_cache.erase (iter);
+    }
+
+  pp_search_state state;
+  gdbpy_ref<> printer = search_all_pp_lists (value, &state);
+  if (printer != NULL && state.cacheable)
+    {
+      if (printer == Py_None)
+	pp_lookup_cache[type] = gdbpy_ref<>::new_reference (Py_None);
+      else
+	pp_lookup_cache[type] = std::move (state.function);
+    }
+
+  return printer;
 }
 
 /* Pretty-print a single value, via the printer object PRINTER.
@@ -580,12 +697,17 @@ gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   struct gdbarch *gdbarch = type->arch ();
   enum gdbpy_string_repr_result print_result;
 
-  if (value->lazy ())
-    value->fetch_lazy ();
+  /* A large array that is to be read piecemeal while it is printed
+     is left lazy, for a printer to read what it needs of it.  */
+  if (!val_print_array_in_chunks_p (value, language))
+    {
+      if (value->lazy ())
+	value->fetch_lazy ();
 
-  /* No pretty-printer support for unavailable values.  */
-  if (!value->bytes_available (0, type->length ()))
-    return EXT_LANG_RC_NOP;
+      /* No pretty-printer support for unavailable values.  */
+      if (!value->bytes_available (0, type->length ()))
+	return EXT_LANG_RC_NOP;
+    }
 
   if (!gdb_python_initialized)
     return EXT_LANG_RC_NOP;
@@ -832,6 +954,20 @@ PyTypeObject printer_object_type =
   PyType_GenericNew,		  /* tp_new */
 };
 
+/* Called when an objfile is loaded or freed.  The types used as keys
+   in PP_LOOKUP_CACHE may be going away, and the objfile may bring or
+   take its own pretty-printers, so the cache is discarded.  */
+
+static void
+pp_lookup_cache_objfile_changed (struct objfile *objfile)
+{
+  if (!gdb_python_initialized || pp_lookup_cache.empty ())
+    return;
+
+  gdbpy_enter enter_py;
+  gdbpy_invalidate_pretty_printer_cache ();
+}
+
 /* Set up the ValuePrinter type.  */
 
 static int
@@ -839,8 +975,23 @@ gdbpy_initialize_prettyprint ()
 {
   if (PyType_Ready (&printer_object_type) < 0)
     return -1;
+
+  gdb::observers::new_objfile.attach (pp_lookup_cache_objfile_changed,
+				      "py-prettyprint");
+  gdb::observers::free_objfile.attach (pp_lookup_cache_objfile_changed,
+				       "py-prettyprint");
+
   return gdb_pymodule_addobject (gdb_module, "ValuePrinter",
 				 (PyObject *) &printer_object_type);
 }
 
-GDBPY_INITIALIZE_FILE (gdbpy_initialize_prettyprint);
+/* Release the references held by the lookup cache.  */
+
+static void
+gdbpy_finalize_prettyprint ()
+{
+  gdbpy_invalidate_pretty_printer_cache ();
+}
+
+GDBPY_INITIALIZE_FILE (gdbpy_initialize_prettyprint,
+		       gdbpy_finalize_prettyprint);
@@ -247,6 +247,7 @@ pspy_set_printers (PyObject *o, PyObject *value, void *ignore)
   gdbpy_ref<> tmp (self->printers);
   Py_INCREF (value);
   self->printers = value;
+  gdbpy_invalidate_pretty_printer_cache ();
 
   return 0;
 }
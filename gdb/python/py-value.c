@@ -29,6 +29,7 @@
 #include "cp-abi.h"
 #include "python.h"
 #include "ada-lang.h"
+#include "gdbcore.h"
 
 #include "python-internal.h"
 
@@ -364,6 +365,147 @@ valpy_to_array (PyObject *self, PyObject *args)
   return result;
 }
 
+/* Convert the object of type TYPE stored at ADDR in the host buffer
+   CONTENTS to a Python object.  Scalars are converted directly to
+   Python integers or floats; anything else becomes a non-lazy
+   gdb.Value whose address is MEMADDR.  */
+
+static gdbpy_ref<>
+valpy_element_to_python (struct type *type, const gdb_byte *contents,
+			 CORE_ADDR memaddr)
+{
+  struct type *real_type = check_typedef (type);
+
+  if (is_integral_type (real_type) || real_type->code () == TYPE_CODE_PTR)
+    {
+      LONGEST l = unpack_long (real_type, contents);
+
+      if (real_type->is_unsigned ())
+	return gdb_py_object_from_ulongest (l);
+      else
+	return gdb_py_object_from_longest (l);
+    }
+  else if (real_type->code () == TYPE_CODE_FLT)
+    return gdbpy_ref<> (PyFloat_FromDouble
+			  (target_float_to_host_double (contents,
+							real_type)));
+
+  struct value *val = value_from_contents_and_address (type, contents,
+						       memaddr);
+  return gdbpy_ref<> (value_to_value_object (val));
+}
+
+/* Implement Value.read_elements (count [, field]).  The value must be
+   a pointer or an array in memory.  COUNT consecutive elements of the
+   pointed-to (or element) type are read from the inferior with a
+   single memory read, and returned as a list.  If FIELD is given, the
+   elements must be structures or unions, and only the named member of
+   each element is returned.  */
+
+static PyObject *
+valpy_read_elements (PyObject *self, PyObject *args, PyObject *kw)
+{
+  static const char *keywords[] = { "count", "field", nullptr };
+  Py_ssize_t count;
+  const char *field_name = nullptr;
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "n|s", keywords,
+					&count, &field_name))
+    return nullptr;
+
+  if (count < 0)
+    {
+      PyErr_SetString (PyExc_ValueError,
+		       _("The element count must not be negative."));
+      return nullptr;
+    }
+
+  gdbpy_ref<> result (PyList_New (count));
+  if (result == nullptr)
+    return nullptr;
+
+  try
+    {
+      scoped_value_mark free_values;
+      struct value *val = ((value_object *) self)->value;
+      struct type *type = check_typedef (val->type ());
+      struct type *elt_type;
+      CORE_ADDR addr;
+
+      if (type->code () == TYPE_CODE_PTR)
+	{
+	  elt_type = type->target_type ();
+	  addr = value_as_address (val);
+	}
+      else if (type->code () == TYPE_CODE_ARRAY
+	       && val->lval () == lval_memory)
+	{
+	  elt_type = type->target_type ();
+	  addr = val->address ();
+	}
+      else
+	error (_("Value must be a pointer or an array in memory."));
+
+      ULONGEST stride = check_typedef (elt_type)->length ();
+      if (stride == 0)
+	error (_("Cannot read elements of a zero-sized type."));
+      if (count > 0 && stride > ULONGEST_MAX / count)
+	error (_("Too many elements requested."));
+
+      /* Work out which part of each element is wanted.  */
+      struct type *item_type = elt_type;
+      ULONGEST item_offset = 0;
+      if (field_name != nullptr)
+	{
+	  struct type *struct_type = check_typedef (elt_type);
+	  if (struct_type->code () != TYPE_CODE_STRUCT
+	      && struct_type->code () != TYPE_CODE_UNION)
+	    error (_("Elements must be structures or unions to read a field."));
+
+	  int i;
+	  for (i = 0; i < struct_type->num_fields (); ++i)
+	    {
+	      const char *name = struct_type->field (i).name ();
+	      if (name != nullptr && strcmp (name, field_name) == 0)
+		break;
+	    }
+	  if (i == struct_type->num_fields ())
+	    error (_("Type %s has no field named %s."),
+		   TYPE_SAFE_NAME (struct_type), field_name);
+
+	  const struct field &fld = struct_type->field (i);
+	  if (fld.is_static () || fld.bitsize () != 0
+	      || fld.loc_bitpos () % TARGET_CHAR_BIT != 0)
+	    error (_("Field %s cannot be read in bulk."), field_name);
+
+	  item_type = fld.type ();
+	  item_offset = fld.loc_bitpos () / TARGET_CHAR_BIT;
+	}
+
+      /* Fetch all of the elements at once; the conversions below
+	 then work from the host buffer.  */
+      gdb::byte_vector contents (count * stride);
+      read_memory (addr, contents.data (), contents.size ());
+
+      for (Py_ssize_t i = 0; i < count; ++i)
+	{
+	  ULONGEST offset = i * stride + item_offset;
+	  gdbpy_ref<> item = valpy_element_to_python (item_type,
+						      contents.data () + offset,
+						      addr + offset);
+	  if (item == nullptr)
+	    return nullptr;
+	  PyList_SET_ITEM (result.get (), i, item.release ());
+	}
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  return result.release ();
+}
+
 /* Return a "const" qualified version of the value.  */
 
 static PyObject *
@@ -2189,6 +2331,11 @@ Assign VAL to this value." },
   { "to_array", valpy_to_array, METH_NOARGS,
     "to_array () -> Value\n\
 Return value as an array, if possible." },
+  { "read_elements", (PyCFunction) valpy_read_elements,
+    METH_VARARGS | METH_KEYWORDS,
+    "read_elements (count [, field]) -> list\n\
+Read COUNT elements starting at this pointer or array with a single\n\
+memory read, optionally extracting just FIELD from each element." },
   {NULL}  /* Sentinel */
 };
 
@@ -424,6 +424,8 @@ PyObject *gdbpy_create_lazy_string_object (CORE_ADDR address, long length,
 PyObject *gdbpy_inferiors (PyObject *unused, PyObject *unused2);
 PyObject *gdbpy_create_ptid_object (ptid_t ptid);
 PyObject *gdbpy_selected_thread (PyObject *self, PyObject *args);
+PyObject *gdbpy_thread_stack_groups (PyObject *self, PyObject *args,
+				     PyObject *kw);
 PyObject *gdbpy_selected_inferior (PyObject *self, PyObject *args);
 PyObject *gdbpy_string_to_argv (PyObject *self, PyObject *args);
 PyObject *gdbpy_parameter_value (const setting &var);
@@ -819,6 +821,11 @@ gdbpy_ref<> gdbpy_get_varobj_pretty_printer (struct value *value);
 gdb::unique_xmalloc_ptr<char> gdbpy_get_display_hint (PyObject *printer);
 PyObject *gdbpy_default_visualizer (PyObject *self, PyObject *args);
 
+/* Forget the pretty-printer lookups cached by find_pretty_printer.
+   This must be called whenever a pretty-printer list may have
+   changed.  */
+void gdbpy_invalidate_pretty_printer_cache ();
+
 PyObject *gdbpy_print_options (PyObject *self, PyObject *args);
 void gdbpy_get_print_options (value_print_options *opts);
 extern const struct value_print_options *gdbpy_current_print_options;
@@ -832,6 +839,7 @@ extern PyObject *gdbpy_children_cst;
 extern PyObject *gdbpy_to_string_cst;
 extern PyObject *gdbpy_display_hint_cst;
 extern PyObject *gdbpy_enabled_cst;
+extern PyObject *gdbpy_cacheable_cst;
 extern PyObject *gdbpy_value_cst;
 
 /* Exception types.  */
@@ -37,6 +37,7 @@
 #include "run-on-main-thread.h"
 #include "gdbsupport/selftest.h"
 #include "observable.h"
+#include "perf-counters.h"
 
 /* Declared constants and enum for python stack printing.  */
 static const char python_excp_none[] = "none";
@@ -91,6 +92,7 @@ PyObject *gdbpy_children_cst;
 PyObject *gdbpy_display_hint_cst;
 PyObject *gdbpy_doc_cst;
 PyObject *gdbpy_enabled_cst;
+PyObject *gdbpy_cacheable_cst;
 PyObject *gdbpy_value_cst;
 
 /* The GdbError exception.  */
@@ -338,6 +340,9 @@ python_interactive_command (const char *arg, int from_tty)
 
   gdbpy_enter enter_py;
 
+  /* The script may change the pretty-printer lists.  */
+  gdbpy_invalidate_pretty_printer_cache ();
+
   if (arg && *arg)
     {
       std::string script = std::string (arg) + "\n";
@@ -374,6 +379,9 @@ python_interactive_command (const char *arg, int from_tty)
 static void
 python_run_simple_file (FILE *file, const char *filename)
 {
+  /* The script may change the pretty-printer lists.  */
+  gdbpy_invalidate_pretty_printer_cache ();
+
 #ifndef _WIN32
 
   PyRun_SimpleFile (file, filename);
@@ -432,6 +440,9 @@ gdbpy_eval_from_control_command (const struct extension_language_defn *extlang,
 
   gdbpy_enter enter_py;
 
+  /* The script may change the pretty-printer lists.  */
+  gdbpy_invalidate_pretty_printer_cache ();
+
   std::string script = compute_python_string (cmd->body_list_0.get ());
   ret = PyRun_SimpleString (script.c_str ());
   if (ret)
@@ -450,6 +461,9 @@ python_command (const char *arg, int from_tty)
   arg = skip_spaces (arg);
   if (arg && *arg)
     {
+      /* The script may change the pretty-printer lists.  */
+      gdbpy_invalidate_pretty_printer_cache ();
+
       if (PyRun_SimpleString (arg))
 	error (_("Error while executing Python code."));
     }
@@ -1021,6 +1035,20 @@ static PyObject *
 gdbpy_invalidate_cached_frames (PyObject *self, PyObject *args)
 {
   reinit_frame_cache ();
+
+  /* This is called when Python unwinders are registered, enabled or
+     disabled.  The unwinders remembered for the frames of the stack
+     may no longer be the ones to use.  */
+  frame_memo_clear ();
+  Py_RETURN_NONE;
+}
+
+/* Implementation of gdb.invalidate_cached_pretty_printers.  */
+
+static PyObject *
+gdbpy_invalidate_cached_pretty_printers (PyObject *self, PyObject *args)
+{
+  gdbpy_invalidate_pretty_printer_cache ();
   Py_RETURN_NONE;
 }
 
@@ -1627,6 +1655,27 @@ gdbpy_current_language (PyObject *unused1, PyObject *unused2)
   return host_string_to_python_string (current_language->name ()).release ();
 }
 
+/* Implement gdb.perf_counters.  */
+
+static PyObject *
+gdbpy_perf_counters (PyObject *unused1, PyObject *unused2)
+{
+  gdbpy_ref<> result (PyDict_New ());
+  if (result == nullptr)
+    return nullptr;
+
+  for (const perf_counter_info &info : all_perf_counters ())
+    {
+      gdbpy_ref<> value = gdb_py_object_from_ulongest (info.read ());
+      if (value == nullptr
+	  || PyDict_SetItemString (result.get (), info.name,
+				   value.get ()) < 0)
+	return nullptr;
+    }
+
+  return result.release ();
+}
+
 
 
 /* See python.h.  */
@@ -1671,6 +1720,9 @@ gdbpy_execute_objfile_script (const struct extension_language_defn *extlang,
   scoped_restore restire_current_objfile
     = make_scoped_restore (&gdbpy_current_objfile, objfile);
 
+  /* The script may change the pretty-printer lists.  */
+  gdbpy_invalidate_pretty_printer_cache ();
+
   PyRun_SimpleString (script);
 }
 
@@ -2192,6 +2244,9 @@ do_start_initialization ()
   gdbpy_enabled_cst = PyUnicode_FromString ("enabled");
   if (gdbpy_enabled_cst == NULL)
     return false;
+  gdbpy_cacheable_cst = PyUnicode_FromString ("cacheable");
+  if (gdbpy_cacheable_cst == NULL)
+    return false;
   gdbpy_value_cst = PyUnicode_FromString ("value");
   if (gdbpy_value_cst == NULL)
     return false;
@@ -2619,6 +2674,11 @@ Arguments are separate by spaces and may be quoted."
   { "selected_thread", gdbpy_selected_thread, METH_NOARGS,
     "selected_thread () -> gdb.InferiorThread.\n\
 Return the selected thread object." },
+  { "thread_stack_groups", (PyCFunction) gdbpy_thread_stack_groups,
+    METH_VARARGS | METH_KEYWORDS,
+    "thread_stack_groups ([max_depth]) -> list.\n\
+Return the backtraces of all stopped threads, grouping the threads\n\
+whose backtraces are identical." },
   { "selected_inferior", gdbpy_selected_inferior, METH_NOARGS,
     "selected_inferior () -> gdb.Inferior.\n\
 Return the selected inferior object." },
@@ -2631,6 +2691,11 @@ Return a tuple containing all inferiors." },
 Invalidate any cached frame objects in gdb.\n\
 Intended for internal use only." },
 
+  { "invalidate_cached_pretty_printers",
+    gdbpy_invalidate_cached_pretty_printers, METH_NOARGS,
+    "invalidate_cached_pretty_printers () -> None.\n\
+Forget the results of earlier pretty-printer lookups." },
+
   { "convenience_variable", gdbpy_convenience_variable, METH_VARARGS,
     "convenience_variable (NAME) -> value.\n\
 Return the value of the convenience variable $NAME,\n\
@@ -2669,6 +2734,11 @@ Return the name of the currently selected language." },
     "print_options () -> dict\n\
 Return the current print options." },
 
+  { "perf_counters", gdbpy_perf_counters, METH_NOARGS,
+    "perf_counters () -> dict\n\
+Return a dictionary mapping the name of each of GDB's performance\n\
+counters to its current value." },
+
   {NULL, NULL, 0, NULL}
 };
 
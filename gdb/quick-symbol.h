@@ -51,6 +51,14 @@ typedef bool (expand_symtabs_file_matcher_ftype) (const char *filename,
 
 typedef bool (expand_symtabs_symbol_matcher_ftype) (const char *name);
 
+/* Callback for quick_symbol_functions->expand_symtabs_matching_names
+   to create a symbol name matcher.  Each thread matching names gets
+   its own matcher, so the matchers need not be thread-safe, but this
+   function may be called from several threads at once.  */
+
+typedef std::function<expand_symtabs_symbol_matcher_ftype>
+  (expand_symtabs_symbol_matcher_factory_ftype) ();
+
 /* Callback for quick_symbol_functions->expand_symtabs_matching
    to be called after a symtab has been expanded.  If this returns
    true, more symtabs are checked; if it returns false, iteration
@@ -185,6 +193,50 @@ struct quick_symbol_functions
      domain_enum domain,
      enum search_domain kind) = 0;
 
+  /* Like expand_symtabs_matching with a LOOKUP_NAME matching any name
+     and any domain, and a SYMBOL_MATCHER returned by MAKE_MATCHER.
+     The names may be matched on several threads at once, each using
+     a matcher of its own, which helps when the matcher is expensive,
+     like a regular expression; symbol tables are only expanded on the
+     calling thread.  The default implementation matches the names on
+     the calling thread.  */
+  virtual bool expand_symtabs_matching_names
+    (struct objfile *objfile,
+     gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     gdb::function_view<expand_symtabs_symbol_matcher_factory_ftype>
+       make_matcher,
+     block_search_flags search_flags,
+     enum search_domain kind)
+  {
+    std::function<expand_symtabs_symbol_matcher_ftype> symbol_matcher
+      = make_matcher ();
+    return expand_symtabs_matching (objfile, file_matcher,
+				    &lookup_name_info::match_any (),
+				    symbol_matcher, nullptr, search_flags,
+				    UNDEF_DOMAIN, kind);
+  }
+
+  /* Like expand_symtabs_matching with FILE_MATCHER and no
+     LOOKUP_NAME, but the symbol tables whose line tables are known to
+     have no entry for LINE in a file matching FILE_MATCHER need not
+     be expanded.  This lets a FILE:LINE location only expand the
+     compilation units that can contain it, which matters for headers
+     included in many compilation units.  The default implementation
+     expands every matching symbol table.  */
+  virtual bool expand_symtabs_for_line
+    (struct objfile *objfile,
+     gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+     int line,
+     gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+  {
+    return expand_symtabs_matching (objfile, file_matcher, nullptr, nullptr,
+				    expansion_notify,
+				    (SEARCH_GLOBAL_BLOCK
+				     | SEARCH_STATIC_BLOCK),
+				    UNDEF_DOMAIN,
+				    ALL_DOMAIN);
+  }
+
   /* Return the comp unit from OBJFILE that contains PC and
      SECTION.  Return NULL if there is no such compunit.  This
      should return the compunit that contains a symbol whose
@@ -225,6 +277,22 @@ struct quick_symbol_functions
   virtual void read_partial_symbols (struct objfile *objfile)
   {
   }
+
+  /* Call FUN with the name of every symbol in the index of OBJFILE
+     and return true, or return false if this index cannot enumerate
+     its names.  The names are those that expand_symtabs_matching
+     compares with the last component of a lookup name, as split by
+     lookup_name_info::split_name for some language; that comparison
+     ignores case and any template parameter list.  So a symbol can
+     only be found through this index if the last component of the
+     lookup name, split in some style, is one of these names.  This is
+     used to skip the objfile quickly when looking up a name in the
+     whole program space.  */
+  virtual bool map_symbol_names (struct objfile *objfile,
+				 gdb::function_view<void (const char *)> fun)
+  {
+    return false;
+  }
 };
 
 typedef std::unique_ptr<quick_symbol_functions> quick_symbol_functions_up;
@@ -79,6 +79,7 @@
 #include <unordered_map>
 #include "async-event.h"
 #include "gdbsupport/selftest.h"
+#include "perf-counters.h"
 
 /* The remote target.  */
 
@@ -9707,6 +9708,20 @@ putpkt (remote_target *remote, const char *buf)
   return remote->putpkt (buf);
 }
 
+/* Counters of the traffic with the remote target, for "maint info
+   perf-counters".  */
+
+static perf_counter remote_packets_sent_counter
+  ("remote.packets-sent", N_("Packets sent to the remote target."));
+static perf_counter remote_bytes_sent_counter
+  ("remote.bytes-sent", N_("Payload bytes sent to the remote target."));
+static perf_counter remote_packets_received_counter
+  ("remote.packets-received",
+   N_("Packets and notifications received from the remote target."));
+static perf_counter remote_bytes_received_counter
+  ("remote.bytes-received",
+   N_("Payload bytes received from the remote target."));
+
 /* Send a packet to the remote machine, with error checking.  The data
    of the packet is in BUF.  The string in BUF can be at most
    get_remote_packet_size () - 5 to account for the $, # and checksum,
@@ -9757,6 +9772,9 @@ remote_target::putpkt_binary (const char *buf, int cnt)
   *p++ = tohex ((csum >> 4) & 0xf);
   *p++ = tohex (csum & 0xf);
 
+  ++remote_packets_sent_counter;
+  remote_bytes_sent_counter += cnt;
+
   /* Send it over and over until we get a positive ack.  */
 
   while (1)
@@ -10116,7 +10134,11 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
 		 Now collect the data.  */
 	      val = read_frame (buf);
 	      if (val >= 0)
-		break;
+		{
+		  ++remote_packets_received_counter;
+		  remote_bytes_received_counter += val;
+		  break;
+		}
 	    }
 
 	  remote_serial_write ("-", 1);
@@ -48,6 +48,7 @@
 #include "debuginfod-support.h"
 #include "source.h"
 #include "cli/cli-style.h"
+#include "trace-events.h"
 
 /* See solib.h.  */
 
@@ -696,6 +697,8 @@ solib_read_symbols (struct so_list *so, symfile_add_flags flags)
     }
   else
     {
+      scoped_trace_event trace ("solib", "read shared library symbols",
+				so->so_name);
 
       flags |= current_inferior ()->symfile_flags;
 
@@ -979,6 +982,57 @@ libpthread_solib_p (struct so_list *so)
   return libpthread_name_p (so->so_name);
 }
 
+/* Return true if symbols would be read for SO by solib_add with
+   PATTERN and READSYMS, and if it has no debug info of its own or on
+   this system, so that debuginfod would be asked for it.  */
+
+static bool
+solib_wants_debuginfod_p (struct so_list *so, const char *pattern,
+			  int readsyms)
+{
+  if (so->symbols_loaded
+      || so->abfd == nullptr
+      || (pattern != nullptr && !re_exec (so->so_name))
+      || !(readsyms || libpthread_solib_p (so)))
+    return false;
+
+  for (objfile *objfile : current_program_space->objfiles ())
+    if (filename_cmp (objfile_name (objfile), so->so_name) == 0
+	&& objfile->addr_low == so->addr_low)
+      return false;
+
+  if (bfd_get_section_by_name (so->abfd, ".debug_info") != nullptr
+      || bfd_get_section_by_name (so->abfd, ".zdebug_info") != nullptr)
+    return false;
+
+  const struct bfd_build_id *build_id = build_id_bfd_get (so->abfd);
+  if (build_id == nullptr)
+    return false;
+
+  return build_id_to_debug_bfd (build_id->size, build_id->data) == nullptr;
+}
+
+/* Download the separate debug info of the shared libraries whose
+   symbols solib_add with PATTERN and READSYMS is about to read, all at
+   once, rather than one library at a time as the symbols of each are
+   read.  */
+
+static void
+solib_prefetch_debuginfo (const char *pattern, int readsyms)
+{
+  std::vector<gdb::byte_vector> build_ids;
+
+  for (struct so_list *so : current_program_space->solibs ())
+    if (solib_wants_debuginfod_p (so, pattern, readsyms))
+      {
+	const struct bfd_build_id *build_id = build_id_bfd_get (so->abfd);
+	build_ids.emplace_back (build_id->data,
+				build_id->data + build_id->size);
+      }
+
+  debuginfod_prefetch_debuginfo (build_ids);
+}
+
 /* Read in symbolic information for any shared objects whose names
    match PATTERN.  (If we've already read a shared object's symbol
    info, leave it alone.)  If PATTERN is zero, read them all.
@@ -1014,6 +1068,8 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 
   update_solib_list (from_tty);
 
+  solib_prefetch_debuginfo (pattern, readsyms);
+
   /* Walk the list of currently loaded shared libraries, and read
      symbols for any that match the pattern --- or any whose symbols
      aren't already loaded, if no pattern was given.  */
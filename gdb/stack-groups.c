@@ -0,0 +1,237 @@
+/* Grouped backtraces of all threads, for GDB the GNU Debugger.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "stack-groups.h"
+#include "block.h"
+#include "frame.h"
+#include "inferior.h"
+#include "progspace.h"
+#include "solib.h"
+#include "symtab.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+/* See stack-groups.h.  */
+
+const char *
+stack_location::function_name () const
+{
+  if (function != nullptr)
+    return function->print_name ();
+  if (msymbol.minsym != nullptr)
+    return msymbol.minsym->print_name ();
+  return nullptr;
+}
+
+/* Fill in the symbolic information of LOC.  The current program space
+   must be LOC's.
+
+   This follows what find_frame_funname and find_frame_sal compute for
+   a frame, but works from the address alone so that it needs to be
+   done only once per location.  */
+
+static void
+symbolize_stack_location (stack_location &loc)
+{
+  /* The functions containing LOOKUP_PC, from the real function
+     inwards through the functions inlined into it.  */
+  std::vector<symbol *> functions;
+  for (const block *b = block_for_pc (loc.lookup_pc);
+       b != nullptr;
+       b = b->superblock ())
+    {
+      if (b->function () != nullptr)
+	{
+	  functions.push_back (b->function ());
+	  if (!b->inlined_p ())
+	    break;
+	}
+    }
+  std::reverse (functions.begin (), functions.end ());
+
+  if (functions.empty ())
+    {
+      loc.msymbol = lookup_minimal_symbol_by_pc (loc.lookup_pc);
+
+      symtab_and_line sal = find_pc_line (loc.lookup_pc, 0);
+      loc.symtab = sal.symtab;
+      loc.line = sal.line;
+    }
+  else
+    {
+      size_t depth = std::min<size_t> (loc.inline_depth,
+				       functions.size () - 1);
+      loc.function = functions[depth];
+
+      if (depth + 1 == functions.size ())
+	{
+	  symtab_and_line sal = find_pc_line (loc.lookup_pc, 0);
+	  loc.symtab = sal.symtab;
+	  loc.line = sal.line;
+	}
+      else
+	{
+	  /* The frame is stopped at the call site of the next inlined
+	     function, whose symbol records the line of the call.  */
+	  symbol *callee = functions[depth + 1];
+	  loc.symtab = callee->symtab ();
+	  loc.line = callee->line ();
+	}
+    }
+
+  loc.solib = solib_name_from_address (loc.pspace, loc.pc);
+}
+
+/* A frame of the current thread, as seen while unwinding.  */
+
+struct raw_stack_frame
+{
+  struct gdbarch *gdbarch;
+  CORE_ADDR pc;
+  CORE_ADDR lookup_pc;
+  bool inlined;
+};
+
+/* Unwind the current thread, at most MAX_DEPTH frames deep if
+   MAX_DEPTH is non-negative.  Unwinding stops at the first frame
+   whose PC is unavailable or that cannot be unwound.  */
+
+static std::vector<raw_stack_frame>
+unwind_current_thread (int max_depth)
+{
+  std::vector<raw_stack_frame> frames;
+
+  try
+    {
+      for (frame_info_ptr fi = get_current_frame ();
+	   fi != nullptr;
+	   fi = get_prev_frame (fi))
+	{
+	  raw_stack_frame f;
+	  f.gdbarch = get_frame_arch (fi);
+	  f.inlined = get_frame_type (fi) == INLINE_FRAME;
+
+	  /* Keep going past the limit until the real frame that the
+	     last inline frames belong to, so that their depth is
+	     known.  */
+	  if (max_depth >= 0 && (int) frames.size () >= max_depth
+	      && (frames.empty () || !frames.back ().inlined))
+	    break;
+
+	  if (!get_frame_pc_if_available (fi, &f.pc)
+	      || !get_frame_address_in_block_if_available (fi, &f.lookup_pc))
+	    break;
+
+	  frames.push_back (f);
+	}
+    }
+  catch (const gdb_exception_error &except)
+    {
+      /* Report the frames found so far.  */
+    }
+
+  if (max_depth >= 0 && (int) frames.size () > max_depth)
+    frames.resize (max_depth);
+
+  return frames;
+}
+
+/* See stack-groups.h.  */
+
+stack_groups
+collect_stack_groups (int max_depth)
+{
+  stack_groups result;
+
+  /* Map from (program space, pc, lookup pc, inline depth) to the
+     index of the location in RESULT.LOCATIONS.  */
+  std::map<std::tuple<program_space *, CORE_ADDR, CORE_ADDR, int>, int>
+    location_index;
+
+  /* Map from a backtrace to the index of its group in
+     RESULT.GROUPS.  */
+  std::map<std::vector<int>, int> group_index;
+
+  scoped_restore_current_thread restore_thread;
+
+  for (thread_info *tp : all_non_exited_threads ())
+    {
+      QUIT;
+
+      if (tp->executing () || tp->state == THREAD_RUNNING)
+	continue;
+
+      switch_to_thread (tp);
+
+      std::vector<raw_stack_frame> raw = unwind_current_thread (max_depth);
+      std::vector<int> frames (raw.size ());
+
+      /* Walk from the outermost frame so that the inline depth of
+	 each frame is known when it is reached.  */
+      int depth = 0;
+      for (int i = raw.size () - 1; i >= 0; --i)
+	{
+	  if (raw[i].inlined)
+	    ++depth;
+	  else
+	    depth = 0;
+
+	  auto key = std::make_tuple (current_program_space, raw[i].pc,
+				      raw[i].lookup_pc, depth);
+	  auto it = location_index.find (key);
+	  if (it == location_index.end ())
+	    {
+	      stack_location loc;
+	      loc.pspace = current_program_space;
+	      loc.gdbarch = raw[i].gdbarch;
+	      loc.pc = raw[i].pc;
+	      loc.lookup_pc = raw[i].lookup_pc;
+	      loc.inline_depth = depth;
+	      symbolize_stack_location (loc);
+
+	      result.locations.push_back (loc);
+	      it = location_index.emplace (key,
+					   result.locations.size () - 1).first;
+	    }
+	  frames[i] = it->second;
+	}
+
+      result.num_frames += frames.size ();
+
+      auto git = group_index.find (frames);
+      if (git == group_index.end ())
+	{
+	  git = group_index.emplace (frames, result.groups.size ()).first;
+	  result.groups.emplace_back ();
+	  result.groups.back ().frames = std::move (frames);
+	}
+      result.groups[git->second].threads.push_back
+	(thread_info_ref::new_reference (tp));
+    }
+
+  std::stable_sort (result.groups.begin (), result.groups.end (),
+		    [] (const stack_group &a, const stack_group &b)
+		    {
+		      return a.threads.size () > b.threads.size ();
+		    });
+
+  return result;
+}
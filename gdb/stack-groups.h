@@ -0,0 +1,106 @@
+/* Grouped backtraces of all threads, for GDB the GNU Debugger.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef STACK_GROUPS_H
+#define STACK_GROUPS_H
+
+#include "gdbthread.h"
+#include "minsyms.h"
+
+struct symtab;
+
+/* A code location that appears in at least one frame of one thread.
+   Each distinct location is symbolized once, however many frames it
+   appears in.  */
+
+struct stack_location
+{
+  /* The program space the location belongs to.  */
+  struct program_space *pspace;
+
+  /* The architecture of the frame.  */
+  struct gdbarch *gdbarch;
+
+  /* The frame's PC.  */
+  CORE_ADDR pc;
+
+  /* The address used for symbol lookup; for a caller frame this is
+     within the call instruction, see get_frame_address_in_block.  */
+  CORE_ADDR lookup_pc;
+
+  /* The number of functions inlined into the real function that
+     contain this frame, counting outwards from the real function.
+     Zero for a normal frame.  */
+  int inline_depth;
+
+  /* The function containing the location, if known.  */
+  struct symbol *function = nullptr;
+
+  /* If FUNCTION is NULL, the minimal symbol containing the location,
+     if any.  */
+  bound_minimal_symbol msymbol;
+
+  /* The source location, if known.  */
+  struct symtab *symtab = nullptr;
+  int line = 0;
+
+  /* The name of the shared library containing PC, if any.  */
+  const char *solib = nullptr;
+
+  /* Return the name of the function containing the location, or NULL
+     if it is not known.  */
+  const char *function_name () const;
+};
+
+/* A set of threads whose stacks are made of the same locations.  */
+
+struct stack_group
+{
+  /* The threads, in the order they were found.  */
+  std::vector<thread_info_ref> threads;
+
+  /* The frames shared by all the threads, innermost first, as indices
+     into stack_groups::locations.  */
+  std::vector<int> frames;
+};
+
+/* The backtraces of a set of threads.  */
+
+struct stack_groups
+{
+  /* The distinct locations appearing in the backtraces.  */
+  std::vector<stack_location> locations;
+
+  /* The groups, largest first; groups of equal size are in the order
+     their first thread was found.  */
+  std::vector<stack_group> groups;
+
+  /* The number of frames that were unwound.  */
+  int num_frames = 0;
+};
+
+/* Unwind every stopped thread of every inferior, at most MAX_DEPTH
+   frames deep if MAX_DEPTH is non-negative, and group the threads by
+   identical backtrace.  Each distinct location is symbolized only
+   once.  Threads that are running are skipped.  The selected thread
+   and frame are preserved.  */
+
+extern stack_groups collect_stack_groups (int max_depth = -1);
+
+#endif /* STACK_GROUPS_H */
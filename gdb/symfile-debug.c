@@ -175,15 +175,16 @@ objfile::forget_cached_source_info ()
 bool
 objfile::map_symtabs_matching_filename
   (const char *name, const char *real_path,
-   gdb::function_view<bool (symtab *)> callback)
+   gdb::function_view<bool (symtab *)> callback,
+   int line)
 {
   if (debug_symfile)
     gdb_printf (gdb_stdlog,
 		"qf->map_symtabs_matching_filename (%s, \"%s\", "
-		"\"%s\", %s)\n",
+		"\"%s\", %s, %d)\n",
 		objfile_debug_name (this), name,
 		real_path ? real_path : NULL,
-		host_address_to_string (&callback));
+		host_address_to_string (&callback), line);
 
   bool retval = true;
   const char *name_basename = lbasename (name);
@@ -217,15 +218,22 @@ objfile::map_symtabs_matching_filename
 
   for (const auto &iter : qf_require_partial_symbols ())
     {
-      if (!iter->expand_symtabs_matching (this,
-					  match_one_filename,
-					  nullptr,
-					  nullptr,
-					  on_expansion,
-					  (SEARCH_GLOBAL_BLOCK
-					   | SEARCH_STATIC_BLOCK),
-					  UNDEF_DOMAIN,
-					  ALL_DOMAIN))
+      bool keep_going;
+
+      if (line > 0)
+	keep_going = iter->expand_symtabs_for_line (this, match_one_filename,
+						    line, on_expansion);
+      else
+	keep_going = iter->expand_symtabs_matching (this,
+						    match_one_filename,
+						    nullptr,
+						    nullptr,
+						    on_expansion,
+						    (SEARCH_GLOBAL_BLOCK
+						     | SEARCH_STATIC_BLOCK),
+						    UNDEF_DOMAIN,
+						    ALL_DOMAIN);
+      if (!keep_going)
 	{
 	  retval = false;
 	  break;
@@ -434,6 +442,30 @@ objfile::expand_symtabs_matching
   return true;
 }
 
+bool
+objfile::expand_symtabs_matching_names
+  (gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   gdb::function_view<expand_symtabs_symbol_matcher_factory_ftype>
+     make_matcher,
+   block_search_flags search_flags,
+   enum search_domain kind)
+{
+  if (debug_symfile)
+    gdb_printf (gdb_stdlog,
+		"qf->expand_symtabs_matching_names (%s, %s, %s, %s)\n",
+		objfile_debug_name (this),
+		host_address_to_string (&file_matcher),
+		host_address_to_string (&make_matcher),
+		search_domain_name (kind));
+
+  for (const auto &iter : qf_require_partial_symbols ())
+    if (!iter->expand_symtabs_matching_names (this, file_matcher,
+					      make_matcher, search_flags,
+					      kind))
+      return false;
+  return true;
+}
+
 struct compunit_symtab *
 objfile::find_pc_sect_compunit_symtab (struct bound_minimal_symbol msymbol,
 				       CORE_ADDR pc,
@@ -483,6 +515,21 @@ objfile::map_symbol_filenames (gdb::function_view<symbol_filename_ftype> fun,
     iter->map_symbol_filenames (this, fun, need_fullname);
 }
 
+bool
+objfile::map_symbol_names (gdb::function_view<void (const char *)> fun)
+{
+  if (debug_symfile)
+    gdb_printf (gdb_stdlog,
+		"qf->map_symbol_names (%s, ...)\n",
+		objfile_debug_name (this));
+
+  for (const auto &iter : qf_require_partial_symbols ())
+    if (!iter->map_symbol_names (this, fun))
+      return false;
+
+  return true;
+}
+
 struct compunit_symtab *
 objfile::find_compunit_symtab_by_address (CORE_ADDR address)
 {
@@ -61,6 +61,7 @@
 #include "cli/cli-style.h"
 #include "gdbsupport/forward-scope-exit.h"
 #include "gdbsupport/buildargv.h"
+#include "trace-events.h"
 
 #include <sys/types.h>
 #include <fcntl.h>
@@ -1043,6 +1044,7 @@ symbol_file_add_with_addrs (const gdb_bfd_ref_ptr &abfd, const char *name,
   const int should_print = (print_symbol_loading_p (from_tty, mainline, 1)
 			    && (readnow_symbol_files
 				|| (add_flags & SYMFILE_NO_READ) == 0));
+  scoped_trace_event trace ("symbols", "read symbols", name);
 
   if (readnow_symbol_files)
     {
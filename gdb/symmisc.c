@@ -39,6 +39,8 @@
 #include "readline/tilde.h"
 #include <cli/cli-style.h>
 #include "gdbsupport/buildargv.h"
+#include "perf-counters.h"
+#include <unordered_set>
 
 /* Prototypes for local functions */
 
@@ -1037,6 +1039,22 @@ maintenance_info_line_tables (const char *regexp, int from_tty)
 }
 
 
+/* Add the insertion and distinct string counts of the string caches
+   of all objfiles to *TOTAL and *UNIQUE.  Objfiles that share their
+   per-BFD data are only counted once.  */
+
+static void
+add_string_cache_counts (ULONGEST *total, ULONGEST *unique)
+{
+  std::unordered_set<objfile_per_bfd_storage *> seen;
+
+  for (struct program_space *pspace : program_spaces)
+    for (objfile *objfile : pspace->objfiles ())
+      if (seen.insert (objfile->per_bfd).second)
+	objfile->per_bfd->string_cache.add_counts (total, unique);
+}
+
+
 
 /* Do early runtime initializations.  */
 
@@ -1044,6 +1062,23 @@ void _initialize_symmisc ();
 void
 _initialize_symmisc ()
 {
+  add_perf_gauge ("string-cache.insertions",
+		  N_("Strings interned in the string caches of all objfiles."),
+		  [] ()
+		  {
+		    ULONGEST total = 0, unique = 0;
+		    add_string_cache_counts (&total, &unique);
+		    return total;
+		  });
+  add_perf_gauge ("string-cache.unique",
+		  N_("Distinct strings in the string caches of all objfiles."),
+		  [] ()
+		  {
+		    ULONGEST total = 0, unique = 0;
+		    add_string_cache_counts (&total, &unique);
+		    return unique;
+		  });
+
   add_cmd ("symbols", class_maintenance, maintenance_print_symbols, _("\
 Print dump of current symbol definitions.\n\
 Usage: mt print symbols [-pc ADDRESS] [--] [OUTFILE]\n\
@@ -73,6 +73,8 @@
 #include "gdbsupport/gdb_string_view.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/common-utils.h"
+#include "gdbsupport/parallel-for.h"
+#include "perf-counters.h"
 
 /* Forward declarations for local functions.  */
 
@@ -98,7 +100,8 @@ struct block_symbol lookup_local_symbol (const char *name,
 static struct block_symbol
   lookup_symbol_in_objfile (struct objfile *objfile,
 			    enum block_enum block_index,
-			    const char *name, const domain_enum domain);
+			    const char *name, const domain_enum domain,
+			    bool search_quick = true);
 
 static void set_main_name (const char *name, enum language lang);
 
@@ -131,6 +134,10 @@ static const registry<program_space>::key<main_info> main_progspace_key;
    there's no point in allowing a user typo to make gdb consume all memory.  */
 #define MAX_SYMBOL_CACHE_SIZE (1024*1024)
 
+/* The size up to which a symbol cache grows by itself when its slots
+   are reused too often.  */
+#define MAX_ADAPTIVE_SYMBOL_CACHE_SIZE (64*1024)
+
 /* symbol_cache_lookup returns this if a previous lookup failed to find the
    symbol in any objfile.  */
 #define SYMBOL_LOOKUP_FAILED \
@@ -288,6 +295,11 @@ static const char *multiple_symbols_mode = multiple_symbols_all;
    for the SAL past a function prologue.  */
 static bool ignore_prologue_end_flag = false;
 
+/* When true, the objfiles that cannot define a symbol are skipped
+   quickly when looking up a global or static symbol in all objfiles.
+   See symbol_name_filter.  */
+static bool use_symbol_name_index = true;
+
 /* Read-only accessor to AUTO_SELECT_MODE.  */
 
 const char *
@@ -632,11 +644,16 @@ iterate_over_some_symtabs (const char *name,
    in the symtab filename will also work.
 
    Calls CALLBACK with each symtab that is found.  If CALLBACK returns
-   true, the search stops.  */
+   true, the search stops.
+
+   If LINE is positive, the caller is only interested in symtabs whose
+   line table has an entry for LINE.  Symtabs that are not expanded
+   yet and are known not to have one may then be skipped.  */
 
 void
 iterate_over_symtabs (const char *name,
-		      gdb::function_view<bool (symtab *)> callback)
+		      gdb::function_view<bool (symtab *)> callback,
+		      int line)
 {
   gdb::unique_xmalloc_ptr<char> real_path;
 
@@ -662,7 +679,7 @@ iterate_over_symtabs (const char *name,
   for (objfile *objfile : current_program_space->objfiles ())
     {
       if (objfile->map_symtabs_matching_filename (name, real_path.get (),
-						  callback))
+						  callback, line))
 	return;
     }
 }
@@ -1309,11 +1326,11 @@ symbol_cache_byte_size (unsigned int size)
 static void
 resize_symbol_cache (struct symbol_cache *cache, unsigned int new_size)
 {
-  /* If there's no change in size, don't do anything.
-     All caches have the same size, so we can just compare with the size
-     of the global symbols cache.  */
+  /* If there's no change in size, don't do anything.  The caches may
+     have grown separately, see symbol_cache_maybe_grow.  */
   if ((cache->global_symbols != NULL
-       && cache->global_symbols->size == new_size)
+       && cache->global_symbols->size == new_size
+       && cache->static_symbols->size == new_size)
       || (cache->global_symbols == NULL
 	  && new_size == 0))
     return;
@@ -1391,6 +1408,14 @@ set_symbol_cache_size_handler (const char *args, int from_tty,
   set_symbol_cache_size (symbol_cache_size);
 }
 
+/* Counters for all the symbol caches, for "maint info
+   perf-counters".  */
+
+static perf_counter symbol_cache_hits_counter
+  ("symbol-cache.hits", N_("Symbol lookups found in a symbol cache."));
+static perf_counter symbol_cache_misses_counter
+  ("symbol-cache.misses", N_("Symbol lookups that missed a symbol cache."));
+
 /* Lookup symbol NAME,DOMAIN in BLOCK in the symbol cache of PSPACE.
    OBJFILE_CONTEXT is the current objfile, which may be NULL.
    The result is the symbol if found, SYMBOL_LOOKUP_FAILED if a previous lookup
@@ -1435,6 +1460,7 @@ symbol_cache_lookup (struct symbol_cache *cache,
 				  ? " (not found)" : "", name,
 				  domain_name (domain));
       ++bsc->hits;
+      ++symbol_cache_hits_counter;
       if (slot->state == SYMBOL_SLOT_NOT_FOUND)
 	return SYMBOL_LOOKUP_FAILED;
       return slot->value.found;
@@ -1446,6 +1472,7 @@ symbol_cache_lookup (struct symbol_cache *cache,
 			      block == GLOBAL_BLOCK ? "Global" : "Static",
 			      name, domain_name (domain));
   ++bsc->misses;
+  ++symbol_cache_misses_counter;
   return {};
 }
 
@@ -1497,6 +1524,38 @@ symbol_cache_mark_not_found (struct block_symbol_cache *bsc,
   slot->value.not_found.domain = domain;
 }
 
+/* Grow the cache of BLOCK in CACHE if its slots have been reused more
+   times than it has slots, which means that the working set of
+   lookups does not fit.  Growing discards the contents of the cache,
+   but happens rarely since the size roughly doubles each time.  */
+
+static void
+symbol_cache_maybe_grow (struct symbol_cache *cache, enum block_enum block)
+{
+  struct block_symbol_cache **bsc_ptr
+    = (block == GLOBAL_BLOCK
+       ? &cache->global_symbols : &cache->static_symbols);
+  struct block_symbol_cache *bsc = *bsc_ptr;
+
+  if (bsc == NULL
+      || bsc->collisions < bsc->size
+      || bsc->size >= MAX_ADAPTIVE_SYMBOL_CACHE_SIZE)
+    return;
+
+  unsigned int new_size = 2 * bsc->size + 1;
+  if (new_size > MAX_ADAPTIVE_SYMBOL_CACHE_SIZE)
+    new_size = MAX_ADAPTIVE_SYMBOL_CACHE_SIZE;
+
+  symbol_lookup_debug_printf ("growing %s block symbol cache to %u",
+			      block == GLOBAL_BLOCK ? "global" : "static",
+			      new_size);
+
+  destroy_block_symbol_cache (bsc);
+  *bsc_ptr = ((struct block_symbol_cache *)
+	      xcalloc (1, symbol_cache_byte_size (new_size)));
+  (*bsc_ptr)->size = new_size;
+}
+
 /* Flush the symbol cache of PSPACE.  */
 
 static void
@@ -1521,8 +1580,8 @@ symbol_cache_flush (struct program_space *pspace)
       && cache->static_symbols->misses == 0)
     return;
 
-  gdb_assert (cache->global_symbols->size == symbol_cache_size);
-  gdb_assert (cache->static_symbols->size == symbol_cache_size);
+  gdb_assert (cache->global_symbols->size >= symbol_cache_size);
+  gdb_assert (cache->static_symbols->size >= symbol_cache_size);
 
   for (pass = 0; pass < 2; ++pass)
     {
@@ -2511,7 +2570,8 @@ lookup_symbol_in_static_block (const char *name,
 
 static struct block_symbol
 lookup_symbol_in_objfile (struct objfile *objfile, enum block_enum block_index,
-			  const char *name, const domain_enum domain)
+			  const char *name, const domain_enum domain,
+			  bool search_quick)
 {
   struct block_symbol result;
 
@@ -2533,6 +2593,9 @@ lookup_symbol_in_objfile (struct objfile *objfile, enum block_enum block_index,
       return result;
     }
 
+  if (!search_quick)
+    return {};
+
   result = lookup_symbol_via_quick_fns (objfile, block_index,
 					name, domain);
   symbol_lookup_debug_printf ("lookup_symbol_in_objfile (...) = %s%s",
@@ -2544,6 +2607,136 @@ lookup_symbol_in_objfile (struct objfile *objfile, enum block_enum block_index,
   return result;
 }
 
+/* A filter over the names of the symbols that the quick symbol
+   functions of an objfile can find, so that looking up a name in all
+   the objfiles of a program space need not ask each of them in turn.
+   It is built from the names that the indexes of the objfile
+   enumerate, see quick_symbol_functions::map_symbol_names, the first
+   time the objfile is searched.  */
+
+struct symbol_name_filter
+{
+  /* True if some index of the objfile cannot enumerate its names, in
+     which case the objfile is always searched.  */
+  bool always_search = false;
+
+  /* The sorted hashes of the names, see symbol_name_filter_hash.  */
+  std::vector<unsigned int> hashes;
+};
+
+/* Objfile key for the symbol name filter.  */
+
+static const registry<objfile>::key<symbol_name_filter>
+  symbol_name_filter_key;
+
+/* Hash the first LEN characters of NAME the way the indexes compare
+   names: ignoring case and anything from the start of a template
+   parameter list.  */
+
+static unsigned int
+symbol_name_filter_hash (const char *name, size_t len)
+{
+  unsigned int hash = 0;
+
+  for (size_t i = 0; i < len && name[i] != '\0' && name[i] != '<'; ++i)
+    hash = hash * 67 + tolower ((unsigned char) name[i]) - 113;
+  return hash;
+}
+
+/* The languages whose lookup_name_info::split_name styles cover all
+   the ways the indexes split a lookup name.  */
+
+static const enum language symbol_name_filter_languages[] =
+{
+  language_c,
+  language_cplus,
+  language_d,
+  language_ada
+};
+
+/* The hashes of the last components of a lookup name, in each split
+   style.  */
+
+struct symbol_name_filter_keys
+{
+  explicit symbol_name_filter_keys (const char *name)
+  {
+    if (!use_symbol_name_index)
+      return;
+
+    lookup_name_info lookup_name (name, symbol_name_match_type::FULL,
+				  false, true);
+
+    for (enum language lang : symbol_name_filter_languages)
+      {
+	std::vector<gdb::string_view> parts = lookup_name.split_name (lang);
+	if (parts.empty ())
+	  return;
+	hashes.push_back (symbol_name_filter_hash (parts.back ().data (),
+						   parts.back ().length ()));
+      }
+    valid = true;
+  }
+
+  /* False if the index is disabled or the name could not be split, in
+     which case no objfile may be skipped.  */
+  bool valid = false;
+
+  std::vector<unsigned int> hashes;
+};
+
+/* Return the symbol name filter of OBJFILE, building it if needed.  */
+
+static const symbol_name_filter *
+get_symbol_name_filter (struct objfile *objfile)
+{
+  symbol_name_filter *filter = symbol_name_filter_key.get (objfile);
+  if (filter != nullptr)
+    return filter;
+
+  std::vector<unsigned int> hashes;
+  bool complete = objfile->map_symbol_names ([&] (const char *name)
+    {
+      hashes.push_back (symbol_name_filter_hash (name, strlen (name)));
+    });
+
+  filter = symbol_name_filter_key.emplace (objfile);
+  if (complete)
+    {
+      std::sort (hashes.begin (), hashes.end ());
+      hashes.erase (std::unique (hashes.begin (), hashes.end ()),
+		    hashes.end ());
+      hashes.shrink_to_fit ();
+      filter->hashes = std::move (hashes);
+    }
+  else
+    filter->always_search = true;
+
+  return filter;
+}
+
+/* Return true if the quick symbol functions of OBJFILE may find a
+   symbol whose name has KEYS.  */
+
+static bool
+symbol_name_filter_may_match (struct objfile *objfile,
+			      const symbol_name_filter_keys &keys)
+{
+  if (!keys.valid)
+    return true;
+
+  const symbol_name_filter *filter = get_symbol_name_filter (objfile);
+  if (filter->always_search)
+    return true;
+
+  for (unsigned int hash : keys.hashes)
+    if (std::binary_search (filter->hashes.begin (), filter->hashes.end (),
+			    hash))
+      return true;
+
+  return false;
+}
+
 /* This function contains the common code of lookup_{global,static}_symbol.
    OBJFILE is only used if BLOCK_INDEX is GLOBAL_SCOPE, in which case it is
    the objfile to start the lookup in.  */
@@ -2573,14 +2766,24 @@ lookup_global_or_static_symbol (const char *name,
       return result;
     }
 
-  /* Do a global search (of global blocks, heh).  */
+  /* Do a global search (of global blocks, heh).  The expanded symtabs
+     of each objfile are searched, but its quick symbol functions only
+     if its name filter allows it; this skips most objfiles of a large
+     program cheaply.  */
+  symbol_name_filter_keys keys (name);
   if (result.symbol == NULL)
     gdbarch_iterate_over_objfiles_in_search_order
       (objfile != NULL ? objfile->arch () : target_gdbarch (),
-       [&result, block_index, name, domain] (struct objfile *objfile_iter)
+       [&result, &keys, block_index, name, domain]
+	 (struct objfile *objfile_iter)
 	 {
+	   bool search_quick = symbol_name_filter_may_match (objfile_iter,
+							     keys);
+	   if (!search_quick && objfile_iter->compunit_symtabs == nullptr)
+	     return false;
+
 	   result = lookup_symbol_in_objfile (objfile_iter, block_index,
-					      name, domain);
+					      name, domain, search_quick);
 	   return result.symbol != nullptr;
 	 },
        objfile);
@@ -2589,6 +2792,7 @@ lookup_global_or_static_symbol (const char *name,
     symbol_cache_mark_found (bsc, slot, objfile, result.symbol, result.block);
   else
     symbol_cache_mark_not_found (bsc, slot, objfile, name, domain);
+  symbol_cache_maybe_grow (cache, block_index);
 
   return result;
 }
@@ -4646,7 +4850,8 @@ global_symbol_searcher::is_suitable_msymbol
 
 bool
 global_symbol_searcher::expand_symtabs
-	(objfile *objfile, const gdb::optional<compiled_regex> &preg) const
+	(objfile *objfile, const gdb::optional<compiled_regex> &preg,
+	 const char *regexp, int cflags) const
 {
   enum search_domain kind = m_kind;
   bool found_msymbol = false;
@@ -4659,17 +4864,27 @@ global_symbol_searcher::expand_symtabs
   if (!filenames.empty ())
     file_matcher = do_file_match;
 
-  objfile->expand_symtabs_matching
+  /* A compiled regexp must not be used by several threads at once, so
+     each thread matching names compiles its own.  */
+  auto make_matcher
+    = [&] () -> std::function<expand_symtabs_symbol_matcher_ftype>
+    {
+      if (!preg.has_value ())
+	return [] (const char *symname) { return true; };
+
+      std::shared_ptr<compiled_regex> thread_preg
+	= std::make_shared<compiled_regex> (regexp, cflags,
+					    _("Invalid regexp"));
+      return [=] (const char *symname)
+	{
+	  return thread_preg->exec (symname, 0, NULL, 0) == 0;
+	};
+    };
+
+  objfile->expand_symtabs_matching_names
     (file_matcher,
-     &lookup_name_info::match_any (),
-     [&] (const char *symname)
-     {
-       return (!preg.has_value ()
-	       || preg->exec (symname, 0, NULL, 0) == 0);
-     },
-     NULL,
+     make_matcher,
      SEARCH_GLOBAL_BLOCK | SEARCH_STATIC_BLOCK,
-     UNDEF_DOMAIN,
      kind);
 
   /* Here, we search through the minimal symbol tables for functions and
@@ -4689,35 +4904,59 @@ global_symbol_searcher::expand_symtabs
   if (filenames.empty ()
       && (kind == VARIABLES_DOMAIN || kind == FUNCTIONS_DOMAIN))
     {
-      for (minimal_symbol *msymbol : objfile->msymbols ())
-	{
-	  QUIT;
+      /* Match the names on worker threads, then do the lookups, in
+	 order, on this one.  The natural name of an Ada symbol is
+	 computed on demand, which is not thread-safe, so those are
+	 matched here too.  */
+      minimal_symbol *msymbols = objfile->per_bfd->msymbols.get ();
+      std::vector<std::vector<minimal_symbol *>> candidates
+	= gdb::parallel_for_each
+	    (1000, msymbols,
+	     msymbols + objfile->per_bfd->minimal_symbol_count,
+	     [&] (minimal_symbol *iter, minimal_symbol *end)
+	     {
+	       std::function<expand_symtabs_symbol_matcher_ftype> matcher
+		 = make_matcher ();
+	       std::vector<minimal_symbol *> result;
+
+	       for (; iter < end; ++iter)
+		 {
+		   if (iter->created_by_gdb
+		       || !is_suitable_msymbol (kind, iter))
+		     continue;
+
+		   if (iter->language () == language_ada
+		       || matcher (iter->natural_name ()))
+		     result.push_back (iter);
+		 }
+
+	       return result;
+	     });
 
-	  if (msymbol->created_by_gdb)
-	    continue;
+      for (const std::vector<minimal_symbol *> &chunk : candidates)
+	for (minimal_symbol *msymbol : chunk)
+	  {
+	    QUIT;
 
-	  if (is_suitable_msymbol (kind, msymbol))
-	    {
-	      if (!preg.has_value ()
-		  || preg->exec (msymbol->natural_name (), 0,
-				 NULL, 0) == 0)
-		{
-		  /* An important side-effect of these lookup functions is
-		     to expand the symbol table if msymbol is found, later
-		     in the process we will add matching symbols or
-		     msymbols to the results list, and that requires that
-		     the symbols tables are expanded.  */
-		  if (kind == FUNCTIONS_DOMAIN
-		      ? (find_pc_compunit_symtab
-			 (msymbol->value_address (objfile)) == NULL)
-		      : (lookup_symbol_in_objfile_from_linkage_name
-			 (objfile, msymbol->linkage_name (),
-			  VAR_DOMAIN)
-			 .symbol == NULL))
-		    found_msymbol = true;
-		}
-	    }
-	}
+	    if (msymbol->language () == language_ada
+		&& preg.has_value ()
+		&& preg->exec (msymbol->natural_name (), 0, NULL, 0) != 0)
+	      continue;
+
+	    /* An important side-effect of these lookup functions is
+	       to expand the symbol table if msymbol is found, later
+	       in the process we will add matching symbols or
+	       msymbols to the results list, and that requires that
+	       the symbols tables are expanded.  */
+	    if (kind == FUNCTIONS_DOMAIN
+		? (find_pc_compunit_symtab
+		   (msymbol->value_address (objfile)) == NULL)
+		: (lookup_symbol_in_objfile_from_linkage_name
+		   (objfile, msymbol->linkage_name (),
+		    VAR_DOMAIN)
+		   .symbol == NULL))
+	      found_msymbol = true;
+	  }
     }
 
   return found_msymbol;
@@ -4856,13 +5095,15 @@ global_symbol_searcher::search () const
 {
   gdb::optional<compiled_regex> preg;
   gdb::optional<compiled_regex> treg;
+  const char *symbol_name_regexp = nullptr;
+  std::string symbol_name_regexp_holder;
+  int symbol_name_cflags = 0;
 
   gdb_assert (m_kind != ALL_DOMAIN);
 
   if (m_symbol_name_regexp != NULL)
     {
-      const char *symbol_name_regexp = m_symbol_name_regexp;
-      std::string symbol_name_regexp_holder;
+      symbol_name_regexp = m_symbol_name_regexp;
 
       /* Make sure spacing is right for C++ operators.
 	 This is just a courtesy to make the matching less sensitive
@@ -4897,9 +5138,9 @@ global_symbol_searcher::search () const
 	    }
 	}
 
-      int cflags = REG_NOSUB | (case_sensitivity == case_sensitive_off
-				? REG_ICASE : 0);
-      preg.emplace (symbol_name_regexp, cflags,
+      symbol_name_cflags = REG_NOSUB | (case_sensitivity == case_sensitive_off
+					? REG_ICASE : 0);
+      preg.emplace (symbol_name_regexp, symbol_name_cflags,
 		    _("Invalid regexp"));
     }
 
@@ -4917,7 +5158,8 @@ global_symbol_searcher::search () const
     {
       /* Expand symtabs within objfile that possibly contain matching
 	 symbols.  */
-      found_msymbol |= expand_symtabs (objfile, preg);
+      found_msymbol |= expand_symtabs (objfile, preg, symbol_name_regexp,
+				       symbol_name_cflags);
 
       /* Find matching symbols within OBJFILE and add them in to the
 	 RESULT_SET set.  Use a set here so that we can easily detect
@@ -5723,6 +5965,8 @@ add_symtab_completions (struct compunit_symtab *cust,
       const struct block *b = cust->blockvector ()->block (i);
       for (struct symbol *sym : block_iterator_range (b))
 	{
+	  QUIT;
+
 	  if (completion_skip_symbol (mode, sym))
 	    continue;
 
@@ -5842,19 +6086,23 @@ default_collect_symbol_completion_matches_break_on
     }
 
   /* Look through the partial symtabs for all symbols which begin by
-     matching SYM_TEXT.  Expand all CUs that you find to the list.  */
-  expand_symtabs_matching (NULL,
-			   lookup_name,
-			   NULL,
-			   [&] (compunit_symtab *symtab) /* expansion notify */
-			     {
-			       add_symtab_completions (symtab,
-						       tracker, mode, lookup_name,
-						       sym_text, word, code);
-			       return true;
-			     },
-			   SEARCH_GLOBAL_BLOCK | SEARCH_STATIC_BLOCK,
-			   ALL_DOMAIN);
+     matching SYM_TEXT.  Expand all CUs that you find to the list.
+     Stop expanding once no more completions can be added: further
+     CUs could only provide matches that are already known.  */
+  if (!tracker.max_completions_reached ())
+    expand_symtabs_matching (NULL,
+			     lookup_name,
+			     NULL,
+			     [&] (compunit_symtab *symtab) /* expansion notify */
+			       {
+				 add_symtab_completions (symtab,
+							 tracker, mode,
+							 lookup_name,
+							 sym_text, word, code);
+				 return !tracker.max_completions_reached ();
+			       },
+			     SEARCH_GLOBAL_BLOCK | SEARCH_STATIC_BLOCK,
+			     ALL_DOMAIN);
 
   /* Search upwards from currently selected frame (so that we can
      complete on local vars).  Also catch fields of types defined in
@@ -6999,6 +7247,15 @@ the use of prologue scanners."),
 			   &maintenance_set_cmdlist,
 			   &maintenance_show_cmdlist);
 
+  add_setshow_boolean_cmd ("symbol-name-index", class_maintenance,
+			   &use_symbol_name_index, _("\
+Set whether to skip objfiles using an index of their symbol names."), _("\
+Show whether to skip objfiles using an index of their symbol names."), _("\
+When on, looking up a global or static symbol in all objfiles only asks\n\
+the debug info indexes of those objfiles whose symbol names may match."),
+			   nullptr, nullptr,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
 
   add_cmd ("symbol-cache", class_maintenance, maintenance_print_symbol_cache,
 	   _("Dump the symbol cache for each program space."),
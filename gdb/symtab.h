@@ -2599,9 +2599,12 @@ class global_symbol_searcher
 
   /* Expand symtabs in OBJFILE that match PREG, are of type M_KIND.  Return
      true if any msymbols were seen that we should later consider adding to
-     the results list.  */
+     the results list.  PREG was compiled from REGEXP with CFLAGS, which
+     lets names be matched on worker threads, each with its own copy of
+     the regexp.  */
   bool expand_symtabs (objfile *objfile,
-		       const gdb::optional<compiled_regex> &preg) const;
+		       const gdb::optional<compiled_regex> &preg,
+		       const char *regexp, int cflags) const;
 
   /* Add symbols from symtabs in OBJFILE that match PREG, and TREG, and are
      of type M_KIND, to the results set RESULTS_SET.  Return false if we
@@ -2739,7 +2742,8 @@ bool iterate_over_some_symtabs (const char *name,
 				gdb::function_view<bool (symtab *)> callback);
 
 void iterate_over_symtabs (const char *name,
-			   gdb::function_view<bool (symtab *)> callback);
+			   gdb::function_view<bool (symtab *)> callback,
+			   int line = 0);
 
 
 std::vector<CORE_ADDR> find_pcs_for_symtab_line
@@ -54,6 +54,7 @@
 #include "target-connection.h"
 #include "valprint.h"
 #include "cli/cli-decode.h"
+#include "perf-counters.h"
 
 static void generic_tls_error (void) ATTRIBUTE_NORETURN;
 
@@ -1465,6 +1466,16 @@ memory_xfer_check_region (gdb_byte *readbuf, const gdb_byte *writebuf,
   return 1;
 }
 
+/* Counters of raw memory transfers, for "maint info perf-counters".  */
+
+static perf_counter target_memory_reads_counter
+  ("target.memory-reads", N_("Raw memory reads from the target."));
+static perf_counter target_memory_bytes_read_counter
+  ("target.memory-bytes-read",
+   N_("Bytes of raw memory read from the target."));
+static perf_counter target_memory_writes_counter
+  ("target.memory-writes", N_("Raw memory writes to the target."));
+
 /* Read memory from more than one valid target.  A core file, for
    instance, could have some of memory but delegate other bits to
    the target below it.  So, we must manually try all targets.  */
@@ -1500,6 +1511,15 @@ raw_memory_xfer_partial (struct target_ops *ops, gdb_byte *readbuf,
     }
   while (ops != NULL);
 
+  if (readbuf != NULL)
+    {
+      ++target_memory_reads_counter;
+      if (res == TARGET_XFER_OK)
+	target_memory_bytes_read_counter += *xfered_len;
+    }
+  else
+    ++target_memory_writes_counter;
+
   /* The cache works at the raw memory level.  Make sure the cache
      gets updated with raw contents no matter what kind of memory
      object was originally being written.  Note we do write-through
@@ -0,0 +1,40 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "complete-shared-name.h"
+
+struct completion_shared_struct completion_var_2;
+
+struct completion_only_2
+{
+  int member;
+} completion_only_var_2;
+
+/* Each compilation unit has a static variable of this name.  */
+static int completion_static_var = 2;
+
+/* complete-shared-name-3.c has a function and a struct of these
+   names.  */
+static int completion_var_or_func = 2;
+static int completion_var_or_struct = 2;
+
+int
+completion_use_static_2 (void)
+{
+  return (completion_static_var + completion_var_or_func
+	  + completion_var_or_struct);
+}
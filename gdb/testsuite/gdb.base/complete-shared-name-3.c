@@ -0,0 +1,48 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "complete-shared-name.h"
+
+struct completion_shared_struct completion_var_3;
+
+struct completion_only_3
+{
+  int member;
+} completion_only_var_3;
+
+/* Each compilation unit has a static variable of this name.  */
+static int completion_static_var = 3;
+
+int
+completion_use_static_3 (void)
+{
+  return completion_static_var;
+}
+
+/* complete-shared-name-1.c and complete-shared-name-2.c have a
+   variable of each of these names.  */
+
+struct completion_var_or_struct
+{
+  int member;
+} completion_struct_var;
+
+int
+completion_var_or_func (void)
+{
+  return completion_struct_var.member;
+}
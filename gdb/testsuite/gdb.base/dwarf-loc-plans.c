@@ -0,0 +1,50 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct pair
+{
+  int a;
+  char tag[8];
+  double c;
+};
+
+int global_var = 42;
+static double static_array[3] = { 1.5, 2.5, 3.5 };
+
+__attribute__ ((noinline)) int
+callee (int x, struct pair *p, long y)
+{
+  int loc = x * 3;
+  struct pair copy = *p;
+  double d = copy.c + y;
+  volatile int v = loc + 1;
+
+  global_var += loc + (int) d + v;	/* break here */
+  return global_var;
+}
+
+int
+main (void)
+{
+  struct pair st = { 7, "hello", 2.25 };
+  long total = 0;
+  int i;
+
+  for (i = 0; i < 3; i++)
+    total += callee (i + 1, &st, i * 10L);
+  return total + (int) static_array[1] == 0;
+}
@@ -0,0 +1,43 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int global_var;
+
+static void __attribute__ ((noinline))
+leaf (void)
+{
+  global_var++;		/* Break here.  */
+  global_var++;
+  global_var++;
+}
+
+static void __attribute__ ((noinline))
+recurse (int depth)
+{
+  if (depth > 0)
+    recurse (depth - 1);
+  else
+    leaf ();
+  global_var++;
+}
+
+int
+main (void)
+{
+  recurse (20);
+  return 0;
+}
@@ -0,0 +1,43 @@
+/* Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+int global_var = 1;
+static int static_var = 2;
+
+static int __attribute__ ((noinline))
+static_func (int x)
+{
+  return x + static_var;
+}
+
+int __attribute__ ((noinline))
+func1 (int x)
+{
+  return static_func (x) * 2;
+}
+
+int __attribute__ ((noinline))
+func2 (int x)
+{
+  return func1 (x) + global_var;
+}
+
+int
+main (void)
+{
+  return func2 (0) == 0;
+}
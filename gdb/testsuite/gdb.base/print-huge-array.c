@@ -0,0 +1,46 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Both arrays are much larger than the default max-value-size.  */
+
+#define HUGE_SIZE (1024 * 1024)
+
+int huge_array[HUGE_SIZE / sizeof (int)];
+char huge_string[HUGE_SIZE];
+
+static void
+marker (void)
+{
+  static int huge_local[HUGE_SIZE / sizeof (int)];
+
+  huge_local[HUGE_SIZE / sizeof (int) - 1] = 7;
+}
+
+int
+main (void)
+{
+  int i;
+
+  /* The last element is in the last chunk GDB reads.  */
+  huge_array[HUGE_SIZE / sizeof (int) - 1] = 5;
+
+  for (i = 0; i < 1000; i++)
+    huge_string[i] = 'a' + i % 26;
+
+  marker ();
+  return 0;
+}
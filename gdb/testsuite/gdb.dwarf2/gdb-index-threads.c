@@ -0,0 +1,43 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Define enough names that writing the index spreads the work over
+   the worker threads: 2048 variables and as many functions.  */
+
+#define DEFINE(N)				\
+  int var_ ## N;				\
+  int func_ ## N (void) { return var_ ## N; }
+
+#define DEFINE_2(N) DEFINE (N ## 0) DEFINE (N ## 1)
+#define DEFINE_4(N) DEFINE_2 (N ## 0) DEFINE_2 (N ## 1)
+#define DEFINE_8(N) DEFINE_4 (N ## 0) DEFINE_4 (N ## 1)
+#define DEFINE_16(N) DEFINE_8 (N ## 0) DEFINE_8 (N ## 1)
+#define DEFINE_32(N) DEFINE_16 (N ## 0) DEFINE_16 (N ## 1)
+#define DEFINE_64(N) DEFINE_32 (N ## 0) DEFINE_32 (N ## 1)
+#define DEFINE_128(N) DEFINE_64 (N ## 0) DEFINE_64 (N ## 1)
+#define DEFINE_256(N) DEFINE_128 (N ## 0) DEFINE_128 (N ## 1)
+#define DEFINE_512(N) DEFINE_256 (N ## 0) DEFINE_256 (N ## 1)
+#define DEFINE_1024(N) DEFINE_512 (N ## 0) DEFINE_512 (N ## 1)
+#define DEFINE_2048(N) DEFINE_1024 (N ## 0) DEFINE_1024 (N ## 1)
+
+DEFINE_2048 (n)
+
+int
+main (void)
+{
+  return func_n00000000000 ();
+}
@@ -0,0 +1,42 @@
+/* Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct inner
+{
+  int x;
+  int y;
+};
+
+struct outer
+{
+  int a;
+  struct inner in;
+  int arr[3];
+  int *p;
+};
+
+int target = 5;
+
+int
+main (void)
+{
+  struct outer s = { 1, { 2, 3 }, { 4, 5, 6 }, &target };
+
+  target = 10;	/* Varobjs created here.  */
+  s.in.y = 30;	/* Pointee changed.  */
+  return 0;	/* Member changed.  */
+}
@@ -65,6 +65,7 @@ class TestCase(object):
 
         self.execute_test()
         self.measure.report(reporter.TextReporter(append), self.name)
+        self.measure.report(reporter.JsonReporter(append), self.name)
 
 
 class TestCaseWithBasicMeasurements(TestCase):
@@ -0,0 +1,42 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Define 4096 small functions, func_000 to func_fff, so that there are
+   many minimal symbols to search.  */
+
+#define FUNC(n) int func_##n (int x) { return x + 0x##n; }
+#define FUNC16(n)							\
+  FUNC (n##0) FUNC (n##1) FUNC (n##2) FUNC (n##3)			\
+  FUNC (n##4) FUNC (n##5) FUNC (n##6) FUNC (n##7)			\
+  FUNC (n##8) FUNC (n##9) FUNC (n##a) FUNC (n##b)			\
+  FUNC (n##c) FUNC (n##d) FUNC (n##e) FUNC (n##f)
+#define FUNC256(n)							\
+  FUNC16 (n##0) FUNC16 (n##1) FUNC16 (n##2) FUNC16 (n##3)		\
+  FUNC16 (n##4) FUNC16 (n##5) FUNC16 (n##6) FUNC16 (n##7)		\
+  FUNC16 (n##8) FUNC16 (n##9) FUNC16 (n##a) FUNC16 (n##b)		\
+  FUNC16 (n##c) FUNC16 (n##d) FUNC16 (n##e) FUNC16 (n##f)
+
+FUNC256 (0) FUNC256 (1) FUNC256 (2) FUNC256 (3)
+FUNC256 (4) FUNC256 (5) FUNC256 (6) FUNC256 (7)
+FUNC256 (8) FUNC256 (9) FUNC256 (a) FUNC256 (b)
+FUNC256 (c) FUNC256 (d) FUNC256 (e) FUNC256 (f)
+
+int
+main (void)
+{
+  return func_000 (0);
+}
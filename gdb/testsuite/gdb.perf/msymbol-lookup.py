@@ -0,0 +1,43 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+
+class MsymbolLookup(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, num_lookups):
+        super(MsymbolLookup, self).__init__("msymbol-lookup")
+        self.num_lookups = num_lookups
+
+    def warm_up(self):
+        first = int(gdb.parse_and_eval("(long) &func_000"))
+        last = int(gdb.parse_and_eval("(long) &func_fff"))
+        lo = min(first, last)
+        hi = max(first, last)
+        step = max(1, (hi - lo) // self.num_lookups)
+        self.addresses = list(range(lo, hi, step))[: self.num_lookups]
+        self._do_test()
+
+    def _do_test(self):
+        # gdb.format_address finds the minimal symbol for each address.
+        for addr in self.addresses:
+            gdb.format_address(addr)
+
+    def execute_test(self):
+        for index in ("on", "off"):
+            gdb.execute("maint set msymbol-pc-index %s" % index)
+            func = lambda: self._do_test()
+            self.measure.measure(func, index)
+        gdb.execute("maint set msymbol-pc-index on")
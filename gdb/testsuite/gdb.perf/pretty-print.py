@@ -0,0 +1,60 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import gdb.printing
+
+from perftest import perftest
+
+
+class ElementPrinter:
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "%d => %d" % (int(self.val["key"]), int(self.val["value"]))
+
+
+def build_pretty_printer(index):
+    # Mimic a typical printer collection, where most regexps do not
+    # match the element type.
+    pp = gdb.printing.RegexpCollectionPrettyPrinter("perf-pp-%d" % index)
+    for i in range(0, 20):
+        pp.add_printer("unused%d" % i, "^unused_type_%d$" % i, ElementPrinter)
+    if index == 0:
+        pp.add_printer("element", "^element$", ElementPrinter)
+    return pp
+
+
+class PrettyPrint(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, num_collections):
+        super(PrettyPrint, self).__init__("pretty-print")
+        self.num_collections = num_collections
+
+    def warm_up(self):
+        for i in range(0, self.num_collections):
+            gdb.printing.register_pretty_printer(
+                None, build_pretty_printer(i), replace=True
+            )
+        gdb.execute("set print elements unlimited")
+        gdb.execute("set print repeats unlimited")
+        gdb.execute("print elements", False, True)
+
+    def _do_test(self):
+        gdb.execute("print elements", False, True)
+
+    def execute_test(self):
+        for count in (1, 2, 4):
+            func = lambda: [self._do_test() for _ in range(0, count)]
+            self.measure.measure(func, count)
@@ -0,0 +1,105 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* The program attached to by scale.exp.  It starts the number of
+   threads given by its first argument, each blocked SCALE_DEPTH frames
+   deep, and dlopens the number of shared libraries given by its second
+   argument.  The number of CUs is fixed at build time: scale.exp
+   generates them, along with scale_call_cus, which calls a function
+   in each.  */
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifndef SCALE_DEPTH
+#define SCALE_DEPTH 16
+#endif
+
+extern void scale_call_cus (void);
+
+static volatile int scale_done;
+
+static int
+scale_recurse (int depth)
+{
+  if (depth == 0)
+    {
+      while (!scale_done)
+	usleep (1000);
+      return 0;
+    }
+
+  return scale_recurse (depth - 1) + 1;
+}
+
+static void *
+scale_thread (void *arg)
+{
+  scale_recurse (SCALE_DEPTH);
+  return NULL;
+}
+
+/* Called by the main thread once per millisecond, for the stop and
+   resume benchmark to put a breakpoint on.  */
+
+void
+scale_tick (void)
+{
+}
+
+int
+main (int argc, char **argv)
+{
+  int n_threads = argc > 1 ? atoi (argv[1]) : 1;
+  int n_solibs = argc > 2 ? atoi (argv[2]) : 0;
+  char libname[40];
+  pthread_t thread;
+  int i;
+
+  /* Don't outlive the testsuite if something goes wrong.  */
+  alarm (600);
+
+  for (i = 0; i < n_solibs; i++)
+    {
+      sprintf (libname, "scale-lib%d", i);
+      if (dlopen (libname, RTLD_NOW) == NULL)
+	{
+	  printf ("ERROR on dlopen %s\n", libname);
+	  exit (1);
+	}
+    }
+
+  scale_call_cus ();
+
+  for (i = 0; i < n_threads; i++)
+    if (pthread_create (&thread, NULL, scale_thread, NULL) != 0)
+      {
+	printf ("ERROR on pthread_create\n");
+	exit (1);
+      }
+
+  while (1)
+    {
+      scale_tick ();
+      usleep (1000);
+    }
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This test case measures how GDB scales with the number of threads,
+# shared libraries and CUs of a program it attaches to.
+
+from perftest import perftest
+
+
+class ScaleTest(perftest.TestCaseWithBasicMeasurements):
+    """Base class of the scaling tests.
+
+    Each test attaches to the program, measures one operation for the
+    configuration, and detaches again.
+    """
+
+    def __init__(self, name, pid, threads, solibs, cus):
+        super(ScaleTest, self).__init__(name)
+        self.pid = pid
+        self.threads = threads
+        self.solibs = solibs
+        self.cus = cus
+        self.config = "threads=%d,solibs=%d,cus=%d" % (threads, solibs, cus)
+
+    def attach(self):
+        gdb.execute("attach %d" % self.pid, False, True)
+
+    def detach(self):
+        gdb.execute("detach", False, True)
+
+    def _do_test(self):
+        """Do the operation being measured."""
+        raise NotImplementedError("Abstract Method.")
+
+    def execute_test(self):
+        self.attach()
+        self.measure.measure(lambda: self._do_test(), self.config)
+        self.detach()
+
+
+class ScaleAttach(ScaleTest):
+    def __init__(self, *args):
+        super(ScaleAttach, self).__init__("scale_attach", *args)
+
+    def execute_test(self):
+        self.measure.measure(lambda: self.attach(), self.config)
+        self.detach()
+
+
+class ScaleFirstBacktrace(ScaleTest):
+    def __init__(self, *args):
+        super(ScaleFirstBacktrace, self).__init__("scale_first_bt", *args)
+
+    def _do_test(self):
+        gdb.execute("bt", False, True)
+
+    def execute_test(self):
+        self.attach()
+        # Select a thread other than the one that stopped, with nothing
+        # of it cached yet.
+        if self.threads > 0:
+            gdb.execute("thread 2", False, True)
+        gdb.execute("maint flush register-cache", False, True)
+        gdb.execute("maint flush dcache", False, True)
+        self.measure.measure(lambda: self._do_test(), self.config)
+        self.detach()
+
+
+class ScaleThreadApplyAllBacktrace(ScaleTest):
+    def __init__(self, *args):
+        super(ScaleThreadApplyAllBacktrace, self).__init__(
+            "scale_thread_apply_all_bt", *args
+        )
+
+    def _do_test(self):
+        gdb.execute("thread apply all bt", False, True)
+
+
+class ScaleBreakpointInsert(ScaleTest):
+    def __init__(self, *args):
+        super(ScaleBreakpointInsert, self).__init__("scale_break_insert", *args)
+
+    def _do_test(self):
+        # Breakpoints are inserted as they are created.
+        for i in range(self.solibs):
+            gdb.execute("break scale_lib_func%d" % i, False, True)
+        for i in range(min(self.cus, 64)):
+            gdb.execute("break scale_cu_func%d" % i, False, True)
+
+    def execute_test(self):
+        gdb.execute("set breakpoint always-inserted on")
+        super(ScaleBreakpointInsert, self).execute_test()
+        gdb.execute("delete")
+        gdb.execute("set breakpoint always-inserted off")
+
+
+class ScaleStopResume(ScaleTest):
+    def __init__(self, *args):
+        super(ScaleStopResume, self).__init__("scale_stop_resume", *args)
+
+    def _do_test(self):
+        for _ in range(10):
+            gdb.execute("continue", False, True)
+
+    def execute_test(self):
+        gdb.execute("break scale_tick", False, True)
+        super(ScaleStopResume, self).execute_test()
+        gdb.execute("delete")
+
+
+class ScaleBenchmark(object):
+    def __init__(self, pid, threads, solibs, cus):
+        self.args = (pid, threads, solibs, cus)
+
+    def run(self):
+        ScaleAttach(*self.args).run()
+        ScaleFirstBacktrace(*self.args).run()
+        ScaleThreadApplyAllBacktrace(*self.args).run()
+        ScaleBreakpointInsert(*self.args).run()
+        ScaleStopResume(*self.args).run()
@@ -0,0 +1,46 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Measure the time to load and index a program whose debug info is in
+# .dwo files, with and without worker threads.
+
+from perftest import perftest
+from perftest import utils
+
+
+class SplitDwarf(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, binfile):
+        super(SplitDwarf, self).__init__("split-dwarf")
+        self.binfile = binfile
+
+    def warm_up(self):
+        # Get the files into the system's page cache.
+        self._doit()
+
+    def _doit(self):
+        utils.select_file(None)
+        utils.select_file(self.binfile)
+        # Looking up a symbol waits for the index to be complete.
+        gdb.execute("info functions ^split_dwarf_no_such_function$", to_string=True)
+
+    def execute_test(self):
+        for threads in ("0", "unlimited"):
+            gdb.execute("maint set worker-threads %s" % threads)
+            iteration = 3
+            while iteration > 0:
+                func = lambda: self._doit()
+                self.measure.measure(func, "worker-threads-%s" % threads)
+                iteration -= 1
+        gdb.execute("maint set worker-threads unlimited")
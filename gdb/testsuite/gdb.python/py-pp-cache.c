@@ -0,0 +1,41 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2023 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see  <http://www.gnu.org/licenses/>.  */
+
+struct point
+{
+  int x;
+  int y;
+};
+
+struct other
+{
+  int a;
+};
+
+struct point points[8] =
+  {
+    { 0, 0 }, { 1, 1 }, { 2, 2 }, { 3, 3 },
+    { 4, 4 }, { 5, 5 }, { 6, 6 }, { 7, 7 }
+  };
+
+struct other other = { 1 };
+
+int
+main (void)
+{
+  return points[0].x + other.a;
+}
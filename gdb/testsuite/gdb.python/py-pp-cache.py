@@ -0,0 +1,58 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It tests the caching of
+# pretty-printer lookups.
+
+import gdb
+
+
+class NamePrinter:
+    def __init__(self, name):
+        self.name = name
+
+    def to_string(self):
+        return self.name
+
+
+class CountingLookup:
+    """A lookup function that counts how often it is called, and
+    recognizes structures with the tag TAG, if TAG is not None."""
+
+    def __init__(self, name, tag):
+        self.name = name
+        self.tag = tag
+        self.enabled = True
+        self.cacheable = True
+        self.calls = 0
+
+    def __call__(self, val):
+        self.calls += 1
+        if self.tag is not None and val.type.strip_typedefs().tag == self.tag:
+            return NamePrinter(self.tag)
+        return None
+
+
+def reset_counts():
+    miss_lookup.calls = 0
+    point_lookup.calls = 0
+
+
+miss_lookup = CountingLookup("miss", None)
+point_lookup = CountingLookup("point", "point")
+other_lookup = CountingLookup("other", "other")
+
+gdb.pretty_printers.append(miss_lookup)
+gdb.pretty_printers.append(point_lookup)
@@ -0,0 +1,70 @@
+/* Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define NUM_THREADS 4
+
+static pthread_barrier_t barrier;
+static volatile int started;
+static pthread_mutex_t started_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void
+worker_block (void)
+{
+  pthread_mutex_lock (&started_mutex);
+  started++;
+  pthread_mutex_unlock (&started_mutex);
+
+  /* The main thread never reaches the barrier, so this blocks
+     forever, and all workers end up with the same backtrace.  */
+  pthread_barrier_wait (&barrier);
+}
+
+static void *
+worker (void *arg)
+{
+  worker_block ();
+  return NULL;
+}
+
+static void
+all_started (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, worker, NULL);
+
+  while (started < NUM_THREADS)
+    usleep (1000);
+
+  /* Give the last worker time to block in the barrier.  */
+  usleep (100000);
+
+  all_started ();
+  return 0;
+}
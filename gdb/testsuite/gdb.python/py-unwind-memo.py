@@ -0,0 +1,36 @@
+# Copyright (C) 2023 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It registers a Python
+# unwinder once frames have been remembered across a stop.
+
+import gdb
+from gdb.unwinder import Unwinder, register_unwinder
+
+# The levels of the frames the unwinder was asked about.
+seen_levels = set()
+
+
+class MemoUnwinder(Unwinder):
+    def __init__(self):
+        super(MemoUnwinder, self).__init__("memo_unwinder")
+
+    def __call__(self, pending_frame):
+        seen_levels.add(pending_frame.level())
+        return None
+
+
+register_unwinder(None, MemoUnwinder(), replace=True)
+print("Python script imported")
@@ -41,6 +41,8 @@ typedef struct s *PTR;
 
 enum e evalue = TWO;
 
+struct s sarray[3] = { { 1, 10 }, { 2, 20 }, { 3, 30 } };
+
 struct str
 {
   int length;
@@ -74,6 +74,7 @@
 #include "cli-out.h"
 #include "tracepoint.h"
 #include "inf-loop.h"
+#include "trace-events.h"
 
 #if defined(TUI)
 # include "tui/tui.h"
@@ -487,6 +488,7 @@ execute_command (const char *p, int from_tty)
       int was_sync = current_ui->prompt_state == PROMPT_BLOCKED;
 
       line = p;
+      scoped_trace_event trace ("command", "execute command", line);
 
       /* If trace-commands is set then this will print this command.  */
       print_command_trace ("%s", p);
@@ -0,0 +1,267 @@
+/* Timeline of GDB's work, in the Chrome trace event format.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "trace-events.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "observable.h"
+#include "run-on-main-thread.h"
+#include "gdbsupport/gdb_file.h"
+#include "gdbsupport/filestuff.h"
+
+#if CXX_STD_THREAD
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#endif
+
+/* See trace-events.h.  */
+
+std::atomic<bool> trace_events_enabled;
+
+/* The name of the trace file, set by "maint set trace-file".  */
+
+static std::string trace_file_name;
+
+/* The open trace file, or NULL.  The variables below are protected
+   by TRACE_LOCK, because events are recorded by worker threads
+   too.  */
+
+static gdb_file_up trace_file;
+
+/* The time at which the trace file was opened.  Timestamps are
+   relative to it.  */
+
+static std::chrono::steady_clock::time_point trace_epoch;
+
+/* Whether no event has been written to the trace file yet.  */
+
+static bool trace_first_event;
+
+#if CXX_STD_THREAD
+static std::mutex trace_lock;
+
+/* The small numbers used as thread IDs in the trace, so that each
+   thread gets its own track.  */
+
+static std::unordered_map<std::thread::id, int> trace_thread_ids;
+#endif
+
+/* Append S to OUT as a JSON string, with quotes.  */
+
+static void
+append_json_string (std::string &out, const char *s)
+{
+  out += '"';
+  for (; *s != '\0'; ++s)
+    {
+      unsigned char c = *s;
+      if (c == '"' || c == '\\')
+	{
+	  out += '\\';
+	  out += c;
+	}
+      else if (c < 0x20)
+	out += string_printf ("\\u%04x", c);
+      else
+	out += c;
+    }
+  out += '"';
+}
+
+/* Write the event EVENT, a JSON object, to the trace file.  The
+   caller must hold TRACE_LOCK.  */
+
+static void
+write_trace_event_locked (const std::string &event)
+{
+  if (!trace_first_event)
+    fputs (",\n", trace_file.get ());
+  trace_first_event = false;
+  fputs (event.c_str (), trace_file.get ());
+}
+
+/* Return the ID of the current thread in the trace.  The first time a
+   thread is seen, its name is written to the trace file.  The caller
+   must hold TRACE_LOCK.  */
+
+static int
+trace_thread_id_locked ()
+{
+#if CXX_STD_THREAD
+  auto inserted
+    = trace_thread_ids.emplace (std::this_thread::get_id (),
+				trace_thread_ids.size () + 1);
+  int id = inserted.first->second;
+  if (inserted.second)
+    {
+      std::string name = (is_main_thread ()
+			  ? std::string ("main")
+			  : string_printf ("worker %d", id));
+      std::string event = string_printf ("{\"name\":\"thread_name\","
+					 "\"ph\":\"M\",\"pid\":%d,"
+					 "\"tid\":%d,\"args\":{\"name\":",
+					 (int) getpid (), id);
+      append_json_string (event, name.c_str ());
+      event += "}}";
+      write_trace_event_locked (event);
+    }
+  return id;
+#else
+  return 1;
+#endif
+}
+
+/* Close the trace file, if one is open.  */
+
+static void
+close_trace_file ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (trace_lock);
+#endif
+
+  trace_events_enabled = false;
+  if (trace_file != nullptr)
+    {
+      fputs ("\n]\n", trace_file.get ());
+      trace_file.reset ();
+    }
+#if CXX_STD_THREAD
+  trace_thread_ids.clear ();
+#endif
+}
+
+/* See trace-events.h.  */
+
+void
+scoped_trace_event::start (const char *category, const char *name,
+			   const char *detail)
+{
+  m_category = category;
+  m_name = name;
+  if (detail != nullptr)
+    m_detail = detail;
+  m_start = std::chrono::steady_clock::now ();
+}
+
+/* See trace-events.h.  */
+
+void
+scoped_trace_event::finish ()
+{
+  auto end = std::chrono::steady_clock::now ();
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (trace_lock);
+#endif
+
+  /* The trace file may have been closed, or replaced, since the event
+     started.  */
+  if (trace_file == nullptr || m_start < trace_epoch)
+    return;
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  long long ts = duration_cast<microseconds> (m_start - trace_epoch).count ();
+  long long dur = duration_cast<microseconds> (end - m_start).count ();
+  int tid = trace_thread_id_locked ();
+
+  std::string event = "{\"name\":";
+  append_json_string (event, m_name);
+  event += ",\"cat\":";
+  append_json_string (event, m_category);
+  event += string_printf (",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,"
+			  "\"pid\":%d,\"tid\":%d",
+			  ts, dur, (int) getpid (), tid);
+  if (!m_detail.empty ())
+    {
+      event += ",\"args\":{\"detail\":";
+      append_json_string (event, m_detail.c_str ());
+      event += "}";
+    }
+  event += "}";
+  write_trace_event_locked (event);
+}
+
+/* Implement "maint set trace-file".  */
+
+static void
+set_trace_file (const char *args, int from_tty, struct cmd_list_element *c)
+{
+  close_trace_file ();
+
+  if (trace_file_name.empty ())
+    return;
+
+  gdb_file_up file = gdb_fopen_cloexec (trace_file_name.c_str (), "w");
+  if (file == nullptr)
+    {
+      std::string name = std::move (trace_file_name);
+      trace_file_name.clear ();
+      perror_with_name (name.c_str ());
+    }
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (trace_lock);
+#endif
+  fputs ("[\n", file.get ());
+  trace_file = std::move (file);
+  trace_epoch = std::chrono::steady_clock::now ();
+  trace_first_event = true;
+  trace_events_enabled = true;
+}
+
+/* Implement "maint show trace-file".  */
+
+static void
+show_trace_file (struct ui_file *file, int from_tty,
+		 struct cmd_list_element *c, const char *value)
+{
+  if (*value == '\0')
+    gdb_printf (file, _("GDB is not writing a trace file.\n"));
+  else
+    gdb_printf (file, _("GDB is writing trace events to \"%s\".\n"),
+		value);
+}
+
+void _initialize_trace_events ();
+void
+_initialize_trace_events ()
+{
+  add_setshow_optional_filename_cmd ("trace-file", class_maintenance,
+				     &trace_file_name, _("\
+Set the file to which GDB writes a timeline of its work."), _("\
+Show the file to which GDB writes a timeline of its work."), _("\
+When set, GDB records how long it spends opening files, reading\n\
+symbols, indexing DWARF, reading shared libraries, querying debuginfod,\n\
+loading scripts and executing commands, and writes these events to the\n\
+file in the Chrome trace event format, for use with chrome://tracing or\n\
+Perfetto.  Use \"maint set trace-file\" with no argument to stop tracing\n\
+and close the file.  To trace GDB's startup, set this with -iex."),
+				     set_trace_file, show_trace_file,
+				     &maintenance_set_cmdlist,
+				     &maintenance_show_cmdlist);
+
+  gdb::observers::gdb_exiting.attach ([] (int exit_code)
+    {
+      close_trace_file ();
+    }, "trace-events");
+}
@@ -0,0 +1,85 @@
+/* Timeline of GDB's work, in the Chrome trace event format.
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef TRACE_EVENTS_H
+#define TRACE_EVENTS_H
+
+#include <atomic>
+#include <chrono>
+
+/* When "maint set trace-file" names a file, GDB records how long the
+   phases of its work take -- opening BFDs, reading minimal symbols,
+   indexing DWARF, reading shared libraries, querying debuginfod,
+   running auto-loaded scripts, executing commands -- and writes them
+   to that file as "complete" events in the JSON array format
+   understood by chrome://tracing and Perfetto.  Events are recorded
+   from any thread, so the work of the thread pool shows up on one
+   track per worker thread.  */
+
+/* True if trace events are being written.  This is only meant to be
+   used by scoped_trace_event.  */
+
+extern std::atomic<bool> trace_events_enabled;
+
+/* Record the time spent in a scope as a trace event.  When no trace
+   file is open, this costs a single relaxed load.  */
+
+class scoped_trace_event
+{
+public:
+
+  /* Start an event named NAME, in category CATEGORY.  Both must be
+     static strings.  DETAIL, if not NULL, is copied into the event's
+     arguments; it is typically the name of the objfile or the command
+     being worked on.  */
+  scoped_trace_event (const char *category, const char *name,
+		      const char *detail = nullptr)
+  {
+    if (trace_events_enabled.load (std::memory_order_relaxed))
+      start (category, name, detail);
+  }
+
+  ~scoped_trace_event ()
+  {
+    if (m_category != nullptr)
+      finish ();
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_trace_event);
+
+private:
+
+  void start (const char *category, const char *name, const char *detail);
+  void finish ();
+
+  /* The category of the event, or NULL if no event is being
+     recorded.  */
+  const char *m_category = nullptr;
+
+  /* The name of the event.  */
+  const char *m_name = nullptr;
+
+  /* The detail of the event, or empty.  */
+  std::string m_detail;
+
+  /* When the event started.  */
+  std::chrono::steady_clock::time_point m_start;
+};
+
+#endif /* TRACE_EVENTS_H */
@@ -0,0 +1,144 @@
+/* Self tests for bcache and concurrent_bcache
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "gdbsupport/selftest.h"
+#include "gdbsupport/parallel-for.h"
+#include "bcache.h"
+
+#include <atomic>
+
+namespace selftests {
+namespace bcache {
+
+/* The number of distinct strings used by the tests.  */
+
+static const int n_strings = 20000;
+
+/* Return the I'th test string.  */
+
+static std::string
+test_string (int i)
+{
+  return string_printf ("name-%d", i);
+}
+
+/* Check that CACHE hands back a single copy of each string, starting
+   from an empty cache.  */
+
+template<typename Bcache>
+static void
+test_sequential (Bcache &cache)
+{
+  std::vector<const char *> copies (n_strings);
+
+  /* This is enough strings for the hash table to be expanded several
+     times.  */
+  for (int i = 0; i < n_strings; ++i)
+    {
+      std::string s = test_string (i);
+      bool added;
+      copies[i] = (const char *) cache.insert (s.c_str (), s.size () + 1,
+					       &added);
+      SELF_CHECK (added);
+      SELF_CHECK (s == copies[i]);
+    }
+
+  for (int i = 0; i < n_strings; ++i)
+    {
+      std::string s = test_string (i);
+      bool added;
+      SELF_CHECK (cache.insert (s.c_str (), s.size () + 1, &added)
+		  == copies[i]);
+      SELF_CHECK (!added);
+    }
+}
+
+static void
+test_bcache ()
+{
+  gdb::bcache cache;
+  test_sequential (cache);
+
+  gdb::concurrent_bcache ccache;
+  test_sequential (ccache);
+}
+
+#if CXX_STD_THREAD
+
+/* Insert the same strings from several threads at once, and check
+   that every thread gets the same copy, and that each string is
+   added exactly once.  */
+
+static void
+test_concurrent_bcache ()
+{
+  gdb::concurrent_bcache cache;
+
+  /* Each string is inserted this many times.  */
+  const int n_rounds = 4;
+
+  std::vector<std::atomic<const char *>> copies (n_strings);
+  for (auto &copy : copies)
+    copy = nullptr;
+  std::atomic<int> n_added (0);
+  std::atomic<bool> mismatch (false);
+
+  gdb::parallel_for_each (1, 0, n_strings * n_rounds,
+    [&] (int start, int end)
+      {
+	for (int i = start; i < end; ++i)
+	  {
+	    int idx = i % n_strings;
+	    std::string s = test_string (idx);
+	    bool added;
+	    const char *copy
+	      = (const char *) cache.insert (s.c_str (), s.size () + 1,
+					     &added);
+	    if (added)
+	      ++n_added;
+
+	    const char *expected = nullptr;
+	    if (!copies[idx].compare_exchange_strong (expected, copy)
+		&& expected != copy)
+	      mismatch = true;
+	    if (s != copy)
+	      mismatch = true;
+	  }
+      });
+
+  SELF_CHECK (!mismatch);
+  SELF_CHECK (n_added == n_strings);
+}
+
+#endif /* CXX_STD_THREAD */
+
+}
+}
+
+void _initialize_bcache_selftests ();
+void
+_initialize_bcache_selftests ()
+{
+  selftests::register_test ("bcache", selftests::bcache::test_bcache);
+#if CXX_STD_THREAD
+  selftests::register_test ("concurrent-bcache",
+			    selftests::bcache::test_concurrent_bcache);
+#endif /* CXX_STD_THREAD */
+}
@@ -84,6 +84,55 @@ run_tests ()
 				 wpattern, sizeof (wpattern), &addr);
   SELF_CHECK (result == 1);
   SELF_CHECK (addr == found_addr);
+
+  /* A large search space is read in large blocks, and a pattern that
+     straddles two of them is found.  The second read ends at
+     3 * SEARCH_CHUNK_SIZE + 3.  */
+  size = 8 * SEARCH_MAX_CHUNK_SIZE;
+  data = std::vector<gdb_byte> (size);
+  const CORE_ADDR straddle_addr = 3 * SEARCH_CHUNK_SIZE + 1;
+  memcpy (&data[straddle_addr], wpattern, sizeof (wpattern));
+
+  int nr_reads = 0;
+  auto read_memory_3 = [&] (CORE_ADDR from, gdb_byte *out, size_t len)
+    {
+      ++nr_reads;
+      memcpy (out, &data[from], len);
+      return true;
+    };
+
+  result = simple_search_memory (read_memory_3, 0, data.size (),
+				 wpattern, sizeof (wpattern), &addr);
+  SELF_CHECK (result == 1);
+  SELF_CHECK (addr == straddle_addr);
+
+  memset (&data[straddle_addr], 0, sizeof (wpattern));
+  nr_reads = 0;
+  result = simple_search_memory (read_memory_3, 0, data.size (),
+				 wpattern, sizeof (wpattern), &addr);
+  SELF_CHECK (result == 0);
+  SELF_CHECK (nr_reads < 2 * size / SEARCH_MAX_CHUNK_SIZE);
+
+  /* A match that precedes memory that can't be read is found, even
+     if a large read would include that memory.  Reads of
+     SEARCH_CHUNK_SIZE bytes would end at UNREADABLE_ADDR.  */
+  const CORE_ADDR unreadable_addr
+    = 5 * SEARCH_CHUNK_SIZE + sizeof (wpattern) - 1;
+  const CORE_ADDR before_addr = unreadable_addr - 10;
+  memcpy (&data[before_addr], wpattern, sizeof (wpattern));
+
+  auto read_memory_4 = [&] (CORE_ADDR from, gdb_byte *out, size_t len)
+    {
+      if (from + len > unreadable_addr)
+	return false;
+      memcpy (out, &data[from], len);
+      return true;
+    };
+
+  result = simple_search_memory (read_memory_4, 0, data.size (),
+				 wpattern, sizeof (wpattern), &addr);
+  SELF_CHECK (result == 1);
+  SELF_CHECK (addr == before_addr);
 }
 
 } /* namespace search_memory_tests */
@@ -0,0 +1,146 @@
+/* Self tests for the thread pool
+
+   Copyright (C) 2023 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "gdbsupport/selftest.h"
+#include "gdbsupport/thread-pool.h"
+
+#if CXX_STD_THREAD
+
+namespace selftests {
+namespace thread_pool {
+
+/* Restore the thread count of the global thread pool on scope
+   exit.  */
+
+struct save_restore_n_threads
+{
+  save_restore_n_threads ()
+    : n_threads (gdb::thread_pool::g_thread_pool->thread_count ())
+  {
+  }
+
+  ~save_restore_n_threads ()
+  {
+    gdb::thread_pool::g_thread_pool->set_thread_count (n_threads);
+  }
+
+  size_t n_threads;
+};
+
+/* Check that foreground tasks are run before background tasks that
+   were posted earlier, and that cancelled tasks are not run.  */
+
+static void
+test_priorities_and_cancellation ()
+{
+  save_restore_n_threads saver;
+  gdb::thread_pool *pool = gdb::thread_pool::g_thread_pool;
+
+  /* With a single worker thread, the tasks are run one at a time, in
+     the order the thread pool picks them.  Surplus workers only exit
+     once they find no task to run, so wait for them to do so before
+     posting any.  */
+  pool->set_thread_count (1);
+  while (pool->exiting_threads () > 0)
+    std::this_thread::sleep_for (std::chrono::milliseconds (1));
+
+  /* Keep the worker busy until everything is posted.  */
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future ().share ();
+  gdb::future<void> blocker = pool->post_task ([released] ()
+    {
+      released.wait ();
+    });
+
+  std::mutex order_mutex;
+  std::vector<int> order;
+  auto record = [&] (int n)
+    {
+      std::lock_guard<std::mutex> guard (order_mutex);
+      order.push_back (n);
+    };
+
+  gdb::cancellation_token token;
+  std::vector<gdb::future<void>> futures;
+  futures.push_back (pool->post_task ([&] () { record (1); },
+				      gdb::task_priority::background));
+  futures.push_back (pool->post_task ([&] () { record (2); },
+				      gdb::task_priority::background, token));
+  futures.push_back (pool->post_task ([&] () { record (3); }));
+  futures.push_back (pool->post_task ([&] () { record (4); },
+				      gdb::task_priority::foreground));
+  token.cancel ();
+  SELF_CHECK (token.cancelled ());
+
+  release.set_value ();
+  blocker.get ();
+  for (auto &f : futures)
+    f.get ();
+
+  /* Task 2 was cancelled, but its future is still ready.  */
+  std::vector<int> expected = { 3, 4, 1 };
+  SELF_CHECK (order == expected);
+}
+
+/* Check that reducing the number of threads doesn't drop tasks that
+   were already posted.  */
+
+static void
+test_shrink ()
+{
+  save_restore_n_threads saver;
+  gdb::thread_pool *pool = gdb::thread_pool::g_thread_pool;
+
+  pool->set_thread_count (2);
+
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future ().share ();
+  std::atomic<int> count (0);
+  std::vector<gdb::future<void>> futures;
+  for (int i = 0; i < 10; ++i)
+    futures.push_back (pool->post_task ([&, released] ()
+      {
+	released.wait ();
+	++count;
+      }, gdb::task_priority::background));
+
+  pool->set_thread_count (1);
+  release.set_value ();
+  for (auto &f : futures)
+    f.get ();
+  SELF_CHECK (count == 10);
+}
+
+}
+}
+
+#endif /* CXX_STD_THREAD */
+
+void _initialize_thread_pool_selftests ();
+void
+_initialize_thread_pool_selftests ()
+{
+#if CXX_STD_THREAD
+  selftests::register_test
+    ("thread_pool", selftests::thread_pool::test_priorities_and_cancellation);
+  selftests::register_test ("thread_pool-shrink",
+			    selftests::thread_pool::test_shrink);
+#endif /* CXX_STD_THREAD */
+}
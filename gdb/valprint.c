@@ -1041,7 +1041,7 @@ common_val_print (struct value *value, struct ui_file *stream, int recurse,
        get a fixed representation of our value.  */
     value = ada_to_fixed_value (value);
 
-  if (value->lazy ())
+  if (value->lazy () && !val_print_array_in_chunks_p (value, language))
     value->fetch_lazy ();
 
   struct value_print_options local_opts = *options;
@@ -1130,22 +1130,28 @@ value_check_printable (struct value *val, struct ui_file *stream,
       return 0;
     }
 
-  if (val->entirely_optimized_out ())
+  /* Checking these would read all of a large array that is only to
+     be read as it is printed.  Any part of it that is unavailable is
+     shown while printing its elements instead.  */
+  if (!val_print_array_in_chunks_p (val, current_language))
     {
-      if (options->summary && !val_print_scalar_type_p (val->type ()))
-	gdb_printf (stream, "...");
-      else
-	val_print_optimized_out (val, stream);
-      return 0;
-    }
+      if (val->entirely_optimized_out ())
+	{
+	  if (options->summary && !val_print_scalar_type_p (val->type ()))
+	    gdb_printf (stream, "...");
+	  else
+	    val_print_optimized_out (val, stream);
+	  return 0;
+	}
 
-  if (val->entirely_unavailable ())
-    {
-      if (options->summary && !val_print_scalar_type_p (val->type ()))
-	gdb_printf (stream, "...");
-      else
-	val_print_unavailable (stream);
-      return 0;
+      if (val->entirely_unavailable ())
+	{
+	  if (options->summary && !val_print_scalar_type_p (val->type ()))
+	    gdb_printf (stream, "...");
+	  else
+	    val_print_unavailable (stream);
+	  return 0;
+	}
     }
 
   if (val->type ()->code () == TYPE_CODE_INTERNAL_FUNCTION)
@@ -1935,6 +1941,147 @@ maybe_print_array_index (struct type *index_type, LONGEST index,
   current_language->print_array_index (index_type, index, stream, options);
 }
 
+/* Arrays larger than this many bytes are read piecemeal while they
+   are printed, in chunks of at most this size.  The chunks are made
+   smaller if "max-value-size" is set lower than this.  */
+
+#define ARRAY_PRINT_CHUNK_SIZE 65536
+
+/* See valprint.h.  */
+
+bool
+val_print_array_in_chunks_p (struct value *val,
+			     const struct language_defn *language)
+{
+  if (!val->lazy ()
+      || val->lval () != lval_memory
+      || val->bitsize () != 0
+      || val->enclosing_type () != val->type ())
+    return false;
+
+  /* Only these languages print arrays through c_value_print_array and
+     value_print_array_elements, which know how to read them
+     piecemeal.  */
+  switch (language->la_language)
+    {
+    case language_c:
+    case language_cplus:
+    case language_objc:
+    case language_asm:
+    case language_minimal:
+      break;
+    default:
+      return false;
+    }
+
+  struct type *type = check_typedef (val->type ());
+  if (type->code () != TYPE_CODE_ARRAY
+      || type->length () <= ARRAY_PRINT_CHUNK_SIZE)
+    return false;
+
+  struct type *elttype = check_typedef (type->target_type ());
+  ULONGEST eltlen = elttype->length ();
+  if (eltlen == 0
+      || is_dynamic_type (elttype)
+      || (type->bit_stride () != 0
+	  && type->bit_stride () != 8 * eltlen))
+    return false;
+
+  LONGEST low_bound, high_bound;
+  return (get_array_bounds (type, &low_bound, &high_bound)
+	  && high_bound - low_bound < UINT_MAX);
+}
+
+/* Reads the elements of an array value for printing them.  An array
+   for which val_print_array_in_chunks_p holds is read a chunk at a
+   time, as its elements are reached; any other array is read all at
+   once.  */
+
+class array_element_reader
+{
+public:
+
+  array_element_reader (struct value *array, struct type *elttype,
+			unsigned int bit_stride, unsigned int len)
+    : m_array (array),
+      m_elttype (elttype),
+      m_bit_stride (bit_stride),
+      m_len (len),
+      m_chunked (val_print_array_in_chunks_p (array, current_language))
+  {
+    if (m_array->lazy () && !m_chunked)
+      m_array->fetch_lazy ();
+  }
+
+  DISABLE_COPY_AND_ASSIGN (array_element_reader);
+
+  /* Return element I of the array.  */
+
+  struct value *element (unsigned int i)
+  {
+    if (!m_chunked)
+      return m_array->from_component_bitsize (m_elttype, m_bit_stride * i,
+					      m_bit_stride);
+
+    if (m_chunk == nullptr || i < m_first || i >= m_first + m_count)
+      read_chunk (i);
+    return m_chunk->from_component_bitsize (m_elttype,
+					    m_bit_stride * (i - m_first),
+					    m_bit_stride);
+  }
+
+private:
+
+  /* Read the chunk of the array that starts at element FIRST.  */
+
+  void read_chunk (unsigned int first)
+  {
+    ULONGEST eltlen = m_bit_stride / 8;
+    unsigned int count
+      = std::min<ULONGEST> (m_len - first,
+			    std::max<ULONGEST> (1, (ARRAY_PRINT_CHUNK_SIZE
+						    / eltlen)));
+    while (count > 1 && exceeds_max_value_size (count * eltlen))
+      count /= 2;
+
+    /* Only the last chunk can be shorter than the others, so at most
+       two chunk types are created.  */
+    if (m_chunk_type == nullptr || m_chunk_type_count != count)
+      {
+	m_chunk_type = lookup_array_range_type (m_elttype, 0, count - 1);
+	m_chunk_type_count = count;
+      }
+
+    struct value *chunk = value_at (m_chunk_type,
+				    m_array->address () + first * eltlen);
+    m_chunk = release_value (chunk);
+    m_first = first;
+    m_count = count;
+  }
+
+  /* The array being printed.  */
+  struct value *m_array;
+
+  /* The type of its elements, the distance between them in bits, and
+     their number.  */
+  struct type *m_elttype;
+  unsigned int m_bit_stride;
+  unsigned int m_len;
+
+  /* Whether the array is read in chunks.  */
+  bool m_chunked;
+
+  /* The chunk most recently read, which holds M_COUNT elements of the
+     array starting at element M_FIRST.  */
+  value_ref_ptr m_chunk;
+  unsigned int m_first = 0;
+  unsigned int m_count = 0;
+
+  /* The array type of the chunks, with M_CHUNK_TYPE_COUNT elements.  */
+  struct type *m_chunk_type = nullptr;
+  unsigned int m_chunk_type_count = 0;
+};
+
 /* See valprint.h.  */
 
 void
@@ -1982,6 +2129,8 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
       len = 0;
     }
 
+  array_element_reader reader (val, elttype, bit_stride, len);
+
   annotate_array_section_begin (i, elttype);
 
   for (; i < len && things_printed < options->print_max; i++)
@@ -2007,9 +2156,7 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
       maybe_print_array_index (index_type, i + low_bound,
 			       stream, options);
 
-      struct value *element = val->from_component_bitsize (elttype,
-							   bit_stride * i,
-							   bit_stride);
+      struct value *element = reader.element (i);
       rep1 = i + 1;
       reps = 1;
       /* Only check for reps if repeat_count_threshold is not set to
@@ -2025,10 +2172,7 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
 		 clean up temporary values asap to prevent allocating a large
 		 amount of them.  */
 	      scoped_value_mark free_values_inner;
-	      struct value *rep_elt
-		= val->from_component_bitsize (elttype,
-					       rep1 * bit_stride,
-					       bit_stride);
+	      struct value *rep_elt = reader.element (rep1);
 	      bool repeated = ((available
 				&& rep_elt->entirely_available ()
 				&& element->contents_eq (rep_elt))
@@ -2631,6 +2775,42 @@ generic_printstr (struct ui_file *stream, struct type *type,
   gdb_puts ((const char *) obstack_base (&output), stream);
 }
 
+/* See valprint.h.  */
+
+bool
+generic_printstr_prefix_complete_p (struct type *type,
+				    const gdb_byte *string,
+				    unsigned int length,
+				    const char *encoding,
+				    const struct value_print_options *options)
+{
+  int width = type->length ();
+
+  /* This follows the conversion loop of generic_printstr.  The prefix
+     is long enough if that loop stops for having reached the maximum
+     number of characters, and the run of repeated characters it
+     stopped in was ended by a complete character within the prefix;
+     otherwise the run, or the last character, could go on past the
+     prefix.  */
+  wchar_iterator iter (string, length * width, encoding, width);
+  std::vector<converted_character> converted_chars;
+
+  unsigned int i = 0;
+  unsigned int print_max_chars = get_print_max_chars (options);
+  while (i < print_max_chars)
+    {
+      QUIT;
+
+      int r = count_next_character (&iter, &converted_chars);
+      if (r < 0)
+	return false;
+      i += r;
+    }
+
+  return (!converted_chars.empty ()
+	  && converted_chars.back ().result == wchar_iterate_ok);
+}
+
 /* Print a string from the inferior, starting at ADDR and printing up to LEN
    characters, of WIDTH bytes a piece, to STREAM.  If LEN is -1, printing
    stops at the first null byte, otherwise printing proceeds (including null
@@ -161,6 +161,14 @@ extern void maybe_print_array_index (struct type *index_type, LONGEST index,
 				     const struct value_print_options *);
 
 
+/* Return true if VAL, which is to be printed using LANGUAGE, is a
+   large array in memory that has not been read yet and that should be
+   read piecemeal while it is printed rather than all at once.  Only as
+   much of such an array as is needed for the output is then read.  */
+
+extern bool val_print_array_in_chunks_p (struct value *val,
+					 const struct language_defn *language);
+
 /* Print elements of an array.  */
 
 extern void value_print_array_elements (struct value *, struct ui_file *, int,
@@ -266,6 +274,15 @@ extern void generic_printstr (struct ui_file *stream, struct type *type,
 			      int quote_char, int c_style_terminator,
 			      const struct value_print_options *options);
 
+/* Return true if the LENGTH characters of type TYPE at STRING, which
+   are in ENCODING, are a prefix of a longer string that is long enough
+   for generic_printstr to print the same thing for it as for the whole
+   string, except for the trailing ellipses.  */
+
+extern bool generic_printstr_prefix_complete_p
+  (struct type *type, const gdb_byte *string, unsigned int length,
+   const char *encoding, const struct value_print_options *options);
+
 /* Run the "output" command.  ARGS and FROM_TTY are the usual
    arguments passed to all command implementations, except ARGS is
    const.  */
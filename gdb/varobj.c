@@ -31,6 +31,7 @@
 #include "varobj-iter.h"
 #include "parser-defs.h"
 #include "gdbarch.h"
+#include "tracepoint.h"
 #include <algorithm>
 #include "observable.h"
 
@@ -1434,6 +1435,264 @@ varobj_value_has_mutated (const struct varobj *var, struct value *new_value,
     return false;
 }
 
+/* Return true if the values of all the children of VAR are wholly
+   contained in the bytes of VAR's own value, so that if those bytes
+   did not change, neither did the children.  This is only known to
+   hold for plain C and C++ aggregates; pointers, references and
+   anything with a visualizer may reach memory outside the parent.  */
+
+static bool
+varobj_children_contained_p (const struct varobj *var)
+{
+  if (var->root->lang_ops != &c_varobj_ops
+      && var->root->lang_ops != &cplus_varobj_ops)
+    return false;
+
+  if (varobj_is_dynamic_p (var))
+    return false;
+
+  /* The children of a C++ fake child are fields of its parent.  */
+  if (CPLUS_FAKE_CHILD (var))
+    return true;
+
+  struct type *type = check_typedef (var->type);
+  switch (type->code ())
+    {
+    case TYPE_CODE_ARRAY:
+      return true;
+
+    case TYPE_CODE_STRUCT:
+    case TYPE_CODE_UNION:
+      /* Virtual base classes are located through the vtable, which is
+	 not part of the object.  */
+      for (int i = 0; i < TYPE_N_BASECLASSES (type); ++i)
+	if (BASETYPE_VIA_VIRTUAL (type, i))
+	  return false;
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+/* Return true if the value OLD_VALUE, installed in a varobj by the
+   previous update, and NEW_VALUE, its replacement, were read from the
+   same memory and have identical contents.  */
+
+static bool
+varobj_contents_unchanged_p (struct value *old_value,
+			     struct value *new_value)
+{
+  if (old_value == NULL || new_value == NULL || old_value == new_value)
+    return false;
+
+  if (old_value->lazy () || new_value->lazy ())
+    return false;
+
+  if (old_value->lval () != lval_memory || new_value->lval () != lval_memory)
+    return false;
+
+  if (old_value->address () != new_value->address ())
+    return false;
+
+  ULONGEST length = old_value->type ()->length ();
+  if (new_value->type ()->length () != length)
+    return false;
+
+  return old_value->contents_eq (0, new_value, 0, length);
+}
+
+/* Return true if the child varobj VAR, whose parent is known to be
+   unchanged since the previous update, can keep its current value
+   without being re-evaluated.  */
+
+static bool
+varobj_can_skip_update_p (const struct varobj *var)
+{
+  if (var->updated || var->not_fetched || var->value == nullptr)
+    return false;
+
+  if (varobj_is_dynamic_p (var))
+    return false;
+
+  /* A reference varobj holds the referenced object, which need not
+     live in the parent.  */
+  if (var->type == nullptr || TYPE_IS_REFERENCE (check_typedef (var->type)))
+    return false;
+
+  return true;
+}
+
+/* VAR has just been given a new value.  If VAR has children whose
+   values will be extracted from it, fetch the whole value now so that
+   a single target read serves all the children, and so that the next
+   update can compare contents and skip the subtree.  */
+
+static void
+varobj_fetch_for_children (struct varobj *var)
+{
+  if (var->children.empty () || var->not_fetched
+      || var->value == nullptr || !var->value->lazy ()
+      || !varobj_children_contained_p (var))
+    return;
+
+  try
+    {
+      var->value->fetch_lazy ();
+    }
+  catch (const gdb_exception_error &except)
+    {
+      /* The children will be read one by one, as before.  */
+    }
+}
+
+/* A copy of a range of inferior memory, taken by
+   scoped_varobj_prefetch.  */
+
+struct varobj_prefetch_block
+{
+  CORE_ADDR addr;
+  gdb::byte_vector bytes;
+};
+
+/* The blocks read by the live scoped_varobj_prefetch, sorted by
+   address, and the inferior they were read from.  */
+
+static std::vector<varobj_prefetch_block> varobj_prefetch_blocks;
+static inferior *varobj_prefetch_inferior;
+
+/* Root values further apart than this are read separately.  */
+
+static constexpr ULONGEST varobj_prefetch_max_gap = 64;
+
+/* Larger root values are not prefetched.  */
+
+static constexpr ULONGEST varobj_prefetch_max_length = 4096;
+
+static void
+varobj_prefetch_discard ()
+{
+  varobj_prefetch_blocks.clear ();
+  varobj_prefetch_inferior = nullptr;
+}
+
+/* See varobj.h.  */
+
+scoped_varobj_prefetch::scoped_varobj_prefetch ()
+{
+  varobj_prefetch_discard ();
+
+  if (!target_has_memory () || get_traceframe_number () != -1)
+    return;
+
+  inferior *inf = current_inferior ();
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> ranges;
+
+  for (const varobj_root *root : rootlist)
+    {
+      const varobj *var = root->rootvar;
+
+      if (!root->is_valid || var->frozen || var->value == nullptr)
+	continue;
+
+      /* Roots bound to a thread of another inferior are evaluated in
+	 a different address space.  */
+      if (root->valid_block != nullptr && root->thread_id != 0)
+	{
+	  thread_info *thr = find_thread_global_id (root->thread_id);
+
+	  if (thr == nullptr || thr->inf != inf)
+	    continue;
+	}
+
+      struct value *val = var->value.get ();
+      if (val->lval () != lval_memory || val->lazy ())
+	continue;
+
+      ULONGEST length = val->type ()->length ();
+      if (length == 0 || length > varobj_prefetch_max_length)
+	continue;
+
+      ranges.emplace_back (val->address (), val->address () + length);
+    }
+
+  if (ranges.empty ())
+    return;
+
+  std::sort (ranges.begin (), ranges.end ());
+
+  auto read_block = [] (CORE_ADDR start, CORE_ADDR end)
+    {
+      gdb::byte_vector bytes (end - start);
+
+      if (target_read_memory (start, bytes.data (), bytes.size ()) == 0)
+	varobj_prefetch_blocks.push_back ({ start, std::move (bytes) });
+    };
+
+  CORE_ADDR start = ranges[0].first;
+  CORE_ADDR end = ranges[0].second;
+  for (const auto &range : ranges)
+    {
+      if (range.first > end + varobj_prefetch_max_gap)
+	{
+	  read_block (start, end);
+	  start = range.first;
+	}
+      end = std::max (end, range.second);
+    }
+  read_block (start, end);
+
+  varobj_prefetch_inferior = inf;
+}
+
+/* See varobj.h.  */
+
+scoped_varobj_prefetch::~scoped_varobj_prefetch ()
+{
+  varobj_prefetch_discard ();
+}
+
+/* If VAL is a lazy value whose memory was read by the live
+   scoped_varobj_prefetch, fill its contents from that copy.  */
+
+static void
+varobj_fill_from_prefetch (struct value *val)
+{
+  if (varobj_prefetch_blocks.empty ()
+      || varobj_prefetch_inferior != current_inferior ()
+      || val == nullptr || !val->lazy () || val->lval () != lval_memory
+      || val->bitsize () != 0 || val->parent () != nullptr
+      || val->type () != val->enclosing_type ()
+      || val->embedded_offset () != 0)
+    return;
+
+  struct type *type = check_typedef (val->type ());
+  ULONGEST length = type->length ();
+  if (length == 0 || length > varobj_prefetch_max_length
+      || type_length_units (type) != length
+      || exceeds_max_value_size (length))
+    return;
+
+  CORE_ADDR addr = val->address ();
+  auto it = std::upper_bound (varobj_prefetch_blocks.begin (),
+			      varobj_prefetch_blocks.end (), addr,
+			      [] (CORE_ADDR a, const varobj_prefetch_block &b)
+			      {
+				return a < b.addr;
+			      });
+  if (it == varobj_prefetch_blocks.begin ())
+    return;
+  --it;
+
+  ULONGEST offset = addr - it->addr;
+  if (offset >= it->bytes.size () || it->bytes.size () - offset < length)
+    return;
+
+  memcpy (val->contents_all_raw ().data (), it->bytes.data () + offset,
+	  length);
+  val->set_lazy (false);
+}
+
 /* Update the values for a variable and its children.  This is a
    two-pronged attack.  First, re-parse the value for the root's
    expression to see if it's changed.  Then go all the way
@@ -1445,12 +1704,17 @@ varobj_value_has_mutated (const struct varobj *var, struct value *new_value,
    result of implicit -var-update *.  For implicit request, we don't
    update frozen variables.
 
+   A subtree is not re-evaluated if the memory backing its root was
+   read again and found to be identical to what the previous update
+   saw; see varobj_children_contained_p.
+
    NOTE: This function may delete the caller's varobj.  If it
    returns TYPE_CHANGED, then it has done this and VARP will be modified
    to point to the new varobj.  */
 
 std::vector<varobj_update_result>
-varobj_update (struct varobj **varp, bool is_explicit)
+varobj_update (struct varobj **varp, bool is_explicit,
+	       varobj_update_stats *stats)
 {
   bool type_changed = false;
   struct value *newobj;
@@ -1474,6 +1738,7 @@ varobj_update (struct varobj **varp, bool is_explicit)
   if ((*varp)->root->rootvar == *varp)
     {
       varobj_update_result r (*varp);
+      value_ref_ptr old_value = (*varp)->value;
 
       /* Update the root variable.  value_of_root can return NULL
 	 if the variable is no longer around, i.e. we stepped out of
@@ -1481,17 +1746,29 @@ varobj_update (struct varobj **varp, bool is_explicit)
 	 value_of_root variable dispose of the varobj if the type
 	 has changed.  */
       newobj = value_of_root (varp, &type_changed);
+      varobj_fill_from_prefetch (newobj);
       if (update_type_if_necessary (*varp, newobj))
 	  type_changed = true;
       r.varobj = *varp;
       r.type_changed = type_changed;
       if (install_new_value ((*varp), newobj, type_changed))
 	r.changed = true;
+      if (stats != nullptr)
+	stats->updated++;
       
       if (newobj == NULL)
 	r.status = VAROBJ_NOT_IN_SCOPE;
       r.value_installed = true;
 
+      if (r.status != VAROBJ_NOT_IN_SCOPE && !r.type_changed)
+	{
+	  varobj_fetch_for_children (*varp);
+	  r.parent_unchanged
+	    = (varobj_children_contained_p (*varp)
+	       && varobj_contents_unchanged_p (old_value.get (),
+					       (*varp)->value.get ()));
+	}
+
       if (r.status == VAROBJ_NOT_IN_SCOPE)
 	{
 	  if (r.type_changed || r.changed)
@@ -1512,11 +1789,40 @@ varobj_update (struct varobj **varp, bool is_explicit)
       stack.pop_back ();
       struct varobj *v = r.varobj;
 
+      /* If the parent's contents did not change, neither did this
+	 child's, and it need not be evaluated again.  Its own
+	 children can be skipped too if they are contained in it.  A C++
+	 fake child has no value of its own, so just pass the
+	 information down.  */
+      if (!r.value_installed && r.parent_unchanged
+	  && (CPLUS_FAKE_CHILD (v) || varobj_can_skip_update_p (v)))
+	{
+	  bool contained = varobj_children_contained_p (v);
+
+	  if (stats != nullptr)
+	    stats->skipped++;
+
+	  for (int i = v->children.size () - 1; i >= 0; --i)
+	    {
+	      varobj *c = v->children[i];
+
+	      if (c != NULL && !c->frozen)
+		{
+		  varobj_update_result item (c);
+
+		  item.parent_unchanged = contained;
+		  stack.push_back (std::move (item));
+		}
+	    }
+	  continue;
+	}
+
       /* Update this variable, unless it's a root, which is already
 	 updated.  */
       if (!r.value_installed)
 	{
 	  struct type *new_type;
+	  value_ref_ptr old_value = v->value;
 
 	  newobj = value_of_child (v->parent, v->index);
 	  if (update_type_if_necessary (v, newobj))
@@ -1543,6 +1849,18 @@ varobj_update (struct varobj **varp, bool is_explicit)
 	      r.changed = true;
 	      v->updated = false;
 	    }
+	  if (stats != nullptr)
+	    stats->updated++;
+
+	  r.parent_unchanged = false;
+	  if (!r.type_changed)
+	    {
+	      varobj_fetch_for_children (v);
+	      r.parent_unchanged
+		= (varobj_children_contained_p (v)
+		   && varobj_contents_unchanged_p (old_value.get (),
+						   v->value.get ()));
+	    }
 	}
 
       /* We probably should not get children of a dynamic varobj, but
@@ -1643,7 +1961,12 @@ varobj_update (struct varobj **varp, bool is_explicit)
 
 	  /* Child may be NULL if explicitly deleted by -var-delete.  */
 	  if (c != NULL && !c->frozen)
-	    stack.emplace_back (c);
+	    {
+	      varobj_update_result item (c);
+
+	      item.parent_unchanged = r.parent_unchanged;
+	      stack.push_back (std::move (item));
+	    }
 	}
 
       if (r.changed || r.type_changed)
@@ -2445,4 +2768,13 @@ _initialize_varobj ()
 
   gdb::observers::free_objfile.attach (varobj_invalidate_if_uses_objfile,
 				       "varobj");
+  gdb::observers::target_resumed.attach ([] (ptid_t)
+    {
+      varobj_prefetch_discard ();
+    }, "varobj");
+  gdb::observers::memory_changed.attach ([] (inferior *, CORE_ADDR, ssize_t,
+					     const bfd_byte *)
+    {
+      varobj_prefetch_discard ();
+    }, "varobj");
 }
@@ -78,6 +78,13 @@ struct varobj_update_result
      be yet installed.  Don't use this outside varobj.c.  */
   bool value_installed = false;
 
+  /* This variable is used internally by varobj_update to indicate that
+     the contents of the parent varobj are byte-for-byte identical to
+     those seen by the previous update, so that a child whose value is
+     wholly contained in the parent need not be re-evaluated.  Don't use
+     this outside varobj.c.  */
+  bool parent_unchanged = false;
+
   /* This will be non-NULL when new children were added to the varobj.
      It lists the new children (which must necessarily come at the end
      of the child list) added during an update.  The caller is
@@ -311,8 +318,41 @@ extern bool varobj_set_value (struct varobj *var, const char *expression);
 
 extern void all_root_varobjs (gdb::function_view<void (struct varobj *var)>);
 
+/* Counters describing the work done by a single call to
+   varobj_update.  */
+
+struct varobj_update_stats
+{
+  /* Number of varobjs whose value was re-evaluated.  */
+  int updated = 0;
+
+  /* Number of varobjs that were not re-evaluated because the memory
+     backing them was found to be unchanged.  */
+  int skipped = 0;
+};
+
+/* Update VARP and its children.  If STATS is not NULL, the counters
+   in it are incremented to describe the work that was done.  */
+
 extern std::vector<varobj_update_result>
-  varobj_update (struct varobj **varp, bool is_explicit);
+  varobj_update (struct varobj **varp, bool is_explicit,
+		 varobj_update_stats *stats = nullptr);
+
+/* While an object of this type is alive, the memory that backed the
+   values of the root varobjs at the previous update is held in a
+   copy read up front with as few target requests as possible, and
+   root values that lie within it are filled from that copy rather
+   than read one at a time.  The copy is dropped as soon as the
+   inferior resumes or its memory is written.  */
+
+class scoped_varobj_prefetch
+{
+public:
+  scoped_varobj_prefetch ();
+  ~scoped_varobj_prefetch ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_varobj_prefetch);
+};
 
 /* Try to recreate any global or floating varobj.  This is called after
    changing symbol files.  */
@@ -21,6 +21,8 @@
 #define GDBSUPPORT_PARALLEL_FOR_H
 
 #include <algorithm>
+#include <chrono>
+#include <memory>
 #include <type_traits>
 #include "gdbsupport/invoke-result.h"
 #include "gdbsupport/thread-pool.h"
@@ -29,9 +31,104 @@
 namespace gdb
 {
 
+/* If true, parallel_for_each prints how the work is distributed
+   across the threads, and how long each thread took.  This is set by
+   "set debug parallel-for".  */
+extern bool parallel_for_each_debug;
+
 namespace detail
 {
 
+/* The times taken by the tasks of a parallel_for_each, kept when
+   parallel_for_each_debug is set.  This is shared with the tasks, so
+   that a task still running after parallel_for_each exits with an
+   exception does not write to freed memory.  */
+
+struct par_for_timings
+{
+  explicit par_for_timings (size_t n_workers)
+    : durations (n_workers + 1),
+      n_workers (n_workers)
+  {
+  }
+
+  /* The time taken by each task.  The main thread's time is stored
+     last.  */
+  std::vector<std::chrono::steady_clock::duration> durations;
+
+  /* The number of tasks actually posted to worker threads.  This is
+     only used by the main thread.  */
+  size_t n_workers;
+};
+
+/* Record how long task TASK of parallel_for_each took, from the
+   construction of this object to its destruction.  */
+
+class par_for_task_timer
+{
+public:
+
+  par_for_task_timer (const std::shared_ptr<par_for_timings> &timings,
+		      size_t task)
+    : m_timings (timings),
+      m_task (task),
+      m_start (std::chrono::steady_clock::now ())
+  {
+  }
+
+  ~par_for_task_timer ()
+  {
+    if (m_timings != nullptr)
+      m_timings->durations[m_task]
+	= std::chrono::steady_clock::now () - m_start;
+  }
+
+  DISABLE_COPY_AND_ASSIGN (par_for_task_timer);
+
+private:
+
+  const std::shared_ptr<par_for_timings> &m_timings;
+  size_t m_task;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+/* Print the times in TIMINGS, if any, when destroyed.  This must be
+   destroyed on the main thread, after all the tasks have finished.  */
+
+class par_for_timings_printer
+{
+public:
+
+  explicit par_for_timings_printer
+    (const std::shared_ptr<par_for_timings> &timings)
+    : m_timings (timings)
+  {
+  }
+
+  ~par_for_timings_printer ()
+  {
+    if (m_timings == nullptr)
+      return;
+
+    using std::chrono::microseconds;
+    using std::chrono::duration_cast;
+
+    for (size_t i = 0; i < m_timings->n_workers; ++i)
+      debug_printf (_("Parallel for: time on worker thread %zu\t: %lld us\n"),
+		    i, (long long) duration_cast<microseconds>
+			 (m_timings->durations[i]).count ());
+    debug_printf (_("Parallel for: time on main thread\t\t: %lld us\n"),
+		  (long long) duration_cast<microseconds>
+		    (m_timings->durations.back ()).count ());
+  }
+
+  DISABLE_COPY_AND_ASSIGN (par_for_timings_printer);
+
+private:
+
+  const std::shared_ptr<par_for_timings> &m_timings;
+};
+
 /* This is a helper class that is used to accumulate results for
    parallel_for.  There is a specialization for 'void', below.  */
 template<typename T>
@@ -141,7 +238,10 @@ struct par_for_accumulator<void>
 
    If the function returns a non-void type, then a vector of the
    results is returned.  The size of the resulting vector depends on
-   the number of threads that were used.  */
+   the number of threads that were used.
+
+   The tasks are posted to the thread pool with foreground priority,
+   so they are run before any pending background work.  */
 
 template<class RandomIt, class RangeFunction>
 typename gdb::detail::par_for_accumulator<
@@ -154,10 +254,6 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
   using result_type
     = typename gdb::invoke_result<RangeFunction, RandomIt, RandomIt>::type;
 
-  /* If enabled, print debug info about how the work is distributed across
-     the threads.  */
-  const bool parallel_for_each_debug = false;
-
   size_t n_worker_threads = thread_pool::g_thread_pool->thread_count ();
   size_t n_threads = n_worker_threads;
   size_t n_elements = last - first;
@@ -201,6 +297,15 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
     }
 
   size_t count = n_threads == 0 ? 0 : n_threads - 1;
+
+  /* When debugging, the time taken by each task, the last one being
+     the main thread's.  These are printed when this function
+     returns, after all the tasks are done.  */
+  std::shared_ptr<gdb::detail::par_for_timings> timings;
+  if (parallel_for_each_debug)
+    timings = std::make_shared<gdb::detail::par_for_timings> (count);
+  gdb::detail::par_for_timings_printer timings_printer (timings);
+
   gdb::detail::par_for_accumulator<result_type> results (count);
 
   if (parallel_for_each_debug)
@@ -259,6 +364,8 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
 	     to the thread pool.  */
 	  count = i;
 	  results.resize (count);
+	  if (timings != nullptr)
+	    timings->n_workers = count;
 	  break;
 	}
 
@@ -271,7 +378,10 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
 	  debug_printf (_("\n"));
 	}
       results.post (i, [=] ()
-	{ return callback (first, end); });
+	{
+	  gdb::detail::par_for_task_timer timer (timings, i);
+	  return callback (first, end);
+	});
       first = end;
     }
 
@@ -295,6 +405,8 @@ parallel_for_each (unsigned n, RandomIt first, RandomIt last,
     }
   return results.finish ([=] ()
     {
+      gdb::detail::par_for_task_timer
+	timer (timings, timings == nullptr ? 0 : timings->durations.size () - 1);
       return callback (first, last);
     });
 }
@@ -33,42 +33,54 @@ simple_search_memory
    const gdb_byte *pattern, ULONGEST pattern_len,
    CORE_ADDR *found_addrp)
 {
-  const unsigned chunk_size = SEARCH_CHUNK_SIZE;
+  /* The number of bytes at which to look for the pattern in the next
+     iteration.  */
+  ULONGEST chunk_size = SEARCH_CHUNK_SIZE;
+  /* Whether CHUNK_SIZE may still grow.  It stops growing once a read
+     has failed.  */
+  bool grow = true;
   /* Buffer to hold memory contents for searching.  */
-  unsigned search_buf_size;
-
-  search_buf_size = chunk_size + pattern_len - 1;
-
-  /* No point in trying to allocate a buffer larger than the search space.  */
-  if (search_space_len < search_buf_size)
-    search_buf_size = search_space_len;
-
-  gdb::byte_vector search_buf (search_buf_size);
-
-  /* Prime the search buffer.  */
-
-  if (!read_memory (start_addr, search_buf.data (), search_buf_size))
-    {
-      warning (_("Unable to access %s bytes of target "
-		 "memory at %s, halting search."),
-	       pulongest (search_buf_size), hex_string (start_addr));
-      return -1;
-    }
+  gdb::byte_vector search_buf;
+  /* The number of bytes at the start of SEARCH_BUF that were kept from
+     the previous iteration.  */
+  ULONGEST keep_len = 0;
 
   /* Perform the search.
 
-     The loop is kept simple by allocating [N + pattern-length - 1] bytes.
-     When we've scanned N bytes we copy the trailing bytes to the start and
-     read in another N bytes.  */
+     Each iteration reads [N + pattern-length - 1] bytes, minus the
+     bytes kept from the previous iteration, and looks for the pattern
+     at N addresses.  The trailing pattern-length - 1 bytes are then
+     copied to the start of the buffer for the next iteration.  */
 
   while (search_space_len >= pattern_len)
     {
-      gdb_byte *found_ptr;
-      unsigned nr_search_bytes
-	= std::min (search_space_len, (ULONGEST) search_buf_size);
+      ULONGEST search_buf_size
+	= std::min (search_space_len, chunk_size + pattern_len - 1);
+      CORE_ADDR read_addr = start_addr + keep_len;
+      ULONGEST nr_to_read = search_buf_size - keep_len;
+
+      search_buf.resize (search_buf_size);
+      if (!read_memory (read_addr, &search_buf[keep_len], nr_to_read))
+	{
+	  /* A large read may span memory that can't be read although a
+	     match precedes it.  Go on with smaller reads, so that such
+	     a match is still found.  */
+	  if (chunk_size > SEARCH_CHUNK_SIZE)
+	    {
+	      chunk_size = SEARCH_CHUNK_SIZE;
+	      grow = false;
+	      continue;
+	    }
+
+	  warning (_("Unable to access %s bytes of target "
+		     "memory at %s, halting search."),
+		   pulongest (nr_to_read), hex_string (read_addr));
+	  return -1;
+	}
 
-      found_ptr = (gdb_byte *) memmem (search_buf.data (), nr_search_bytes,
-				       pattern, pattern_len);
+      gdb_byte *found_ptr
+	= (gdb_byte *) memmem (search_buf.data (), search_buf_size,
+			       pattern, pattern_len);
 
       if (found_ptr != NULL)
 	{
@@ -80,38 +92,19 @@ simple_search_memory
 
       /* Not found in this chunk, skip to next chunk.  */
 
-      /* Don't let search_space_len wrap here, it's unsigned.  */
-      if (search_space_len >= chunk_size)
-	search_space_len -= chunk_size;
-      else
-	search_space_len = 0;
-
-      if (search_space_len >= pattern_len)
-	{
-	  unsigned keep_len = search_buf_size - chunk_size;
-	  CORE_ADDR read_addr = start_addr + chunk_size + keep_len;
-	  int nr_to_read;
-
-	  /* Copy the trailing part of the previous iteration to the front
-	     of the buffer for the next iteration.  */
-	  gdb_assert (keep_len == pattern_len - 1);
-	  if (keep_len > 0)
-	    memcpy (&search_buf[0], &search_buf[chunk_size], keep_len);
+      ULONGEST searched = search_buf_size - (pattern_len - 1);
+      search_space_len -= searched;
+      start_addr += searched;
 
-	  nr_to_read = std::min (search_space_len - keep_len,
-				 (ULONGEST) chunk_size);
+      /* Copy the trailing part of this iteration to the front of the
+	 buffer for the next iteration.  */
+      keep_len = pattern_len - 1;
+      if (search_space_len >= pattern_len && keep_len > 0)
+	memmove (&search_buf[0], &search_buf[searched], keep_len);
 
-	  if (!read_memory (read_addr, &search_buf[keep_len], nr_to_read))
-	    {
-	      warning (_("Unable to access %s bytes of target "
-			 "memory at %s, halting search."),
-		       plongest (nr_to_read),
-		       hex_string (read_addr));
-	      return -1;
-	    }
-
-	  start_addr += chunk_size;
-	}
+      if (grow)
+	chunk_size = std::min (chunk_size * 2,
+			       (ULONGEST) SEARCH_MAX_CHUNK_SIZE);
     }
 
   /* Not found.  */
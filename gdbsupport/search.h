@@ -20,8 +20,13 @@
 
 #include "gdbsupport/function-view.h"
 
-/* This is needed by the unit test, so appears here.  */
+/* These are needed by the unit test, so appear here.  The search
+   starts by reading SEARCH_CHUNK_SIZE bytes, and doubles the size of
+   each further read up to SEARCH_MAX_CHUNK_SIZE, so that a match near
+   the start is found quickly while large ranges are read in large
+   blocks.  */
 #define SEARCH_CHUNK_SIZE 16000
+#define SEARCH_MAX_CHUNK_SIZE (1024 * 1024)
 
 /* The type of a callback function that can be used to read memory.
    Note that target_read_memory is not used here, because gdbserver
@@ -19,6 +19,7 @@
 
 #include "common-defs.h"
 #include "gdbsupport/thread-pool.h"
+#include "gdbsupport/parallel-for.h"
 
 #if CXX_STD_THREAD
 
@@ -130,6 +131,9 @@ set_thread_name (const char *name)
 namespace gdb
 {
 
+/* See parallel-for.h.  */
+bool parallel_for_each_debug = false;
+
 /* The thread pool detach()s its threads, so that the threads will not
    prevent the process from exiting.  However, it was discovered that
    if any detached threads were still waiting on a condition variable,
@@ -181,8 +185,7 @@ thread_pool::set_thread_count (size_t num_threads)
   /* If the new size is smaller, terminate some existing threads.  */
   if (num_threads < m_thread_count)
     {
-      for (size_t i = num_threads; i < m_thread_count; ++i)
-	m_tasks.emplace ();
+      m_pending_exits += m_thread_count - num_threads;
       m_tasks_cv.notify_all ();
     }
 
@@ -192,17 +195,43 @@ thread_pool::set_thread_count (size_t num_threads)
 #endif /* CXX_STD_THREAD */
 }
 
+size_t
+thread_pool::queued_tasks ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_tasks_mutex);
+  size_t result = 0;
+  for (const auto &queue : m_tasks)
+    result += queue.size ();
+  return result;
+#else
+  return 0;
+#endif /* CXX_STD_THREAD */
+}
+
+size_t
+thread_pool::exiting_threads ()
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_tasks_mutex);
+  return m_pending_exits;
+#else
+  return 0;
+#endif /* CXX_STD_THREAD */
+}
+
 #if CXX_STD_THREAD
 
 void
-thread_pool::do_post_task (std::packaged_task<void ()> &&func)
+thread_pool::do_post_task (std::packaged_task<void ()> &&func,
+			   task_priority priority)
 {
   std::packaged_task<void ()> t (std::move (func));
 
   if (m_thread_count != 0)
     {
       std::lock_guard<std::mutex> guard (m_tasks_mutex);
-      m_tasks.emplace (std::move (t));
+      m_tasks[(int) priority].emplace (std::move (t));
       m_tasks_cv.notify_one ();
     }
   else
@@ -225,21 +254,41 @@ thread_pool::thread_function ()
 
   while (true)
     {
-      optional<task_t> t;
+      task_t t;
 
       {
 	/* We want to hold the lock while examining the task list, but
 	   not while invoking the task function.  */
 	std::unique_lock<std::mutex> guard (m_tasks_mutex);
-	while (m_tasks.empty ())
-	  m_tasks_cv.wait (guard);
-	t = std::move (m_tasks.front());
-	m_tasks.pop ();
+	std::queue<task_t> *queue = nullptr;
+	while (true)
+	  {
+	    /* Take a task from the highest priority queue that has
+	       one.  */
+	    for (std::queue<task_t> &q : m_tasks)
+	      if (!q.empty ())
+		{
+		  queue = &q;
+		  break;
+		}
+	    if (queue != nullptr || m_pending_exits > 0)
+	      break;
+	    m_tasks_cv.wait (guard);
+	  }
+
+	if (queue == nullptr)
+	  {
+	    /* There is nothing left to do, and this thread was asked to
+	       exit.  */
+	    --m_pending_exits;
+	    break;
+	  }
+
+	t = std::move (queue->front ());
+	queue->pop ();
       }
 
-      if (!t.has_value ())
-	break;
-      (*t) ();
+      t ();
     }
 }
 
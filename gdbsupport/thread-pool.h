@@ -24,6 +24,8 @@
 #include <vector>
 #include <functional>
 #include <chrono>
+#include <atomic>
+#include <memory>
 #if CXX_STD_THREAD
 #include <thread>
 #include <mutex>
@@ -117,6 +119,53 @@ class future<void>
 
 #endif /* CXX_STD_THREAD */
 
+/* The priority of a task posted to the thread pool.  Worker threads
+   always pick the oldest task of the highest priority that is
+   pending.  */
+
+enum class task_priority
+{
+  /* Work that the user is waiting for, such as the tasks of a
+     parallel_for_each.  */
+  foreground,
+
+  /* Work that nothing needs yet, such as finalizing the DWARF index of
+     an objfile, or writing it to the index cache.  */
+  background,
+};
+
+/* A token used to cancel tasks cooperatively.  Copies of a token share
+   its state, so a task can be handed a copy, and the owner of the
+   work can then cancel it.  A task posted with a token is skipped if
+   the token was cancelled before the task started; once a task is
+   running, it is up to the task to check the token.  */
+
+class cancellation_token
+{
+public:
+
+  cancellation_token ()
+    : m_cancelled (std::make_shared<std::atomic<bool>> (false))
+  {
+  }
+
+  /* Request cancellation.  This may be called from any thread.  */
+  void cancel ()
+  {
+    *m_cancelled = true;
+  }
+
+  /* Return true if cancellation was requested.  */
+  bool cancelled () const
+  {
+    return *m_cancelled;
+  }
+
+private:
+
+  std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
 
 /* A thread pool.
 
@@ -146,14 +195,23 @@ class thread_pool
 #endif
   }
 
-  /* Post a task to the thread pool.  A future is returned, which can
-     be used to wait for the result.  */
-  future<void> post_task (std::function<void ()> &&func)
+  /* Return the number of tasks that have been posted but that no
+     worker thread has started yet.  */
+  size_t queued_tasks ();
+
+  /* Return the number of worker threads that were asked to exit by
+     reducing the thread count, but haven't yet.  */
+  size_t exiting_threads ();
+
+  /* Post a task to the thread pool, with priority PRIORITY.  A future
+     is returned, which can be used to wait for the result.  */
+  future<void> post_task (std::function<void ()> &&func,
+			  task_priority priority = task_priority::foreground)
   {
 #if CXX_STD_THREAD
     std::packaged_task<void ()> task (std::move (func));
     future<void> result = task.get_future ();
-    do_post_task (std::packaged_task<void ()> (std::move (task)));
+    do_post_task (std::packaged_task<void ()> (std::move (task)), priority);
     return result;
 #else
     func ();
@@ -161,15 +219,30 @@ class thread_pool
 #endif /* CXX_STD_THREAD */
   }
 
-  /* Post a task to the thread pool.  A future is returned, which can
-     be used to wait for the result.  */
+  /* Like the above, but FUNC is not called if TOKEN has been cancelled
+     by the time the task starts.  The future becomes ready either
+     way.  */
+  future<void> post_task (std::function<void ()> &&func,
+			  task_priority priority,
+			  const cancellation_token &token)
+  {
+    return post_task ([func, token] ()
+      {
+	if (!token.cancelled ())
+	  func ();
+      }, priority);
+  }
+
+  /* Post a task to the thread pool, with priority PRIORITY.  A future
+     is returned, which can be used to wait for the result.  */
   template<typename T>
-  future<T> post_task (std::function<T ()> &&func)
+  future<T> post_task (std::function<T ()> &&func,
+		       task_priority priority = task_priority::foreground)
   {
 #if CXX_STD_THREAD
     std::packaged_task<T ()> task (std::move (func));
     future<T> result = task.get_future ();
-    do_post_task (std::packaged_task<void ()> (std::move (task)));
+    do_post_task (std::packaged_task<void ()> (std::move (task)), priority);
     return result;
 #else
     return future<T> (func ());
@@ -184,21 +257,25 @@ class thread_pool
   /* The callback for each worker thread.  */
   void thread_function ();
 
-  /* Post a task to the thread pool.  A future is returned, which can
-     be used to wait for the result.  */
-  void do_post_task (std::packaged_task<void ()> &&func);
+  /* Post a task to the thread pool, with priority PRIORITY.  */
+  void do_post_task (std::packaged_task<void ()> &&func,
+		     task_priority priority);
 
   /* The current thread count.  */
   size_t m_thread_count = 0;
 
+  /* The number of worker threads that have been asked to exit, but
+     haven't yet.  A worker thread only exits when there are no tasks
+     left, so that tasks posted before the thread count was reduced
+     are still run.  */
+  size_t m_pending_exits = 0;
+
   /* A convenience typedef for the type of a task.  */
   typedef std::packaged_task<void ()> task_t;
 
-  /* The tasks that have not been processed yet.  An optional is used
-     to represent a task.  If the optional is empty, then this means
-     that the receiving thread should terminate.  If the optional is
-     non-empty, then it is an actual task to evaluate.  */
-  std::queue<optional<task_t>> m_tasks;
+  /* The tasks that have not been processed yet, one queue for each
+     priority, indexed by task_priority.  */
+  std::queue<task_t> m_tasks[2];
 
   /* A condition variable and mutex that are used for communication
      between the main thread and the worker threads.  */